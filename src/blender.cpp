@@ -0,0 +1,463 @@
+//
+// Created by admin on 2026/2/3.
+//
+
+#include "blender.h"
+#include <algorithm>
+#include <cstring>
+
+#if COLOR_LITTLE_ENDIAN && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define BLENDER_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define BLENDER_USE_SSE2 0
+#endif
+
+namespace
+{
+
+// 逐通道饱和加法
+uint32_t AddSaturate(uint32_t a, uint32_t b)
+{
+    uint32_t rb = (a & 0x00FF00FFu) + (b & 0x00FF00FFu);
+    rb |= 0x01000100u - ((rb >> 8) & 0x00010001u);
+    uint32_t ag = ((a >> 8) & 0x00FF00FFu) + ((b >> 8) & 0x00FF00FFu);
+    ag |= 0x01000100u - ((ag >> 8) & 0x00010001u);
+    return (rb & 0x00FF00FFu) | ((ag & 0x00FF00FFu) << 8);
+}
+
+// 逐通道相乘：a * b / 255
+uint32_t MulChannels(uint32_t a, uint32_t b)
+{
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        uint32_t t = ((a >> shift) & 0xFFu) * ((b >> shift) & 0xFFu) + 128;
+        result |= (((t + (t >> 8)) >> 8) & 0xFFu) << shift;
+    }
+    return result;
+}
+
+template <BlendMode M> uint32_t BlendOne(uint32_t d, uint32_t s)
+{
+    if constexpr (M == BlendMode::Replace)
+    {
+        return s;
+    }
+    else if constexpr (M == BlendMode::SrcOver)
+    {
+        // 预乘空间下每个通道只需一次乘加
+        return s + Blender::ScalePixel(d, 255 - Blender::AlphaOf(s));
+    }
+    else if constexpr (M == BlendMode::Additive)
+    {
+        return AddSaturate(s, d);
+    }
+    else if constexpr (M == BlendMode::Multiply)
+    {
+        uint32_t outside = AddSaturate(Blender::ScalePixel(s, 255 - Blender::AlphaOf(d)),
+                                       Blender::ScalePixel(d, 255 - Blender::AlphaOf(s)));
+        return AddSaturate(MulChannels(s, d), outside);
+    }
+    else
+    {
+        // Screen: s + d - s * d，按 16 位通道分开计算避免借位
+        uint32_t m = MulChannels(s, d);
+        uint32_t rb = (s & 0x00FF00FFu) + (d & 0x00FF00FFu) - (m & 0x00FF00FFu);
+        uint32_t ag = ((s >> 8) & 0x00FF00FFu) + ((d >> 8) & 0x00FF00FFu) - ((m >> 8) & 0x00FF00FFu);
+        return (rb & 0x00FF00FFu) | ((ag & 0x00FF00FFu) << 8);
+    }
+}
+
+#if BLENDER_USE_SSE2
+
+// 16 位通道上的 x / 255（四舍五入），x <= 255 * 255
+inline __m128i Div255(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// 将每个像素的 alpha（小端下位于第 0 个 16 位通道）广播到该像素的 4 个通道
+inline __m128i BroadcastAlpha(__m128i x)
+{
+    x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(0, 0, 0, 0));
+    return _mm_shufflehi_epi16(x, _MM_SHUFFLE(0, 0, 0, 0));
+}
+
+// 对 2 个像素（8 个 16 位通道）做混合
+template <BlendMode M> inline __m128i Blend2x16(__m128i d, __m128i s)
+{
+    const __m128i v255 = _mm_set1_epi16(255);
+    if constexpr (M == BlendMode::SrcOver)
+    {
+        __m128i inv_sa = _mm_sub_epi16(v255, BroadcastAlpha(s));
+        return _mm_add_epi16(s, Div255(_mm_mullo_epi16(d, inv_sa)));
+    }
+    else if constexpr (M == BlendMode::Multiply)
+    {
+        __m128i inv_sa = _mm_sub_epi16(v255, BroadcastAlpha(s));
+        __m128i inv_da = _mm_sub_epi16(v255, BroadcastAlpha(d));
+        __m128i sd = Div255(_mm_mullo_epi16(s, d));
+        __m128i s_out = Div255(_mm_mullo_epi16(s, inv_da));
+        __m128i d_out = Div255(_mm_mullo_epi16(d, inv_sa));
+        return _mm_add_epi16(sd, _mm_add_epi16(s_out, d_out));
+    }
+    else
+    {
+        // Screen
+        return _mm_sub_epi16(_mm_add_epi16(s, d), Div255(_mm_mullo_epi16(s, d)));
+    }
+}
+
+// 对 4 个像素做混合
+template <BlendMode M> inline __m128i Blend4(__m128i d, __m128i s)
+{
+    if constexpr (M == BlendMode::Replace)
+    {
+        return s;
+    }
+    else if constexpr (M == BlendMode::Additive)
+    {
+        return _mm_adds_epu8(s, d);
+    }
+    else
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i lo = Blend2x16<M>(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero));
+        __m128i hi = Blend2x16<M>(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero));
+        return _mm_packus_epi16(lo, hi);
+    }
+}
+
+#endif // BLENDER_USE_SSE2
+
+template <BlendMode M> void BlendSpanImpl(uint32_t* dst, const uint32_t* src, int count)
+{
+    int i = 0;
+#if BLENDER_USE_SSE2
+    const __m128i alpha_mask = _mm_set1_epi32(0xFF);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if constexpr (M == BlendMode::SrcOver)
+        {
+            // 4 个源像素都不透明时直接写入，都全透明时跳过
+            __m128i sa = _mm_and_si128(s, alpha_mask);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, alpha_mask)) == 0xFFFF)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), s);
+                continue;
+            }
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, _mm_setzero_si128())) == 0xFFFF)
+            {
+                continue;
+            }
+        }
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), Blend4<M>(d, s));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = BlendOne<M>(dst[i], src[i]);
+    }
+}
+
+template <BlendMode M> void BlendSolidSpanImpl(uint32_t* dst, uint32_t src, int count)
+{
+    int i = 0;
+#if BLENDER_USE_SSE2
+    const __m128i s = _mm_set1_epi32(static_cast<int>(src));
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), Blend4<M>(d, s));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = BlendOne<M>(dst[i], src);
+    }
+}
+
+template <BlendMode M> void BlendSolidStridedImpl(uint32_t* dst, int stride, uint32_t src, int count)
+{
+    for (int i = 0; i < count; ++i, dst += stride)
+    {
+        *dst = BlendOne<M>(*dst, src);
+    }
+}
+
+} // namespace
+
+uint32_t Blender::BlendPixel(uint32_t dst, uint32_t src, BlendMode mode)
+{
+    switch (mode)
+    {
+    case BlendMode::Replace:
+        return BlendOne<BlendMode::Replace>(dst, src);
+    case BlendMode::SrcOver:
+        return BlendOne<BlendMode::SrcOver>(dst, src);
+    case BlendMode::Additive:
+        return BlendOne<BlendMode::Additive>(dst, src);
+    case BlendMode::Multiply:
+        return BlendOne<BlendMode::Multiply>(dst, src);
+    case BlendMode::Screen:
+        return BlendOne<BlendMode::Screen>(dst, src);
+    }
+    return src;
+}
+
+uint32_t Blender::BlendPixel(uint32_t dst, uint32_t src, uint8_t coverage, BlendMode mode)
+{
+    if (coverage == 0)
+    {
+        return dst;
+    }
+    if (coverage == 255)
+    {
+        return BlendPixel(dst, src, mode);
+    }
+    if (mode == BlendMode::Replace)
+    {
+        return AddSaturate(ScalePixel(src, coverage), ScalePixel(dst, 255 - coverage));
+    }
+    return BlendPixel(dst, ScalePixel(src, coverage), mode);
+}
+
+void Blender::BlendSpan(uint32_t* dst, const uint32_t* src, int count, BlendMode mode)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    switch (mode)
+    {
+    case BlendMode::Replace:
+        std::memcpy(dst, src, static_cast<size_t>(count) * sizeof(uint32_t));
+        break;
+    case BlendMode::SrcOver:
+        BlendSpanImpl<BlendMode::SrcOver>(dst, src, count);
+        break;
+    case BlendMode::Additive:
+        BlendSpanImpl<BlendMode::Additive>(dst, src, count);
+        break;
+    case BlendMode::Multiply:
+        BlendSpanImpl<BlendMode::Multiply>(dst, src, count);
+        break;
+    case BlendMode::Screen:
+        BlendSpanImpl<BlendMode::Screen>(dst, src, count);
+        break;
+    }
+}
+
+void Blender::BlendSolidSpan(uint32_t* dst, uint32_t src, int count, BlendMode mode)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    if (mode == BlendMode::SrcOver)
+    {
+        // 不透明源退化为填充，全透明源什么都不做
+        const uint32_t a = AlphaOf(src);
+        if (a == 255)
+        {
+            mode = BlendMode::Replace;
+        }
+        else if (a == 0)
+        {
+            return;
+        }
+    }
+    switch (mode)
+    {
+    case BlendMode::Replace:
+        FillSpan(dst, src, static_cast<size_t>(count));
+        break;
+    case BlendMode::SrcOver:
+        BlendSolidSpanImpl<BlendMode::SrcOver>(dst, src, count);
+        break;
+    case BlendMode::Additive:
+        BlendSolidSpanImpl<BlendMode::Additive>(dst, src, count);
+        break;
+    case BlendMode::Multiply:
+        BlendSolidSpanImpl<BlendMode::Multiply>(dst, src, count);
+        break;
+    case BlendMode::Screen:
+        BlendSolidSpanImpl<BlendMode::Screen>(dst, src, count);
+        break;
+    }
+}
+
+void Blender::FillSpan(uint32_t* dst, uint32_t value, size_t count)
+{
+    size_t i = 0;
+#if BLENDER_USE_SSE2
+    if (count >= 16)
+    {
+        // 标量写到 16 字节边界，之后每次循环写 64 字节
+        for (; (reinterpret_cast<uintptr_t>(dst + i) & 15) != 0; ++i)
+        {
+            dst[i] = value;
+        }
+        const __m128i v = _mm_set1_epi32(static_cast<int>(value));
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i* p = reinterpret_cast<__m128i*>(dst + i);
+            _mm_store_si128(p, v);
+            _mm_store_si128(p + 1, v);
+            _mm_store_si128(p + 2, v);
+            _mm_store_si128(p + 3, v);
+        }
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_store_si128(reinterpret_cast<__m128i*>(dst + i), v);
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = value;
+    }
+}
+
+void Blender::StreamFillSpan(uint32_t* dst, uint32_t value, size_t count)
+{
+#if BLENDER_USE_SSE2
+    size_t i = 0;
+    for (; i < count && (reinterpret_cast<uintptr_t>(dst + i) & 15) != 0; ++i)
+    {
+        dst[i] = value;
+    }
+    const __m128i v = _mm_set1_epi32(static_cast<int>(value));
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i* p = reinterpret_cast<__m128i*>(dst + i);
+        _mm_stream_si128(p, v);
+        _mm_stream_si128(p + 1, v);
+        _mm_stream_si128(p + 2, v);
+        _mm_stream_si128(p + 3, v);
+    }
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = value;
+    }
+#else
+    FillSpan(dst, value, count);
+#endif
+}
+
+void Blender::StreamFence()
+{
+#if BLENDER_USE_SSE2
+    _mm_sfence();
+#endif
+}
+
+void Blender::BlendPixelPair(uint32_t* dst0, uint32_t* dst1, uint32_t src, uint8_t coverage0, uint8_t coverage1,
+                             BlendMode mode)
+{
+#if BLENDER_USE_SSE2
+    if (mode == BlendMode::Replace || mode == BlendMode::SrcOver)
+    {
+        // 两个像素展开为 16 位通道放在同一个寄存器中：先按覆盖率缩放源像素，再与目标混合
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i v255 = _mm_set1_epi16(255);
+        const __m128i s = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(src)), zero);
+        const __m128i coverage = _mm_unpacklo_epi64(_mm_set1_epi16(static_cast<short>(coverage0)),
+                                                    _mm_set1_epi16(static_cast<short>(coverage1)));
+        const __m128i d = _mm_unpacklo_epi8(
+            _mm_unpacklo_epi32(_mm_cvtsi32_si128(static_cast<int>(*dst0)), _mm_cvtsi32_si128(static_cast<int>(*dst1))),
+            zero);
+        const __m128i scaled = Div255(_mm_mullo_epi16(s, coverage));
+        // Replace：按覆盖率在目标与源之间插值；SrcOver：按缩放后源像素的 alpha 混合
+        const __m128i inv = _mm_sub_epi16(v255, mode == BlendMode::Replace ? coverage : BroadcastAlpha(scaled));
+        const __m128i result = _mm_packus_epi16(_mm_add_epi16(scaled, Div255(_mm_mullo_epi16(d, inv))), zero);
+        *dst0 = static_cast<uint32_t>(_mm_cvtsi128_si32(result));
+        *dst1 = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(result, 4)));
+        return;
+    }
+#endif
+    *dst0 = BlendPixel(*dst0, src, coverage0, mode);
+    *dst1 = BlendPixel(*dst1, src, coverage1, mode);
+}
+
+void Blender::BlendSolidStrided(uint32_t* dst, int stride, uint32_t src, int count, BlendMode mode)
+{
+    switch (mode)
+    {
+    case BlendMode::Replace:
+        BlendSolidStridedImpl<BlendMode::Replace>(dst, stride, src, count);
+        break;
+    case BlendMode::SrcOver:
+        BlendSolidStridedImpl<BlendMode::SrcOver>(dst, stride, src, count);
+        break;
+    case BlendMode::Additive:
+        BlendSolidStridedImpl<BlendMode::Additive>(dst, stride, src, count);
+        break;
+    case BlendMode::Multiply:
+        BlendSolidStridedImpl<BlendMode::Multiply>(dst, stride, src, count);
+        break;
+    case BlendMode::Screen:
+        BlendSolidStridedImpl<BlendMode::Screen>(dst, stride, src, count);
+        break;
+    }
+}
+
+void Blender::BlendMaskSpan(uint32_t* dst, uint32_t src, const uint8_t* coverage, int count, BlendMode mode)
+{
+    int i = 0;
+    while (i < count)
+    {
+        if (coverage[i] == 255)
+        {
+            int run = i + 1;
+            while (run < count && coverage[run] == 255)
+            {
+                ++run;
+            }
+            BlendSolidSpan(dst + i, src, run - i, mode);
+            i = run;
+            continue;
+        }
+        if (coverage[i] != 0)
+        {
+            dst[i] = BlendPixel(dst[i], src, coverage[i], mode);
+        }
+        ++i;
+    }
+}
+
+void Blender::PremultiplySpan(uint32_t* pixels, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        pixels[i] = Premultiply(pixels[i]);
+    }
+}
+
+void Blender::ScaleSpan(uint32_t* dst, const uint32_t* src, int count, uint32_t scale)
+{
+    int i = 0;
+#if BLENDER_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i factor = _mm_set1_epi16(static_cast<short>(scale));
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i lo = Div255(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), factor));
+        const __m128i hi = Div255(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), factor));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = ScalePixel(src[i], scale);
+    }
+}
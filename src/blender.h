@@ -0,0 +1,172 @@
+//
+// Created by admin on 2026/2/3.
+//
+
+#ifndef BLENDER_H
+#define BLENDER_H
+
+#include "color.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 帧缓冲混合模式
+ *
+ * 所有模式都在预乘 alpha 空间下计算（s = 源像素, d = 目标像素, 分量已乘以 alpha）：
+ *   - Replace:  d = s
+ *   - SrcOver:  d = s + d * (1 - sa)
+ *   - Additive: d = min(s + d, 1)
+ *   - Multiply: d = s * d + s * (1 - da) + d * (1 - sa)
+ *   - Screen:   d = s + d - s * d
+ */
+enum class BlendMode
+{
+    Replace,  // 直接覆盖
+    SrcOver,  // 标准 alpha 混合（源在上）
+    Additive, // 加法混合（饱和）
+    Multiply, // 正片叠底
+    Screen    // 滤色
+};
+
+/**
+ * @brief 像素混合器 - 对打包的 RGBA8888 预乘像素做混合
+ * 职责：
+ *   1. 提供单像素混合（标量 SWAR 实现）
+ *   2. 提供行（span）混合，支持 SSE2 时一次处理 4 个像素
+ *   3. 提供预乘 alpha 转换
+ *
+ * 约定：所有 uint32_t 像素均为预乘 alpha 的 RGBA8888（与 Color::ToUint32 布局一致）。
+ */
+class Blender
+{
+  public:
+    Blender() = delete;
+
+    /**
+     * @brief 混合单个像素
+     * @param dst 目标像素（预乘）
+     * @param src 源像素（预乘）
+     * @param mode 混合模式
+     * @return 混合结果（预乘）
+     */
+    static uint32_t BlendPixel(uint32_t dst, uint32_t src, BlendMode mode);
+
+    /**
+     * @brief 按覆盖率混合单个像素（用于抗锯齿边缘）
+     * Replace 模式下按覆盖率在 dst 与 src 之间线性插值，其余模式先将 src 乘以覆盖率再混合
+     * @param coverage 覆盖率 [0, 255]
+     */
+    static uint32_t BlendPixel(uint32_t dst, uint32_t src, uint8_t coverage, BlendMode mode);
+
+    /**
+     * @brief 将一行源像素混合到目标行
+     * @param dst 目标像素指针
+     * @param src 源像素指针（预乘）
+     * @param count 像素个数
+     * @param mode 混合模式
+     */
+    static void BlendSpan(uint32_t* dst, const uint32_t* src, int count, BlendMode mode);
+
+    /**
+     * @brief 将同一个源像素混合到目标行（纯色填充）
+     * @param dst 目标像素指针
+     * @param src 源像素（预乘）
+     * @param count 像素个数
+     * @param mode 混合模式
+     */
+    static void BlendSolidSpan(uint32_t* dst, uint32_t src, int count, BlendMode mode);
+
+    /**
+     * @brief 用同一个像素值填充 count 个像素（SSE2 每次写 16 字节，按 16 字节对齐后循环展开）
+     */
+    static void FillSpan(uint32_t* dst, uint32_t value, size_t count);
+
+    /**
+     * @brief 同 FillSpan，但使用绕过缓存的非临时（streaming）写入，适合远大于末级缓存的区域：
+     * 不会把整块目标读入缓存、也不会把其它数据挤出缓存。写完一批后需要调用 StreamFence
+     */
+    static void StreamFillSpan(uint32_t* dst, uint32_t value, size_t count);
+
+    /**
+     * @brief 保证之前的非临时写入对其它线程（以及随后的普通读取）可见
+     */
+    static void StreamFence();
+
+    /**
+     * @brief 按各自的覆盖率把同一个源像素混合到两个目标像素（如 Wu 直线每一步的上下两个像素）
+     * 支持 SSE2 时两个像素在同一个寄存器中完成混合，结果与两次 BlendPixel 完全一致
+     * @param dst0 第一个目标像素
+     * @param dst1 第二个目标像素（不能与 dst0 相同）
+     * @param src 源像素（预乘）
+     */
+    static void BlendPixelPair(uint32_t* dst0, uint32_t* dst1, uint32_t src, uint8_t coverage0, uint8_t coverage1,
+                               BlendMode mode);
+
+    /**
+     * @brief 将同一个源像素混合到间隔为 stride 的 count 个目标像素（如一列像素）
+     * @param stride 相邻两个目标像素之间相隔的像素个数（一列时为缓冲区宽度）
+     */
+    static void BlendSolidStrided(uint32_t* dst, int stride, uint32_t src, int count, BlendMode mode);
+
+    /**
+     * @brief 按逐像素覆盖率将同一个源像素混合到目标行（抗锯齿填充）
+     * 覆盖率为 255 的连续段按纯色填充处理，为 0 的像素跳过
+     * @param coverage 每个像素的覆盖率 [0, 255]
+     */
+    static void BlendMaskSpan(uint32_t* dst, uint32_t src, const uint8_t* coverage, int count, BlendMode mode);
+
+    /**
+     * @brief 将一行直通 alpha 像素原地转换为预乘 alpha
+     */
+    static void PremultiplySpan(uint32_t* pixels, int count);
+
+    /**
+     * @brief 将一行像素的每个通道乘以 scale / 255 写入 dst（结果与逐像素 ScalePixel 一致，如图层不透明度）
+     * dst 可以与 src 相同
+     */
+    static void ScaleSpan(uint32_t* dst, const uint32_t* src, int count, uint32_t scale);
+
+    /**
+     * @brief 将打包像素的每个通道乘以 scale / 255（四舍五入）
+     */
+    static uint32_t ScalePixel(uint32_t pixel, uint32_t scale)
+    {
+        uint32_t rb = (pixel & 0x00FF00FFu) * scale + 0x00800080u;
+        rb = ((rb + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+        uint32_t ag = ((pixel >> 8) & 0x00FF00FFu) * scale + 0x00800080u;
+        ag = (ag + ((ag >> 8) & 0x00FF00FFu)) & 0xFF00FF00u;
+        return rb | ag;
+    }
+
+    /**
+     * @brief 获取打包像素的 alpha 分量
+     */
+    static uint32_t AlphaOf(uint32_t pixel)
+    {
+        return (pixel >> kAlphaShift) & 0xFFu;
+    }
+
+    /**
+     * @brief 将直通 alpha 像素转换为预乘 alpha（alpha 分量保持不变）
+     */
+    static uint32_t Premultiply(uint32_t pixel)
+    {
+        const uint32_t a = AlphaOf(pixel);
+        if (a == 255)
+        {
+            return pixel;
+        }
+        const uint32_t alpha_mask = 0xFFu << kAlphaShift;
+        return (ScalePixel(pixel, a) & ~alpha_mask) | (pixel & alpha_mask);
+    }
+
+  private:
+    // alpha 分量在打包像素中的位偏移（参见 Color 的字节布局）
+#if COLOR_LITTLE_ENDIAN
+    static constexpr int kAlphaShift = 0;
+#else
+    static constexpr int kAlphaShift = 24;
+#endif
+};
+
+#endif // BLENDER_H
@@ -0,0 +1,519 @@
+//
+// Created by admin on 2026/2/16.
+//
+
+#include "command_buffer.h"
+#include "graphics_renderer.h"
+#include "primitive/line_primitive.h"
+#include "primitive/triangle_primitive.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+
+// 各类命令的数据（按值拷贝进 _data，读取时再拷贝出来，不要求对齐）
+struct PointCommand
+{
+    int32_t x;
+    int32_t y;
+    uint32_t color;
+};
+
+struct LineCommand
+{
+    float x1;
+    float y1;
+    float x2;
+    float y2;
+    uint32_t color;
+    uint32_t end_color;
+};
+
+struct TriangleCommand
+{
+    int32_t x[3];
+    int32_t y[3];
+    uint32_t color[3];
+};
+
+struct TexturedTriangleCommand
+{
+    int32_t x[3];
+    int32_t y[3];
+    float u[3];
+    float v[3];
+    const texture::Texture* texture;
+};
+
+struct ImageCommand
+{
+    const image::Image* image;
+    int32_t x;
+    int32_t y;
+};
+
+struct PrimitiveCommand
+{
+    const pri::IPrimitive* primitive;
+};
+
+// 命令数据按 8 字节对齐存放
+constexpr size_t kCommandAlignment = 8;
+
+// 状态键中纹理编号和录制状态编号的位置（各 24 位）
+constexpr int kTextureShift = 16;
+constexpr int kRenderStateShift = 40;
+constexpr uint64_t kIdMask = 0xFFFFFF;
+
+template <typename T>
+T ReadCommand(const std::vector<std::byte>& data, uint32_t offset)
+{
+    T command;
+    std::memcpy(&command, data.data() + offset, sizeof(T));
+    return command;
+}
+
+CommandBuffer::CommandType TypeOf(uint64_t state)
+{
+    return static_cast<CommandBuffer::CommandType>(state & 0xFF);
+}
+
+BlendMode BlendOf(uint64_t state)
+{
+    return static_cast<BlendMode>((state >> 8) & 0xFF);
+}
+
+uint32_t TextureOf(uint64_t state)
+{
+    return static_cast<uint32_t>((state >> kTextureShift) & kIdMask);
+}
+
+uint32_t RenderStateOf(uint64_t state)
+{
+    return static_cast<uint32_t>((state >> kRenderStateShift) & kIdMask);
+}
+
+// 两个半开矩形的交集
+math::BoundingBox2i Intersect(const math::BoundingBox2i& a, const math::BoundingBox2i& b)
+{
+    return math::BoundingBox2i(std::max(a.MinX(), b.MinX()), std::max(a.MinY(), b.MinY()),
+                               std::min(a.MaxX(), b.MaxX()), std::min(a.MaxY(), b.MaxY()));
+}
+
+// 整数顶点的像素包围盒 [min, max + 1)
+math::BoundingBox2i PixelBounds(const int32_t* x, const int32_t* y, int count)
+{
+    math::BoundingBox2i bounds;
+    for (int i = 0; i < count; ++i)
+    {
+        bounds.AddPoint(math::Point2i(x[i], y[i]));
+        bounds.AddPoint(math::Point2i(x[i] + 1, y[i] + 1));
+    }
+    return bounds;
+}
+
+} // namespace
+
+void CommandBuffer::DrawPoint(int x, int y, const Color& color)
+{
+    const PointCommand command{x, y, color.ToUint32()};
+    std::memcpy(Record(CommandType::Point, nullptr, math::BoundingBox2i(x, y, x + 1, y + 1), sizeof(command)),
+                &command, sizeof(command));
+}
+
+void CommandBuffer::DrawLine(int x1, int y1, int x2, int y2, const Color& color)
+{
+    DrawLine(pri::PointPrimitive(x1, y1, color), pri::PointPrimitive(x2, y2, color));
+}
+
+void CommandBuffer::DrawLine(const math::Point2f& start, const math::Point2f& end, const Color& color)
+{
+    // Bresenham 模式下端点四舍五入，与 LinePrimitive 一致
+    DrawLine(pri::PointPrimitive(static_cast<int>(std::lround(start.X())), static_cast<int>(std::lround(start.Y())),
+                                 color),
+             pri::PointPrimitive(static_cast<int>(std::lround(end.X())), static_cast<int>(std::lround(end.Y())),
+                                 color));
+}
+
+void CommandBuffer::DrawLine(const pri::PointPrimitive& start, const pri::PointPrimitive& end)
+{
+    const LineCommand command{static_cast<float>(start.X()), static_cast<float>(start.Y()),
+                              static_cast<float>(end.X()),   static_cast<float>(end.Y()),
+                              start.GetColor().ToUint32(),   end.GetColor().ToUint32()};
+    const int32_t x[2] = {start.X(), end.X()};
+    const int32_t y[2] = {start.Y(), end.Y()};
+    std::memcpy(Record(CommandType::Line, nullptr, PixelBounds(x, y, 2), sizeof(command)), &command,
+                sizeof(command));
+}
+
+void CommandBuffer::DrawAntialiasedLine(const math::Point2f& start, const math::Point2f& end, const Color& color)
+{
+    const LineCommand command{start.X(), start.Y(), end.X(), end.Y(), color.ToUint32(), color.ToUint32()};
+    // 抗锯齿直线会写到端点和线段两侧相邻的像素，包围盒各方向多留一个像素
+    const math::BoundingBox2i bounds(static_cast<int>(std::floor(std::min(start.X(), end.X()))) - 1,
+                                     static_cast<int>(std::floor(std::min(start.Y(), end.Y()))) - 1,
+                                     static_cast<int>(std::ceil(std::max(start.X(), end.X()))) + 2,
+                                     static_cast<int>(std::ceil(std::max(start.Y(), end.Y()))) + 2);
+    std::memcpy(Record(CommandType::AntialiasedLine, nullptr, bounds, sizeof(command)), &command, sizeof(command));
+}
+
+void CommandBuffer::DrawTriangle(const math::Point2i& p0, const math::Point2i& p1, const math::Point2i& p2,
+                                 const Color& color)
+{
+    DrawTriangle(pri::PointPrimitive(p0, color), pri::PointPrimitive(p1, color), pri::PointPrimitive(p2, color));
+}
+
+void CommandBuffer::DrawTriangle(const pri::PointPrimitive& p0, const pri::PointPrimitive& p1,
+                                 const pri::PointPrimitive& p2)
+{
+    const TriangleCommand command{{p0.X(), p1.X(), p2.X()},
+                                  {p0.Y(), p1.Y(), p2.Y()},
+                                  {p0.GetColor().ToUint32(), p1.GetColor().ToUint32(), p2.GetColor().ToUint32()}};
+    std::memcpy(Record(CommandType::Triangle, nullptr, PixelBounds(command.x, command.y, 3), sizeof(command)),
+                &command, sizeof(command));
+}
+
+void CommandBuffer::DrawTexturedTriangle(const math::Point2i& p0, const math::Point2i& p1, const math::Point2i& p2,
+                                         const texture::Texture* texture, const math::Point2f& uv0,
+                                         const math::Point2f& uv1, const math::Point2f& uv2)
+{
+    const TexturedTriangleCommand command{{p0.X(), p1.X(), p2.X()},
+                                          {p0.Y(), p1.Y(), p2.Y()},
+                                          {uv0.X(), uv1.X(), uv2.X()},
+                                          {uv0.Y(), uv1.Y(), uv2.Y()},
+                                          texture};
+    std::memcpy(
+        Record(CommandType::TexturedTriangle, texture, PixelBounds(command.x, command.y, 3), sizeof(command)),
+        &command, sizeof(command));
+}
+
+void CommandBuffer::DrawImage(const image::Image& image, int x, int y)
+{
+    const ImageCommand command{&image, x, y};
+    const math::BoundingBox2i bounds(x, y, x + image.Width(), y + image.Height());
+    std::memcpy(Record(CommandType::Image, nullptr, bounds, sizeof(command)), &command, sizeof(command));
+}
+
+void CommandBuffer::Draw(const pri::IPrimitive& primitive)
+{
+    const PrimitiveCommand command{&primitive};
+    std::memcpy(Record(CommandType::Primitive, nullptr, primitive.Bounds(), sizeof(command)), &command,
+                sizeof(command));
+}
+
+void CommandBuffer::CollectDamage(DamageTracker& damage) const
+{
+    for (const Entry& entry : _entries)
+    {
+        // 只有裁剪矩形内的像素会被写入
+        const uint32_t render_state = RenderStateOf(entry.state);
+        if (render_state != 0 && _render_states[render_state - 1].clipped)
+        {
+            damage.Add(Intersect(entry.bounds, _render_states[render_state - 1].clip));
+            continue;
+        }
+        damage.Add(entry.bounds);
+    }
+}
+
+void CommandBuffer::Append(const CommandBuffer& other)
+{
+    if (other._entries.empty())
+    {
+        return;
+    }
+    const size_t base = (_data.size() + kCommandAlignment - 1) & ~(kCommandAlignment - 1);
+    _data.resize(base + other._data.size());
+    std::memcpy(_data.data() + base, other._data.data(), other._data.size());
+
+    for (Entry entry : other._entries)
+    {
+        // 纹理和录制状态的编号只在各自的缓冲区内有效，按本缓冲区重新编号
+        const uint32_t texture = TextureOf(entry.state);
+        const uint32_t render_state = RenderStateOf(entry.state);
+        const uint64_t texture_id = texture != 0 ? TextureId(other._textures[texture - 1]) : 0;
+        const uint64_t render_state_id = render_state != 0 ? RenderStateId(other._render_states[render_state - 1]) : 0;
+        entry.state = (render_state_id << kRenderStateShift) | (texture_id << kTextureShift) | (entry.state & 0xFFFF);
+        entry.sequence = static_cast<uint32_t>(_entries.size());
+        entry.offset += static_cast<uint32_t>(base);
+        _entries.push_back(entry);
+    }
+}
+
+void CommandBuffer::Submit(GraphicsRenderer& renderer)
+{
+    if (_entries.empty())
+    {
+        _last_batch_count = 0;
+        return;
+    }
+    BuildBatches();
+
+    PixelsBuffer& buffer = renderer.Buffer();
+    const BlendMode previous_mode = buffer.GetBlendMode();
+    const math::BoundingBox2i previous_clip = buffer.ClipRect();
+    StencilBuffer* stencil = buffer.Stencil();
+    const StencilFunc previous_func = stencil ? stencil->Func() : StencilFunc::Always;
+    const uint8_t previous_reference = stencil ? stencil->Reference() : 0;
+    size_t begin = 0;
+    while (begin < _entries.size())
+    {
+        size_t end = begin + 1;
+        while (end < _entries.size() && _entries[end].batch == _entries[begin].batch)
+        {
+            ++end;
+        }
+        ExecuteBatch(renderer, begin, end, previous_clip);
+        begin = end;
+    }
+    buffer.SetBlendMode(previous_mode);
+    buffer.SetClipRect(previous_clip);
+    if (stencil)
+    {
+        stencil->SetTest(previous_func, previous_reference);
+    }
+
+    _last_batch_count = _batches.size();
+    Clear();
+}
+
+void CommandBuffer::Clear()
+{
+    _data.clear();
+    _entries.clear();
+    _batches.clear();
+    _textures.clear();
+    _render_states.clear();
+    _last_texture = nullptr;
+    _last_texture_id = 0;
+    _last_render_state_id = 0;
+}
+
+void* CommandBuffer::Record(CommandType type, const texture::Texture* texture, const math::BoundingBox2i& bounds,
+                            size_t size)
+{
+    const size_t offset = (_data.size() + kCommandAlignment - 1) & ~(kCommandAlignment - 1);
+    _data.resize(offset + size);
+
+    Entry entry;
+    entry.layer = _layer;
+    entry.sequence = static_cast<uint32_t>(_entries.size());
+    entry.sort_key = _sort_key;
+    entry.state = (static_cast<uint64_t>(RenderStateId(_render_state)) << kRenderStateShift) |
+                  (static_cast<uint64_t>(TextureId(texture)) << kTextureShift) |
+                  (static_cast<uint64_t>(static_cast<uint8_t>(_blend_mode)) << 8) | static_cast<uint64_t>(type);
+    entry.offset = static_cast<uint32_t>(offset);
+    entry.batch = 0;
+    entry.bounds = bounds;
+    _entries.push_back(entry);
+    return _data.data() + offset;
+}
+
+uint32_t CommandBuffer::TextureId(const texture::Texture* texture)
+{
+    if (texture == nullptr)
+    {
+        return 0;
+    }
+    if (texture == _last_texture)
+    {
+        return _last_texture_id;
+    }
+    // 一帧中用到的纹理通常不多，线性查找即可
+    auto it = std::find(_textures.begin(), _textures.end(), texture);
+    if (it == _textures.end())
+    {
+        _textures.push_back(texture);
+        it = _textures.end() - 1;
+    }
+    _last_texture = texture;
+    _last_texture_id = static_cast<uint32_t>(it - _textures.begin()) + 1;
+    return _last_texture_id;
+}
+
+uint32_t CommandBuffer::RenderStateId(const RenderState& state)
+{
+    if (state == RenderState())
+    {
+        return 0;
+    }
+    if (_last_render_state_id != 0 && _render_states[_last_render_state_id - 1] == state)
+    {
+        return _last_render_state_id;
+    }
+    auto it = std::find(_render_states.begin(), _render_states.end(), state);
+    if (it == _render_states.end())
+    {
+        _render_states.push_back(state);
+        it = _render_states.end() - 1;
+    }
+    _last_render_state_id = static_cast<uint32_t>(it - _render_states.begin()) + 1;
+    return _last_render_state_id;
+}
+
+void CommandBuffer::BuildBatches()
+{
+    // 按 (层, 排序键, 录制顺序) 排序，之后的合批以这个顺序为准
+    std::sort(_entries.begin(), _entries.end(),
+              [](const Entry& a, const Entry& b)
+              {
+                  if (a.layer != b.layer)
+                  {
+                      return a.layer < b.layer;
+                  }
+                  return a.sort_key != b.sort_key ? a.sort_key < b.sort_key : a.sequence < b.sequence;
+              });
+    for (size_t i = 0; i < _entries.size(); ++i)
+    {
+        _entries[i].sequence = static_cast<uint32_t>(i);
+    }
+
+    _batches.clear();
+    size_t layer_begin = 0;
+    for (size_t i = 0; i < _entries.size(); ++i)
+    {
+        Entry& entry = _entries[i];
+        if (i > 0 && entry.layer != _entries[i - 1].layer)
+        {
+            layer_begin = _batches.size();
+        }
+
+        // 从最近的批次往前找同状态的批次，遇到包围盒相交的批次就停止（不能越过它重排）
+        size_t target = _batches.size();
+        if (TypeOf(entry.state) != CommandType::Primitive)
+        {
+            const size_t stop = std::max(layer_begin, _batches.size() - std::min(_batches.size(), kMaxLookback));
+            for (size_t k = _batches.size(); k > stop; --k)
+            {
+                const Batch& batch = _batches[k - 1];
+                if (batch.state == entry.state)
+                {
+                    target = k - 1;
+                    break;
+                }
+                if (batch.bounds.Intersects(entry.bounds))
+                {
+                    break;
+                }
+            }
+        }
+
+        if (target == _batches.size())
+        {
+            _batches.push_back({entry.state, entry.bounds});
+        }
+        else
+        {
+            _batches[target].bounds.AddBox(entry.bounds);
+        }
+        entry.batch = static_cast<uint32_t>(target);
+    }
+
+    // 批次按创建顺序绘制，批次内保持记录顺序
+    std::sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b)
+              { return a.batch != b.batch ? a.batch < b.batch : a.sequence < b.sequence; });
+}
+
+void CommandBuffer::ExecuteBatch(GraphicsRenderer& renderer, size_t begin, size_t end,
+                                 const math::BoundingBox2i& clip)
+{
+    PixelsBuffer& buffer = renderer.Buffer();
+    const uint64_t state = _entries[begin].state;
+    buffer.SetBlendMode(BlendOf(state));
+
+    // 恢复录制时的裁剪矩形和模板测试
+    const uint32_t render_state_id = RenderStateOf(state);
+    const RenderState render_state = render_state_id != 0 ? _render_states[render_state_id - 1] : RenderState();
+    buffer.SetClipRect(render_state.clipped ? Intersect(render_state.clip, clip) : clip);
+    if (StencilBuffer* stencil = buffer.Stencil())
+    {
+        stencil->SetTest(render_state.stencil_func, render_state.stencil_reference);
+    }
+
+    switch (TypeOf(state))
+    {
+    case CommandType::Point:
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto command = ReadCommand<PointCommand>(_data, _entries[i].offset);
+            buffer.BlendPixel(command.x, command.y, Color(command.color));
+        }
+        break;
+    case CommandType::Line:
+    {
+        // 纯色直线整批交给 LineBatch（光栅化结果与 LinePrimitive 逐像素一致），有渐变直线时逐条绘制
+        bool gradient = false;
+        for (size_t i = begin; i < end && !gradient; ++i)
+        {
+            const auto command = ReadCommand<LineCommand>(_data, _entries[i].offset);
+            gradient = command.color != command.end_color;
+        }
+        if (!gradient)
+        {
+            _line_batch.Clear();
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto command = ReadCommand<LineCommand>(_data, _entries[i].offset);
+                _line_batch.Add(static_cast<int>(command.x1), static_cast<int>(command.y1),
+                                static_cast<int>(command.x2), static_cast<int>(command.y2), Color(command.color));
+            }
+            _line_batch.LineBatch::Draw(buffer);
+            break;
+        }
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto command = ReadCommand<LineCommand>(_data, _entries[i].offset);
+            const pri::LinePrimitive line(math::Point2f(command.x1, command.y1), math::Point2f(command.x2, command.y2),
+                                          Color(command.color), Color(command.end_color));
+            line.LinePrimitive::Draw(buffer);
+        }
+        break;
+    }
+    case CommandType::AntialiasedLine:
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto command = ReadCommand<LineCommand>(_data, _entries[i].offset);
+            const pri::LinePrimitive line(math::Point2f(command.x1, command.y1), math::Point2f(command.x2, command.y2),
+                                          Color(command.color), Color(command.end_color), true);
+            line.LinePrimitive::Draw(buffer);
+        }
+        break;
+    case CommandType::Triangle:
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto command = ReadCommand<TriangleCommand>(_data, _entries[i].offset);
+            auto vertex = [&](int k)
+            { return pri::PointPrimitive(command.x[k], command.y[k], Color(command.color[k])); };
+            const pri::TrianglePrimitive triangle(vertex(0), vertex(1), vertex(2));
+            triangle.TrianglePrimitive::Draw(buffer);
+        }
+        break;
+    case CommandType::TexturedTriangle:
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto command = ReadCommand<TexturedTriangleCommand>(_data, _entries[i].offset);
+            const pri::TrianglePrimitive triangle(
+                pri::PointPrimitive(command.x[0], command.y[0]), pri::PointPrimitive(command.x[1], command.y[1]),
+                pri::PointPrimitive(command.x[2], command.y[2]), command.texture,
+                math::Point2f(command.u[0], command.v[0]), math::Point2f(command.u[1], command.v[1]),
+                math::Point2f(command.u[2], command.v[2]));
+            triangle.TrianglePrimitive::Draw(buffer);
+        }
+        break;
+    case CommandType::Image:
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto command = ReadCommand<ImageCommand>(_data, _entries[i].offset);
+            renderer.DrawImage(*command.image, command.x, command.y);
+        }
+        break;
+    case CommandType::Primitive:
+        for (size_t i = begin; i < end; ++i)
+        {
+            ReadCommand<PrimitiveCommand>(_data, _entries[i].offset).primitive->Draw(buffer);
+        }
+        break;
+    }
+}
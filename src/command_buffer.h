@@ -0,0 +1,325 @@
+//
+// Created by admin on 2026/2/16.
+//
+
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include "blender.h"
+#include "color.h"
+#include "damage_tracker.h"
+#include "image/image.h"
+#include "math/bounding_box.h"
+#include "math/point.h"
+#include "primitive/line_batch.h"
+#include "primitive/point_primitive.h"
+#include "primitive/primitive.h"
+#include "stencil_buffer.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class GraphicsRenderer;
+
+/**
+ * @brief 绘制命令缓冲区（立即模式接口，延迟光栅化）
+ *
+ * Draw* 调用只把命令按紧凑的二进制格式追加到缓冲区，Submit 时才统一绘制：
+ *   - 每条命令记录排序键 (layer, texture, blend, type)、像素包围盒以及录制时的裁剪矩形和模板测试，
+ *     裁剪或模板测试不同的命令不会合并到同一批次
+ *   - 先按 (层, 排序键, 录制顺序) 排序，再在层内把状态相同的命令合并成批：
+ *     命令可以提前到前面的同状态批次中，前提是它与中间所有批次的包围盒都不相交，
+ *     因此合批不会改变任何像素的混合顺序，结果与逐条绘制完全一致
+ *   - 每个批次只切换一次混合模式、裁剪矩形和模板测试，按命令类型直接调用对应的光栅化函数（无虚函数分派），
+ *     同一纹理的三角形连续绘制，纹理数据留在缓存中；纯色直线整批交给 LineBatch
+ *
+ * 多线程录制：每个任务各自录制一个 CommandBuffer（互不共享，无需加锁），
+ * 提交前用 Append 按任务编号的固定顺序合并到同一个缓冲区（按执行线程编号选取缓冲区时，合并顺序取决于作业调度）。同一个缓冲区被多个作业先后录制时，
+ * 每个作业在 RecordScope 内录制，层、排序键和混合模式不会从上一个作业继承。层内按显式排序键 (SetSortKey) 排序，
+ * 排序键相同的命令依次按合并顺序和录制顺序排列，因此只要每个列表录制的内容确定，
+ * 绘制结果就与线程的执行时序无关。
+ *
+ * 纹理、图像和通过 Draw 记录的图元都不被持有，调用方需保证它们在 Submit 之前有效。
+ * 缓冲区的内存在 Clear / Submit 后保留，稳定状态下记录命令不分配堆内存。
+ */
+class CommandBuffer
+{
+  public:
+    // 命令类型
+    enum class CommandType : uint8_t
+    {
+        Point,
+        Line,
+        AntialiasedLine,
+        Triangle,
+        TexturedTriangle,
+        Image,
+        Primitive,
+    };
+
+    // 合批时向前查找同状态批次的最大距离（批次数）
+    static constexpr size_t kMaxLookback = 64;
+
+    /**
+     * @brief 录制作用域：构造和析构时都调用 Begin，作用域内设置的录制状态不会带到之后的录制中
+     */
+    class RecordScope
+    {
+      public:
+        explicit RecordScope(CommandBuffer& buffer) : _buffer(buffer)
+        {
+            _buffer.Begin();
+        }
+
+        ~RecordScope()
+        {
+            _buffer.Begin();
+        }
+
+        RecordScope(const RecordScope&) = delete;
+        RecordScope& operator=(const RecordScope&) = delete;
+
+      private:
+        CommandBuffer& _buffer;
+    };
+
+    CommandBuffer() = default;
+
+    /**
+     * @brief 开始一段录制：层、排序键、混合模式、裁剪矩形和模板测试恢复为默认值（已记录的命令不受影响）
+     *
+     * 这些状态在设置后一直保留，同一个缓冲区先后交给多个作业录制时，
+     * 每个作业应先调用 Begin（或使用 RecordScope），否则会继承上一个作业留下的状态。
+     */
+    void Begin()
+    {
+        _layer = 0;
+        _sort_key = 0;
+        _blend_mode = BlendMode::Replace;
+        _render_state = RenderState();
+    }
+
+    /**
+     * @brief 设置之后记录的命令所在的层，层号小的先绘制（默认 0）
+     */
+    void SetLayer(uint32_t layer)
+    {
+        _layer = layer;
+    }
+    [[nodiscard]] uint32_t GetLayer() const
+    {
+        return _layer;
+    }
+
+    /**
+     * @brief 设置之后记录的命令的排序键，同一层内排序键小的先绘制（默认 0）
+     */
+    void SetSortKey(uint64_t key)
+    {
+        _sort_key = key;
+    }
+    [[nodiscard]] uint64_t GetSortKey() const
+    {
+        return _sort_key;
+    }
+
+    /**
+     * @brief 设置之后记录的命令使用的混合模式（默认 Replace，与渲染器当前的混合模式无关）
+     */
+    void SetBlendMode(BlendMode mode)
+    {
+        _blend_mode = mode;
+    }
+    [[nodiscard]] BlendMode GetBlendMode() const
+    {
+        return _blend_mode;
+    }
+
+    /**
+     * @brief 设置之后记录的命令的裁剪矩形（目标坐标，半开区间），提交时再与目标当前的裁剪矩形求交
+     *
+     * 渲染器的 Commands() 由 GraphicsRenderer::PushClipRect / PopClipRect 自动同步，
+     * 命令列表等其它缓冲区需要显式设置。
+     */
+    void SetClipRect(const math::BoundingBox2i& rect)
+    {
+        _render_state.clip = rect;
+        _render_state.clipped = true;
+    }
+
+    /**
+     * @brief 之后记录的命令不裁剪（默认）
+     */
+    void ResetClipRect()
+    {
+        _render_state.clip = math::BoundingBox2i();
+        _render_state.clipped = false;
+    }
+
+    [[nodiscard]] bool HasClipRect() const
+    {
+        return _render_state.clipped;
+    }
+    [[nodiscard]] math::BoundingBox2i GetClipRect() const
+    {
+        return _render_state.clip;
+    }
+
+    /**
+     * @brief 设置之后记录的命令的模板测试（默认 Always，不测试），提交时只对带模板平面的目标生效
+     *
+     * 渲染器的 Commands() 由 GraphicsRenderer::SetStencilTest 自动同步。
+     */
+    void SetStencilTest(StencilFunc func, uint8_t reference)
+    {
+        _render_state.stencil_func = func;
+        _render_state.stencil_reference = reference;
+    }
+
+    void DrawPoint(int x, int y, const Color& color);
+
+    /**
+     * @brief 直线（Bresenham，端点四舍五入到整数）
+     */
+    void DrawLine(int x1, int y1, int x2, int y2, const Color& color);
+    void DrawLine(const math::Point2f& start, const math::Point2f& end, const Color& color);
+
+    /**
+     * @brief 渐变直线，颜色从起点颜色过渡到终点颜色
+     */
+    void DrawLine(const pri::PointPrimitive& start, const pri::PointPrimitive& end);
+
+    void DrawAntialiasedLine(const math::Point2f& start, const math::Point2f& end, const Color& color);
+
+    /**
+     * @brief 纯色三角形
+     */
+    void DrawTriangle(const math::Point2i& p0, const math::Point2i& p1, const math::Point2i& p2, const Color& color);
+
+    /**
+     * @brief 顶点颜色插值的三角形
+     */
+    void DrawTriangle(const pri::PointPrimitive& p0, const pri::PointPrimitive& p1, const pri::PointPrimitive& p2);
+
+    /**
+     * @brief 带纹理的三角形（不持有纹理）
+     */
+    void DrawTexturedTriangle(const math::Point2i& p0, const math::Point2i& p1, const math::Point2i& p2,
+                              const texture::Texture* texture, const math::Point2f& uv0, const math::Point2f& uv1,
+                              const math::Point2f& uv2);
+
+    /**
+     * @brief 图像，左上角位于 (x, y)（不持有图像）
+     */
+    void DrawImage(const image::Image& image, int x, int y);
+
+    /**
+     * @brief 任意图元（不持有图元），按 IPrimitive::Bounds 参与合批；
+     * 包围盒未知的图元不参与合批，其它命令也不能越过它重排
+     */
+    void Draw(const pri::IPrimitive& primitive);
+
+    /**
+     * @brief 把另一个缓冲区的全部命令追加到本缓冲区（排在已有命令之后），other 保持不变
+     *
+     * 追加不会与录制并发进行：应在所有线程录制完成后，按固定顺序逐个追加。
+     */
+    void Append(const CommandBuffer& other);
+
+    /**
+     * @brief 把全部命令的包围盒加入损坏区域
+     */
+    void CollectDamage(DamageTracker& damage) const;
+
+    /**
+     * @brief 排序、合批并绘制全部命令，然后清空缓冲区
+     */
+    void Submit(GraphicsRenderer& renderer);
+
+    /**
+     * @brief 丢弃全部命令（保留内存）
+     */
+    void Clear();
+
+    [[nodiscard]] size_t Size() const
+    {
+        return _entries.size();
+    }
+    [[nodiscard]] bool Empty() const
+    {
+        return _entries.empty();
+    }
+
+    /**
+     * @brief 最近一次 Submit 绘制的批次数
+     */
+    [[nodiscard]] size_t LastBatchCount() const
+    {
+        return _last_batch_count;
+    }
+
+  private:
+    // 命令索引：排序和合批只操作索引，命令数据留在 _data 中
+    struct Entry
+    {
+        uint32_t layer;
+        uint32_t sequence; // 录制顺序（追加的命令接在已有命令之后）
+        uint64_t sort_key;
+        uint64_t state;    // (render_state << 40) | (texture << 16) | (blend << 8) | type
+        uint32_t offset;   // 命令数据在 _data 中的偏移
+        uint32_t batch;    // Submit 时分配的批次
+        math::BoundingBox2i bounds; // 像素包围盒 [min, max)
+    };
+
+    // 录制时的裁剪矩形和模板测试（命令按编号引用，相同的状态只存一份）
+    struct RenderState
+    {
+        math::BoundingBox2i clip;
+        bool clipped = false;
+        StencilFunc stencil_func = StencilFunc::Always;
+        uint8_t stencil_reference = 0;
+
+        bool operator==(const RenderState& other) const = default;
+    };
+
+    // 合批过程中的批次
+    struct Batch
+    {
+        uint64_t state;
+        math::BoundingBox2i bounds;
+    };
+
+    // 追加一条命令，返回命令数据的写入位置
+    void* Record(CommandType type, const texture::Texture* texture, const math::BoundingBox2i& bounds,
+                 size_t size);
+
+    // 纹理在本缓冲区内的编号（按首次使用的顺序分配，与指针值无关）
+    uint32_t TextureId(const texture::Texture* texture);
+
+    // 录制状态在本缓冲区内的编号（0 为默认状态，其余按首次使用的顺序分配）
+    uint32_t RenderStateId(const RenderState& state);
+
+    // 按层分配批次并按 (批次, 记录顺序) 排序
+    void BuildBatches();
+
+    // 绘制 [begin, end) 中状态相同的一批命令，clip 为提交时目标的裁剪矩形
+    void ExecuteBatch(GraphicsRenderer& renderer, size_t begin, size_t end, const math::BoundingBox2i& clip);
+
+    std::vector<std::byte> _data;
+    std::vector<Entry> _entries;
+    std::vector<Batch> _batches;
+    std::vector<const texture::Texture*> _textures;
+    std::vector<RenderState> _render_states;
+    pri::LineBatch _line_batch;
+
+    uint32_t _layer = 0;
+    uint64_t _sort_key = 0;
+    BlendMode _blend_mode = BlendMode::Replace;
+    RenderState _render_state;
+    const texture::Texture* _last_texture = nullptr;
+    uint32_t _last_texture_id = 0;
+    uint32_t _last_render_state_id = 0;
+    size_t _last_batch_count = 0;
+};
+
+#endif // COMMAND_BUFFER_H
@@ -0,0 +1,89 @@
+//
+// Created by admin on 2026/2/20.
+//
+
+#include "compositor.h"
+#include "graphics_renderer.h"
+#include <utility>
+
+size_t Compositor::AddLayer(int width, int height, DrawCallback draw, bool is_static)
+{
+    Layer layer;
+    layer.target = _pool.Acquire(width, height);
+    layer.draw = std::move(draw);
+    layer.is_static = is_static;
+    _layers.push_back(std::move(layer));
+    return _layers.size() - 1;
+}
+
+void Compositor::RemoveLayer(size_t layer)
+{
+    _layers[layer] = Layer{};
+}
+
+void Compositor::SetPosition(size_t layer, int x, int y)
+{
+    _layers[layer].x = x;
+    _layers[layer].y = y;
+}
+
+void Compositor::SetOpacity(size_t layer, uint8_t opacity)
+{
+    _layers[layer].opacity = opacity;
+}
+
+void Compositor::SetBlendMode(size_t layer, BlendMode mode)
+{
+    _layers[layer].blend_mode = mode;
+}
+
+void Compositor::SetVisible(size_t layer, bool visible)
+{
+    _layers[layer].visible = visible;
+}
+
+void Compositor::SetClip(size_t layer, const math::BoundingBox2i& clip)
+{
+    _layers[layer].clip = clip;
+}
+
+void Compositor::Invalidate(size_t layer)
+{
+    _layers[layer].dirty = true;
+}
+
+void Compositor::Render(GraphicsRenderer& renderer)
+{
+    const BlendMode previous_mode = renderer.GetBlendMode();
+    _redrawn = 0;
+
+    // 先更新图层内容：隐藏的图层推迟到可见时再绘制
+    for (auto& layer : _layers)
+    {
+        if (!layer.target || !layer.visible || (layer.is_static && !layer.dirty))
+        {
+            continue;
+        }
+        renderer.PushRenderTarget(*layer.target);
+        renderer.SetBlendMode(BlendMode::SrcOver);
+        layer.target->Buffer().Clear(Color::Transparent());
+        if (layer.draw)
+        {
+            layer.draw(renderer);
+        }
+        renderer.PopRenderTarget();
+        layer.dirty = false;
+        ++_redrawn;
+    }
+
+    for (const auto& layer : _layers)
+    {
+        if (!layer.target || !layer.visible || layer.opacity == 0)
+        {
+            continue;
+        }
+        renderer.SetBlendMode(layer.blend_mode);
+        renderer.DrawRenderTarget(*layer.target, layer.x, layer.y, layer.opacity, layer.clip);
+    }
+    renderer.SetBlendMode(previous_mode);
+}
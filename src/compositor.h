@@ -0,0 +1,108 @@
+//
+// Created by admin on 2026/2/20.
+//
+
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include "blender.h"
+#include "math/bounding_box.h"
+#include "render_target.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class GraphicsRenderer;
+
+/**
+ * @brief 图层合成器
+ *
+ * 每个图层拥有一个从渲染目标池取得的离屏渲染目标和一个绘制回调，Render 时：
+ *   1. 把需要更新的图层绘制到各自的渲染目标：动态图层每帧重绘，静态图层只在创建后或 Invalidate 之后重绘，
+ *      其余帧直接使用缓存的像素
+ *   2. 按添加顺序把可见图层合成到渲染器的当前目标，每个图层有自己的位置、不透明度、混合模式和裁剪矩形
+ *
+ * 移动图层、修改不透明度或裁剪矩形只影响合成，不会使静态图层重绘。
+ * 绘制回调中应使用立即绘制接口：命令缓冲区中的命令在 SubmitCommands 时才绘制，那时图层目标已经解绑。
+ */
+class Compositor
+{
+  public:
+    using DrawCallback = std::function<void(GraphicsRenderer&)>;
+
+    explicit Compositor(RenderTargetPool& pool) : _pool(pool) {}
+
+    /**
+     * @brief 添加图层（合成在已有图层之上）
+     * @param width 图层宽度
+     * @param height 图层高度
+     * @param draw 绘制回调，调用时图层目标已绑定并清除为透明
+     * @param is_static 静态图层只绘制一次，之后需要调用 Invalidate 才会重绘
+     * @return 图层编号
+     */
+    size_t AddLayer(int width, int height, DrawCallback draw, bool is_static = false);
+
+    /**
+     * @brief 删除图层，渲染目标归还渲染目标池（其它图层的编号不变）
+     */
+    void RemoveLayer(size_t layer);
+
+    void SetPosition(size_t layer, int x, int y);
+    void SetOpacity(size_t layer, uint8_t opacity);
+    void SetBlendMode(size_t layer, BlendMode mode);
+    void SetVisible(size_t layer, bool visible);
+
+    /**
+     * @brief 设置裁剪矩形（合成目标坐标，半开区间），无效矩形表示不裁剪
+     */
+    void SetClip(size_t layer, const math::BoundingBox2i& clip);
+
+    /**
+     * @brief 使图层在下一次 Render 时重绘（静态图层的内容变化时调用）
+     */
+    void Invalidate(size_t layer);
+
+    /**
+     * @brief 图层的渲染目标，可以用来创建 texture::Texture，把图层内容作为纹理使用
+     */
+    [[nodiscard]] const std::shared_ptr<RenderTarget>& Target(size_t layer) const
+    {
+        return _layers[layer].target;
+    }
+
+    /**
+     * @brief 更新需要重绘的图层，再把全部可见图层合成到 renderer 的当前目标
+     */
+    void Render(GraphicsRenderer& renderer);
+
+    /**
+     * @brief 上一次 Render 重绘的图层数（静态图层命中缓存时不计入）
+     */
+    [[nodiscard]] size_t RedrawnLayerCount() const
+    {
+        return _redrawn;
+    }
+
+  private:
+    struct Layer
+    {
+        std::shared_ptr<RenderTarget> target; // 为空表示图层已删除
+        DrawCallback draw;
+        int x = 0;
+        int y = 0;
+        uint8_t opacity = 255;
+        BlendMode blend_mode = BlendMode::SrcOver;
+        math::BoundingBox2i clip{};
+        bool is_static = false;
+        bool visible = true;
+        bool dirty = true;
+    };
+
+    RenderTargetPool& _pool;
+    std::vector<Layer> _layers;
+    size_t _redrawn = 0;
+};
+
+#endif // COMPOSITOR_H
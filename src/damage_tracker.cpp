@@ -0,0 +1,158 @@
+//
+// Created by admin on 2026/2/18.
+//
+
+#include "damage_tracker.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+
+int64_t RectArea(const math::BoundingBox2i& rect)
+{
+    return static_cast<int64_t>(rect.Width()) * rect.Height();
+}
+
+math::BoundingBox2i Union(const math::BoundingBox2i& a, const math::BoundingBox2i& b)
+{
+    return math::BoundingBox2i(std::min(a.MinX(), b.MinX()), std::min(a.MinY(), b.MinY()),
+                               std::max(a.MaxX(), b.MaxX()), std::max(a.MaxY(), b.MaxY()));
+}
+
+bool Contains(const math::BoundingBox2i& outer, const math::BoundingBox2i& inner)
+{
+    return outer.MinX() <= inner.MinX() && outer.MinY() <= inner.MinY() && outer.MaxX() >= inner.MaxX() &&
+           outer.MaxY() >= inner.MaxY();
+}
+
+} // namespace
+
+DamageTracker::DamageTracker()
+{
+    // 合并前最多临时多出一个矩形，预留容量后添加矩形不分配堆内存
+    _rects.reserve(kMaxRects + 1);
+}
+
+void DamageTracker::SetExtent(int width, int height)
+{
+    _width = std::max(width, 0);
+    _height = std::max(height, 0);
+    _rects.clear();
+}
+
+void DamageTracker::Add(const math::BoundingBox2i& rect)
+{
+    math::BoundingBox2i clipped = rect;
+    if (!Clip(clipped) || Covers(clipped))
+    {
+        return;
+    }
+    Insert(clipped);
+
+    while (_rects.size() > kMaxRects)
+    {
+        // 合并多覆盖面积最小的一对
+        size_t best_i = 0;
+        size_t best_j = 1;
+        int64_t best_waste = std::numeric_limits<int64_t>::max();
+        for (size_t i = 0; i < _rects.size(); ++i)
+        {
+            for (size_t j = i + 1; j < _rects.size(); ++j)
+            {
+                const int64_t waste =
+                    RectArea(Union(_rects[i], _rects[j])) - RectArea(_rects[i]) - RectArea(_rects[j]);
+                if (waste < best_waste)
+                {
+                    best_waste = waste;
+                    best_i = i;
+                    best_j = j;
+                }
+            }
+        }
+        const math::BoundingBox2i merged = Union(_rects[best_i], _rects[best_j]);
+        _rects[best_j] = _rects.back();
+        _rects.pop_back();
+        _rects[best_i] = _rects.back();
+        _rects.pop_back();
+        Insert(merged);
+    }
+}
+
+void DamageTracker::AddAll()
+{
+    _rects.clear();
+    if (_width > 0 && _height > 0)
+    {
+        _rects.emplace_back(0, 0, _width, _height);
+    }
+}
+
+void DamageTracker::Merge(const DamageTracker& other)
+{
+    for (const auto& rect : other._rects)
+    {
+        Add(rect);
+    }
+}
+
+bool DamageTracker::IsFull() const
+{
+    return _rects.size() == 1 && RectArea(_rects[0]) == static_cast<int64_t>(_width) * _height;
+}
+
+bool DamageTracker::Intersects(const math::BoundingBox2i& rect) const
+{
+    return std::any_of(_rects.begin(), _rects.end(),
+                       [&rect](const math::BoundingBox2i& damaged) { return damaged.Intersects(rect); });
+}
+
+bool DamageTracker::Covers(const math::BoundingBox2i& rect) const
+{
+    math::BoundingBox2i clipped = rect;
+    if (!Clip(clipped))
+    {
+        return true;
+    }
+    return std::any_of(_rects.begin(), _rects.end(),
+                       [&clipped](const math::BoundingBox2i& damaged) { return Contains(damaged, clipped); });
+}
+
+int64_t DamageTracker::Area() const
+{
+    int64_t area = 0;
+    for (const auto& rect : _rects)
+    {
+        area += RectArea(rect);
+    }
+    return area;
+}
+
+bool DamageTracker::Clip(math::BoundingBox2i& rect) const
+{
+    rect = math::BoundingBox2i(std::max(rect.MinX(), 0), std::max(rect.MinY(), 0), std::min(rect.MaxX(), _width),
+                               std::min(rect.MaxY(), _height));
+    return rect.MinX() < rect.MaxX() && rect.MinY() < rect.MaxY();
+}
+
+void DamageTracker::Insert(math::BoundingBox2i rect)
+{
+    // 合并后的包围盒可能与之前不相交的矩形相交，重复扫描直到没有相交的矩形
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < _rects.size(); ++i)
+        {
+            if (_rects[i].Intersects(rect))
+            {
+                rect = Union(rect, _rects[i]);
+                _rects[i] = _rects.back();
+                _rects.pop_back();
+                merged = true;
+                break;
+            }
+        }
+    }
+    _rects.push_back(rect);
+}
@@ -0,0 +1,108 @@
+//
+// Created by admin on 2026/2/18.
+//
+
+#ifndef DAMAGE_TRACKER_H
+#define DAMAGE_TRACKER_H
+
+#include "math/bounding_box.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 损坏区域（dirty rect）跟踪
+ *
+ * 记录一帧内需要重绘和上传的像素区域，保存为少量互不相交的矩形（半开区间 [min, max)）：
+ *   - 添加的矩形先裁剪到屏幕范围，已被某个矩形完整包含时直接忽略
+ *   - 与已有矩形相交时合并成包围盒，合并结果再与其它矩形相交时继续合并，保证矩形两两不相交
+ *   - 矩形个数超过 kMaxRects 时，合并多覆盖面积最小的一对，因此矩形个数和逐矩形的开销都有上限
+ *
+ * 矩形之间不相交，逐矩形清除、重绘和上传时每个像素最多处理一次。
+ */
+class DamageTracker
+{
+  public:
+    // 最多保存的矩形个数
+    static constexpr size_t kMaxRects = 8;
+
+    DamageTracker();
+
+    /**
+     * @brief 设置屏幕范围 [0, width) x [0, height)，并清空已有的损坏区域
+     */
+    void SetExtent(int width, int height);
+
+    [[nodiscard]] int Width() const
+    {
+        return _width;
+    }
+
+    [[nodiscard]] int Height() const
+    {
+        return _height;
+    }
+
+    /**
+     * @brief 添加损坏矩形（半开区间），空矩形和无效矩形被忽略
+     */
+    void Add(const math::BoundingBox2i& rect);
+
+    /**
+     * @brief 整个屏幕都需要重绘
+     */
+    void AddAll();
+
+    /**
+     * @brief 把另一个跟踪器的全部矩形加入本跟踪器
+     */
+    void Merge(const DamageTracker& other);
+
+    void Clear()
+    {
+        _rects.clear();
+    }
+
+    [[nodiscard]] bool Empty() const
+    {
+        return _rects.empty();
+    }
+
+    /**
+     * @brief 是否覆盖了整个屏幕
+     */
+    [[nodiscard]] bool IsFull() const;
+
+    /**
+     * @brief rect 是否与某个损坏矩形相交
+     */
+    [[nodiscard]] bool Intersects(const math::BoundingBox2i& rect) const;
+
+    /**
+     * @brief rect（裁剪到屏幕范围后）是否被某一个损坏矩形完整包含
+     */
+    [[nodiscard]] bool Covers(const math::BoundingBox2i& rect) const;
+
+    /**
+     * @brief 损坏区域的总像素数
+     */
+    [[nodiscard]] int64_t Area() const;
+
+    [[nodiscard]] const std::vector<math::BoundingBox2i>& Rects() const
+    {
+        return _rects;
+    }
+
+  private:
+    // 裁剪到屏幕范围，结果为空时返回 false
+    bool Clip(math::BoundingBox2i& rect) const;
+
+    // 加入矩形并与相交的矩形逐级合并
+    void Insert(math::BoundingBox2i rect);
+
+    std::vector<math::BoundingBox2i> _rects;
+    int _width = 0;
+    int _height = 0;
+};
+
+#endif // DAMAGE_TRACKER_H
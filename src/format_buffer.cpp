@@ -0,0 +1,361 @@
+//
+// Created by admin on 2026/2/19.
+//
+
+#include "format_buffer.h"
+#include "pixels_buffer.h"
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+
+namespace
+{
+
+// 每种格式的逐像素内核：Pixel 为存储类型，Load / Store 与预乘 RGBA8888 互相转换，Blend 按覆盖率混合
+struct Rgba8888Format
+{
+    using Pixel = uint32_t;
+
+    static uint32_t Load(Pixel pixel)
+    {
+        return pixel;
+    }
+    static Pixel Store(uint32_t rgba)
+    {
+        return rgba;
+    }
+    static void Blend(Pixel& dst, uint32_t src, uint8_t coverage, BlendMode mode)
+    {
+        dst = Blender::BlendPixel(dst, src, coverage, mode);
+    }
+};
+
+// 没有 alpha 通道：读出的 alpha 为 255，相当于混合到不透明背景上
+struct Rgb565Format
+{
+    using Pixel = uint16_t;
+
+    static uint32_t Load(Pixel pixel)
+    {
+        return PixelConverter::DecodeRGB565(pixel);
+    }
+    static Pixel Store(uint32_t rgba)
+    {
+        return PixelConverter::EncodeRGB565(rgba);
+    }
+    static void Blend(Pixel& dst, uint32_t src, uint8_t coverage, BlendMode mode)
+    {
+        dst = Store(Blender::BlendPixel(Load(dst), src, coverage, mode));
+    }
+};
+
+// 只保存 alpha：各混合模式对 alpha 的计算与颜色通道无关，借用 RGBA8888 的混合结果
+struct A8Format
+{
+    using Pixel = uint8_t;
+
+    static uint32_t Load(Pixel pixel)
+    {
+        return PixelConverter::DecodeA8(pixel);
+    }
+    static Pixel Store(uint32_t rgba)
+    {
+        return PixelConverter::EncodeA8(rgba);
+    }
+    static void Blend(Pixel& dst, uint32_t src, uint8_t coverage, BlendMode mode)
+    {
+        dst = Store(Blender::BlendPixel(Load(dst), src, coverage, mode));
+    }
+};
+
+struct Half4
+{
+    uint16_t c[4]; // R, G, B, A
+};
+
+// 以单精度计算混合，结果不截断到 [0, 1]（Additive 可以累加出大于 1 的 HDR 值）
+struct Rgba16fFormat
+{
+    using Pixel = Half4;
+
+    static uint32_t Load(Pixel pixel)
+    {
+        uint32_t rgba;
+        PixelConverter::ToRGBA8888(PixelFormat::RGBA16F, &pixel, &rgba, 1);
+        return rgba;
+    }
+    static Pixel Store(uint32_t rgba)
+    {
+        const Color color(rgba);
+        return Pixel{{PixelConverter::UnormToHalf(color.R()), PixelConverter::UnormToHalf(color.G()),
+                      PixelConverter::UnormToHalf(color.B()), PixelConverter::UnormToHalf(color.A())}};
+    }
+    static void Blend(Pixel& dst, uint32_t src, uint8_t coverage, BlendMode mode)
+    {
+        if (coverage == 0)
+        {
+            return;
+        }
+        const Color color(src);
+        const float t = static_cast<float>(coverage) * (1.0f / 255.0f);
+        float s[4] = {color.R() * (1.0f / 255.0f), color.G() * (1.0f / 255.0f), color.B() * (1.0f / 255.0f),
+                      color.A() * (1.0f / 255.0f)};
+        float d[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            d[i] = PixelConverter::HalfToFloat(dst.c[i]);
+        }
+        if (mode == BlendMode::Replace)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                dst.c[i] = PixelConverter::FloatToHalf(d[i] + (s[i] - d[i]) * t);
+            }
+            return;
+        }
+
+        for (float& channel : s)
+        {
+            channel *= t;
+        }
+        const float sa = s[3];
+        const float da = d[3];
+        for (int i = 0; i < 4; ++i)
+        {
+            float result;
+            switch (mode)
+            {
+            case BlendMode::Additive:
+                result = s[i] + d[i];
+                break;
+            case BlendMode::Multiply:
+                result = s[i] * d[i] + s[i] * (1.0f - da) + d[i] * (1.0f - sa);
+                break;
+            case BlendMode::Screen:
+                result = s[i] + d[i] - s[i] * d[i];
+                break;
+            case BlendMode::SrcOver:
+            default:
+                result = s[i] + d[i] * (1.0f - sa);
+                break;
+            }
+            dst.c[i] = PixelConverter::FloatToHalf(result);
+        }
+    }
+};
+
+/**
+ * @brief 按运行时格式调用 function(FormatTraits{})，行内循环按格式静态展开
+ */
+template <typename F>
+void DispatchFormat(PixelFormat format, F&& function)
+{
+    switch (format)
+    {
+    case PixelFormat::RGBA8888:
+        function(Rgba8888Format{});
+        break;
+    case PixelFormat::RGB565:
+        function(Rgb565Format{});
+        break;
+    case PixelFormat::A8:
+        function(A8Format{});
+        break;
+    case PixelFormat::RGBA16F:
+        function(Rgba16fFormat{});
+        break;
+    }
+}
+
+} // namespace
+
+FormatBuffer::FormatBuffer(int width, int height, PixelFormat format)
+    : _width(width), _height(height), _pitch(width * static_cast<int>(BytesPerPixel(format))), _format(format)
+{
+    assert(width > 0 && height > 0);
+    _data.resize(static_cast<size_t>(_pitch) * static_cast<size_t>(height));
+    Clear();
+}
+
+void FormatBuffer::Clear(const Color& color)
+{
+    const uint32_t value = Blender::Premultiply(color.ToUint32());
+    const size_t count = static_cast<size_t>(_width) * _height;
+    DispatchFormat(_format,
+                   [&](auto format)
+                   {
+                       using Format = decltype(format);
+                       auto* pixels = reinterpret_cast<typename Format::Pixel*>(_data.data());
+                       if constexpr (std::is_same_v<Format, Rgba8888Format>)
+                       {
+                           Blender::FillSpan(pixels, value, count);
+                       }
+                       else
+                       {
+                           std::fill(pixels, pixels + count, Format::Store(value));
+                       }
+                   });
+}
+
+Color FormatBuffer::GetPixel(int x, int y) const
+{
+    if (x < 0 || x >= _width || y < 0 || y >= _height)
+    {
+        return Color(0);
+    }
+    uint32_t rgba;
+    PixelConverter::ToRGBA8888(_format, Row(y) + static_cast<size_t>(x) * BytesPerPixel(_format), &rgba, 1);
+    return Color(rgba);
+}
+
+void FormatBuffer::FillSpan(int x, int y, int count, const Color& color)
+{
+    int offset;
+    if (!ClipSpan(x, y, count, offset))
+    {
+        return;
+    }
+    const uint32_t value = Blender::Premultiply(color.ToUint32());
+    const BlendMode mode = _blend_mode;
+    DispatchFormat(_format,
+                   [&](auto format)
+                   {
+                       using Format = decltype(format);
+                       auto* dst = reinterpret_cast<typename Format::Pixel*>(Row(y)) + x;
+                       if constexpr (std::is_same_v<Format, Rgba8888Format>)
+                       {
+                           Blender::BlendSolidSpan(dst, value, count, mode);
+                       }
+                       else if (mode == BlendMode::Replace)
+                       {
+                           std::fill(dst, dst + count, Format::Store(value));
+                       }
+                       else
+                       {
+                           for (int i = 0; i < count; ++i)
+                           {
+                               Format::Blend(dst[i], value, 255, mode);
+                           }
+                       }
+                   });
+}
+
+void FormatBuffer::BlendSpan(int x, int y, const uint32_t* premultiplied, int count)
+{
+    int offset;
+    if (!ClipSpan(x, y, count, offset))
+    {
+        return;
+    }
+    const uint32_t* src = premultiplied + offset;
+    const BlendMode mode = _blend_mode;
+    if (mode == BlendMode::Replace)
+    {
+        // 直接覆盖即格式转换
+        PixelConverter::FromRGBA8888(_format, src, Row(y) + static_cast<size_t>(x) * BytesPerPixel(_format),
+                                     static_cast<size_t>(count));
+        return;
+    }
+    DispatchFormat(_format,
+                   [&](auto format)
+                   {
+                       using Format = decltype(format);
+                       auto* dst = reinterpret_cast<typename Format::Pixel*>(Row(y)) + x;
+                       if constexpr (std::is_same_v<Format, Rgba8888Format>)
+                       {
+                           Blender::BlendSpan(dst, src, count, mode);
+                       }
+                       else
+                       {
+                           for (int i = 0; i < count; ++i)
+                           {
+                               Format::Blend(dst[i], src[i], 255, mode);
+                           }
+                       }
+                   });
+}
+
+void FormatBuffer::BlendCoverageSpan(int x, int y, uint32_t premultiplied, const uint8_t* coverage, int count)
+{
+    int offset;
+    if (!ClipSpan(x, y, count, offset))
+    {
+        return;
+    }
+    const uint8_t* mask = coverage + offset;
+    const BlendMode mode = _blend_mode;
+    DispatchFormat(_format,
+                   [&](auto format)
+                   {
+                       using Format = decltype(format);
+                       auto* dst = reinterpret_cast<typename Format::Pixel*>(Row(y)) + x;
+                       if constexpr (std::is_same_v<Format, Rgba8888Format>)
+                       {
+                           Blender::BlendMaskSpan(dst, premultiplied, mask, count, mode);
+                       }
+                       else
+                       {
+                           for (int i = 0; i < count; ++i)
+                           {
+                               if (mask[i] != 0)
+                               {
+                                   Format::Blend(dst[i], premultiplied, mask[i], mode);
+                               }
+                           }
+                       }
+                   });
+}
+
+void FormatBuffer::Resolve(const PixelsBuffer& source)
+{
+    Resolve(source, math::BoundingBox2i(0, 0, source.Width(), source.Height()));
+}
+
+void FormatBuffer::Resolve(const PixelsBuffer& source, const math::BoundingBox2i& rect)
+{
+    const int x0 = std::max(rect.MinX(), 0);
+    const int y0 = std::max(rect.MinY(), 0);
+    const int x1 = std::min({rect.MaxX(), _width, source.Width()});
+    const int y1 = std::min({rect.MaxY(), _height, source.Height()});
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+    const uint32_t* src = source.Pixels();
+    const size_t bytes_per_pixel = BytesPerPixel(_format);
+    for (int y = y0; y < y1; ++y)
+    {
+        PixelConverter::FromRGBA8888(_format, src + static_cast<size_t>(y) * source.Width() + x0,
+                                     Row(y) + static_cast<size_t>(x0) * bytes_per_pixel, static_cast<size_t>(x1 - x0));
+    }
+}
+
+void FormatBuffer::ExpandTo(PixelsBuffer& target) const
+{
+    const int width = std::min(_width, target.Width());
+    const int height = std::min(_height, target.Height());
+    uint32_t* dst = target.PixelsForRegion(0, 0, width, height);
+    for (int y = 0; y < height; ++y)
+    {
+        PixelConverter::ToRGBA8888(_format, Row(y), dst + static_cast<size_t>(y) * target.Width(),
+                                   static_cast<size_t>(width));
+    }
+}
+
+bool FormatBuffer::ClipSpan(int& x, int y, int& count, int& offset) const
+{
+    if (y < 0 || y >= _height)
+    {
+        return false;
+    }
+    const int x0 = std::max(x, 0);
+    const int x1 = std::min(x + count, _width);
+    if (x0 >= x1)
+    {
+        return false;
+    }
+    offset = x0 - x;
+    x = x0;
+    count = x1 - x0;
+    return true;
+}
@@ -0,0 +1,143 @@
+//
+// Created by admin on 2026/2/19.
+//
+
+#ifndef FORMAT_BUFFER_H
+#define FORMAT_BUFFER_H
+
+#include "blender.h"
+#include "color.h"
+#include "math/bounding_box.h"
+#include "pixel_format.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class PixelsBuffer;
+
+/**
+ * @brief 按像素格式存储的渲染目标
+ *
+ * PixelsBuffer 是光栅化使用的 RGBA8888 工作缓冲区；FormatBuffer 按指定格式保存像素，
+ * 用于不需要完整 RGBA8888 的场合：
+ *   - RGB565: 嵌入式显示的帧缓冲，每像素 2 字节，带宽减半
+ *   - A8:     遮罩和字形覆盖率，每像素 1 字节，带宽为四分之一
+ *   - RGBA16F: HDR 累加，Additive 混合不会在 1.0 处饱和
+ *
+ * 写入方式：
+ *   - 行接口（FillSpan / BlendSpan / BlendCoverageSpan）与 PixelsBuffer 同名同义，按格式分派到模板化的
+ *     逐像素内核，覆盖率光栅化器等只依赖行接口的代码可以直接绘制到任意格式（见 pri::CoverageRasterizer）
+ *   - Resolve 在呈现 / 解析时把 PixelsBuffer 的内容批量转换为本格式（SIMD 转换内核）
+ *
+ * 所有格式都保存预乘 alpha 的颜色，行接口的颜色参数与 PixelsBuffer 相同。
+ */
+class FormatBuffer
+{
+  public:
+    FormatBuffer(int width, int height, PixelFormat format);
+
+    int Width() const
+    {
+        return _width;
+    }
+    int Height() const
+    {
+        return _height;
+    }
+
+    /**
+     * @brief 每行字节数 = 宽度 * BytesPerPixel(Format())
+     */
+    int Pitch() const
+    {
+        return _pitch;
+    }
+
+    PixelFormat Format() const
+    {
+        return _format;
+    }
+
+    uint8_t* Data()
+    {
+        return _data.data();
+    }
+    const uint8_t* Data() const
+    {
+        return _data.data();
+    }
+
+    // 第 y 行的首地址
+    uint8_t* Row(int y)
+    {
+        return _data.data() + static_cast<size_t>(y) * _pitch;
+    }
+    const uint8_t* Row(int y) const
+    {
+        return _data.data() + static_cast<size_t>(y) * _pitch;
+    }
+
+    void SetBlendMode(BlendMode mode)
+    {
+        _blend_mode = mode;
+    }
+
+    BlendMode GetBlendMode() const
+    {
+        return _blend_mode;
+    }
+
+    // 清除缓冲区（颜色为直通 alpha，写入时转换为预乘后编码为本格式）
+    void Clear(const Color& color = Color::Transparent());
+
+    /**
+     * @brief 读取一个像素并转换为 RGBA8888（预乘），RGBA16F 超出 [0, 1] 的分量被截断
+     */
+    Color GetPixel(int x, int y) const;
+
+    /**
+     * @brief 按当前混合模式用纯色填充一行 [x, x + count)，自动裁剪到缓冲区
+     * @param color 颜色（直通 alpha）
+     */
+    void FillSpan(int x, int y, int count, const Color& color);
+
+    /**
+     * @brief 按当前混合模式将一行预乘 RGBA8888 像素写入 [x, x + count)，自动裁剪到缓冲区
+     */
+    void BlendSpan(int x, int y, const uint32_t* premultiplied, int count);
+
+    /**
+     * @brief 按当前混合模式和逐像素覆盖率将纯色写入 [x, x + count)，自动裁剪到缓冲区
+     * @param premultiplied 颜色（预乘 RGBA8888）
+     * @param coverage 覆盖率数组，coverage[0] 对应像素 x
+     */
+    void BlendCoverageSpan(int x, int y, uint32_t premultiplied, const uint8_t* coverage, int count);
+
+    /**
+     * @brief 把 source 转换为本格式（两者尺寸不同时只转换重叠部分）
+     */
+    void Resolve(const PixelsBuffer& source);
+
+    /**
+     * @brief 只转换 source 的矩形区域 rect（半开区间，如损坏区域跟踪得到的矩形）
+     */
+    void Resolve(const PixelsBuffer& source, const math::BoundingBox2i& rect);
+
+    /**
+     * @brief 把本缓冲区展开为 RGBA8888 写入 target（如把 HDR 累加结果或遮罩显示出来）
+     */
+    void ExpandTo(PixelsBuffer& target) const;
+
+  private:
+    // 把 [x, x + count) 裁剪到缓冲区，结果为空时返回 false
+    bool ClipSpan(int& x, int y, int& count, int& offset) const;
+
+    int _width;
+    int _height;
+    int _pitch;
+    PixelFormat _format;
+    BlendMode _blend_mode = BlendMode::Replace;
+    std::vector<uint8_t> _data;
+};
+
+#endif // FORMAT_BUFFER_H
@@ -0,0 +1,179 @@
+//
+// Created by admin on 2026/2/15.
+//
+
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+namespace
+{
+
+// 块按缓存行对齐，块内 64 字节以内的对齐只需对齐偏移
+constexpr size_t kBlockAlignment = 64;
+
+#ifdef FRAME_ARENA_TRACK_HEAP
+std::atomic<size_t> g_heap_allocations{0};
+#endif
+
+} // namespace
+
+#ifdef FRAME_ARENA_TRACK_HEAP
+// 替换全局 operator new 以统计每帧的堆分配次数（对齐版本与数组版本默认转发到这两个函数）
+void* operator new(size_t size)
+{
+    g_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+#endif
+
+FrameArena::FrameArena(size_t block_size) : _block_size(std::max(block_size, kBlockAlignment))
+{
+    _blocks.reserve(16);
+    _heap_mark = ProcessHeapAllocations();
+}
+
+FrameArena::~FrameArena()
+{
+    RunFinalizers(nullptr);
+    ReleaseBlocks();
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+    while (_current < _blocks.size())
+    {
+        const Block& block = _blocks[_current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        const uintptr_t aligned = (base + _offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        const size_t end = static_cast<size_t>(aligned - base) + size;
+        if (end <= block.size)
+        {
+            _offset = end;
+            _peak_used = std::max(_peak_used, _base + _offset);
+            return reinterpret_cast<void*>(aligned);
+        }
+        // 当前块放不下，剩余部分不再使用，换到下一个块
+        if (_current + 1 == _blocks.size())
+        {
+            break;
+        }
+        _base += block.size;
+        _offset = 0;
+        ++_current;
+    }
+
+    if (!_blocks.empty())
+    {
+        _base += _blocks[_current].size;
+        _current = _blocks.size();
+    }
+    AddBlock(std::max(_block_size, size + alignment));
+    _offset = 0;
+    return Allocate(size, alignment);
+}
+
+void FrameArena::Rewind(const Marker& marker)
+{
+    RunFinalizers(marker.finalizers);
+    if (_blocks.empty())
+    {
+        return;
+    }
+    while (_current > marker.block)
+    {
+        --_current;
+        _base -= _blocks[_current].size;
+    }
+    _offset = marker.offset;
+}
+
+void FrameArena::Reset()
+{
+    RunFinalizers(nullptr);
+
+    _last_frame.bytes_used = _peak_used;
+    _last_frame.block_allocations = _block_allocations;
+
+    // 一帧用到了多个块时合并成一个，下一帧同样的用量只需一个块
+    if (_blocks.size() > 1)
+    {
+        const size_t total = _capacity;
+        ReleaseBlocks();
+        AddBlock(total);
+    }
+    _last_frame.capacity = _capacity;
+
+    const size_t heap = ProcessHeapAllocations();
+    _last_frame.heap_allocations = heap - _heap_mark;
+    _heap_mark = heap;
+
+    _current = 0;
+    _offset = 0;
+    _base = 0;
+    _peak_used = 0;
+    _block_allocations = 0;
+}
+
+size_t FrameArena::ProcessHeapAllocations()
+{
+#ifdef FRAME_ARENA_TRACK_HEAP
+    return g_heap_allocations.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+void FrameArena::RegisterFinalizer(void* object, void (*destroy)(void*))
+{
+    auto* finalizer = static_cast<Finalizer*>(Allocate(sizeof(Finalizer), alignof(Finalizer)));
+    finalizer->destroy = destroy;
+    finalizer->object = object;
+    finalizer->next = _finalizers;
+    _finalizers = finalizer;
+}
+
+void FrameArena::RunFinalizers(void* until)
+{
+    while (_finalizers != nullptr && _finalizers != until)
+    {
+        Finalizer* finalizer = _finalizers;
+        _finalizers = finalizer->next;
+        finalizer->destroy(finalizer->object);
+    }
+}
+
+void FrameArena::AddBlock(size_t size)
+{
+    size = (size + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+    auto* data = static_cast<std::byte*>(::operator new(size, std::align_val_t{kBlockAlignment}));
+    _blocks.push_back({data, size});
+    _capacity += size;
+    ++_block_allocations;
+}
+
+void FrameArena::ReleaseBlocks()
+{
+    for (const Block& block : _blocks)
+    {
+        ::operator delete(block.data, std::align_val_t{kBlockAlignment});
+    }
+    _blocks.clear();
+    _capacity = 0;
+}
@@ -0,0 +1,213 @@
+//
+// Created by admin on 2026/2/15.
+//
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 帧内线性分配器（arena）
+ *
+ * 临时图元、命令记录和扫描线缓冲等只在一帧内有效的对象从这里按指针递增分配，
+ * 帧结束时 Reset 一次性回收（O(1)，不逐个释放）：
+ *   - 内存按块申请，一帧用了多个块时，Reset 会把它们合并成一个足够大的块，
+ *     之后的帧在稳定状态下不再向堆申请内存
+ *   - 非平凡析构的对象由 New 登记析构函数，Reset / Rewind 时按构造的逆序调用
+ *   - Scope 在作用域结束时回退到进入时的位置，用于图元绘制时借用的临时缓冲
+ *
+ * 只能在一个线程中使用。
+ */
+class FrameArena
+{
+  public:
+    static constexpr size_t kDefaultBlockSize = size_t{1} << 20;
+
+    /**
+     * @brief 帧统计
+     */
+    struct Stats
+    {
+        size_t bytes_used = 0;        // 本帧分配的峰值字节数
+        size_t capacity = 0;          // 当前持有的内存总量
+        size_t block_allocations = 0; // 本帧 arena 自身向堆申请内存块的次数
+        size_t heap_allocations = 0;  // 本帧整个进程的堆分配次数（仅在开启 FRAME_ARENA_TRACK_HEAP 时统计）
+    };
+
+    /**
+     * @brief 分配位置，用于回退
+     */
+    struct Marker
+    {
+        size_t block = 0;
+        size_t offset = 0;
+        void* finalizers = nullptr;
+    };
+
+    /**
+     * @brief 作用域内的临时分配，析构时回退到进入时的位置（arena 为空时不做任何事）
+     */
+    class Scope
+    {
+      public:
+        explicit Scope(FrameArena* arena) : _arena(arena)
+        {
+            if (_arena)
+            {
+                _marker = _arena->GetMarker();
+            }
+        }
+
+        ~Scope()
+        {
+            if (_arena)
+            {
+                _arena->Rewind(_marker);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        FrameArena* _arena;
+        Marker _marker;
+    };
+
+    explicit FrameArena(size_t block_size = kDefaultBlockSize);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * @brief 分配未初始化的内存
+     * @param alignment 对齐字节数，必须是 2 的幂
+     */
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief 分配 count 个未初始化的 T（只用于平凡类型）
+     */
+    template <typename T>
+    T* AllocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "AllocateArray requires a trivially destructible type");
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief 在 arena 中构造一个对象，非平凡析构的对象会在 Reset / Rewind 时析构
+     */
+    template <typename T, typename... Args>
+    T* New(Args&&... args)
+    {
+        void* memory = Allocate(sizeof(T), alignof(T));
+        T* object = ::new (memory) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            RegisterFinalizer(object, [](void* p) { static_cast<T*>(p)->~T(); });
+        }
+        return object;
+    }
+
+    [[nodiscard]] Marker GetMarker() const
+    {
+        return {_current, _offset, _finalizers};
+    }
+
+    /**
+     * @brief 回退到之前的位置，析构其后构造的对象
+     */
+    void Rewind(const Marker& marker);
+
+    /**
+     * @brief 帧结束：析构全部对象并回收全部内存，更新帧统计
+     */
+    void Reset();
+
+    [[nodiscard]] size_t BytesUsed() const
+    {
+        return _base + _offset;
+    }
+
+    [[nodiscard]] size_t Capacity() const
+    {
+        return _capacity;
+    }
+
+    /**
+     * @brief 上一帧（最近一次 Reset 之前）的统计
+     */
+    [[nodiscard]] const Stats& LastFrameStats() const
+    {
+        return _last_frame;
+    }
+
+    /**
+     * @brief 进程启动以来的堆分配次数，未开启 FRAME_ARENA_TRACK_HEAP 时恒为 0
+     */
+    static size_t ProcessHeapAllocations();
+
+    static constexpr bool TracksProcessHeap()
+    {
+#ifdef FRAME_ARENA_TRACK_HEAP
+        return true;
+#else
+        return false;
+#endif
+    }
+
+  private:
+    struct Block
+    {
+        std::byte* data;
+        size_t size;
+    };
+
+    struct Finalizer
+    {
+        void (*destroy)(void*);
+        void* object;
+        Finalizer* next;
+    };
+
+    void RegisterFinalizer(void* object, void (*destroy)(void*));
+    void RunFinalizers(void* until);
+    void AddBlock(size_t size);
+    void ReleaseBlocks();
+
+    std::vector<Block> _blocks;
+    size_t _block_size;
+    size_t _current = 0; // 当前块下标
+    size_t _offset = 0;  // 当前块内已用字节
+    size_t _base = 0;    // 当前块之前所有块的总字节数
+    size_t _capacity = 0;
+    size_t _peak_used = 0;
+    Finalizer* _finalizers = nullptr; // 按构造逆序链接
+    size_t _block_allocations = 0;
+    size_t _heap_mark = 0;
+    Stats _last_frame;
+};
+
+/**
+ * @brief 借用 count 个 T 的临时缓冲：优先从 arena 分配（调用方应先建立 Scope），arena 为空时使用 fallback
+ */
+template <typename T>
+T* ScratchArray(FrameArena* arena, size_t count, std::vector<T>& fallback)
+{
+    if (arena)
+    {
+        return arena->AllocateArray<T>(count);
+    }
+    fallback.resize(count);
+    return fallback.data();
+}
+
+#endif // FRAME_ARENA_H
@@ -5,55 +5,320 @@
 #include "graphics_renderer.h"
 #include "color.h"
 #include "primitive/line_primitive.h"
+#include <algorithm>
 #include <cmath>
 
-GraphicsRenderer::GraphicsRenderer(PixelsBuffer& buffer) : _buffer(buffer) {}
+namespace
+{
+
+// 两个半开矩形的交集
+math::BoundingBox2i Intersect(const math::BoundingBox2i& a, const math::BoundingBox2i& b)
+{
+    return math::BoundingBox2i(std::max(a.MinX(), b.MinX()), std::max(a.MinY(), b.MinY()),
+                               std::min(a.MaxX(), b.MaxX()), std::min(a.MaxY(), b.MaxY()));
+}
+
+bool IsEmpty(const math::BoundingBox2i& rect)
+{
+    return rect.MinX() >= rect.MaxX() || rect.MinY() >= rect.MaxY();
+}
+
+} // namespace
+
+GraphicsRenderer::GraphicsRenderer(PixelsBuffer& buffer) : _screen(buffer), _buffer(&buffer)
+{
+    _screen.SetFrameArena(&_arena);
+    _damage.SetExtent(_screen.Width(), _screen.Height());
+    _immediate_damage.SetExtent(_screen.Width(), _screen.Height());
+}
+
+void GraphicsRenderer::PushRenderTarget(RenderTarget& target)
+{
+    PixelsBuffer& buffer = target.Buffer();
+    buffer.SetFrameArena(&_arena);
+    buffer.SetBlendMode(_buffer->GetBlendMode());
+    buffer.ResetClipRect();
+    _target_stack.push_back(_buffer);
+    _buffer = &buffer;
+}
+
+void GraphicsRenderer::PopRenderTarget()
+{
+    if (_target_stack.empty())
+    {
+        return;
+    }
+    PixelsBuffer* previous = _target_stack.back();
+    _target_stack.pop_back();
+    // 离屏目标可能比渲染器先销毁，弹出后不再引用帧内分配器
+    _buffer->SetFrameArena(nullptr);
+    previous->SetBlendMode(_buffer->GetBlendMode());
+    _buffer = previous;
+}
 
 void GraphicsRenderer::Clear(const Color& color)
 {
-    _buffer.Clear(color);
+    _buffer->Clear(color);
+    if (IsOffscreen())
+    {
+        return;
+    }
+    if (_msaa)
+    {
+        _msaa->Clear();
+    }
+    if (_damage_tracking)
+    {
+        _damage.AddAll();
+    }
+}
+
+void GraphicsRenderer::PushClipRect(const math::BoundingBox2i& rect)
+{
+    const math::BoundingBox2i current = _buffer->ClipRect();
+    _clip_stack.push_back({_buffer, current});
+    _buffer->SetClipRect(rect.IsValid() ? Intersect(rect, current) : rect);
+    _commands.SetClipRect(_buffer->ClipRect());
+}
+
+void GraphicsRenderer::PopClipRect()
+{
+    if (_clip_stack.empty())
+    {
+        return;
+    }
+    const ClipState state = _clip_stack.back();
+    _clip_stack.pop_back();
+    state.buffer->SetClipRect(state.previous);
+    if (_clip_stack.empty())
+    {
+        _commands.ResetClipRect();
+    }
+    else
+    {
+        _commands.SetClipRect(state.previous);
+    }
+}
+
+void GraphicsRenderer::SetStencilEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        _commands.SetStencilTest(StencilFunc::Always, 0);
+        _screen.SetStencil(nullptr);
+        _stencil.reset();
+        _stencil_scratch.reset();
+        return;
+    }
+    if (!_stencil)
+    {
+        _stencil = std::make_unique<StencilBuffer>(_screen.Width(), _screen.Height());
+        _screen.SetStencil(_stencil.get());
+        _commands.SetStencilTest(StencilFunc::Always, 0);
+    }
+}
+
+void GraphicsRenderer::ClearStencil(uint8_t value)
+{
+    if (_stencil)
+    {
+        _stencil->Clear(value);
+    }
+}
+
+void GraphicsRenderer::DrawToStencil(const pri::IPrimitive& shape, uint8_t value, StencilOp op)
+{
+    if (!_stencil)
+    {
+        return;
+    }
+    const math::BoundingBox2i region = Intersect(shape.Bounds(), _screen.ClipRect());
+    if (IsEmpty(region))
+    {
+        return;
+    }
+    if (!_stencil_scratch)
+    {
+        _stencil_scratch = std::make_unique<RenderTarget>(_screen.Width(), _screen.Height());
+    }
+    // 暂存目标只在图元的包围盒内清除和绘制，图元按 SrcOver 叠加在透明背景上得到覆盖率
+    PixelsBuffer& scratch = _stencil_scratch->Buffer();
+    scratch.ClearRect(region.MinX(), region.MinY(), region.Width(), region.Height());
+    scratch.SetClipRect(region);
+    scratch.SetBlendMode(BlendMode::SrcOver);
+    scratch.SetFrameArena(&_arena);
+    shape.Draw(scratch);
+    scratch.SetFrameArena(nullptr);
+    _stencil->WriteMask(scratch, region, value, op);
+}
+
+void GraphicsRenderer::FillStencilRect(const math::BoundingBox2i& rect, uint8_t value, StencilOp op)
+{
+    if (!_stencil || !rect.IsValid())
+    {
+        return;
+    }
+    const math::BoundingBox2i region = Intersect(rect, _screen.ClipRect());
+    _stencil->FillRect(region.MinX(), region.MinY(), region.MaxX(), region.MaxY(), value, op);
+}
+
+void GraphicsRenderer::SetStencilTest(StencilFunc func, uint8_t reference)
+{
+    if (_stencil)
+    {
+        _stencil->SetTest(func, reference);
+        _commands.SetStencilTest(func, reference);
+    }
+}
+
+void GraphicsRenderer::SetDamageTracking(bool enabled)
+{
+    _damage_tracking = enabled;
+    _damage.Clear();
+    _immediate_damage.Clear();
+    if (enabled)
+    {
+        _damage.AddAll();
+    }
+}
+
+void GraphicsRenderer::AddDamage(const math::BoundingBox2i& rect)
+{
+    if (_damage_tracking)
+    {
+        _damage.Add(rect);
+    }
+}
+
+void GraphicsRenderer::AddImmediateDamage(const math::BoundingBox2i& rect)
+{
+    // 裁剪矩形之外的像素不会被写入，不计入损坏区域
+    const math::BoundingBox2i clipped = Intersect(rect, _screen.ClipRect());
+    if (!rect.IsValid() || IsEmpty(clipped))
+    {
+        return;
+    }
+    _damage.Add(clipped);
+    _immediate_damage.Add(clipped);
+}
+
+void GraphicsRenderer::RedrawDamaged(const Color& background)
+{
+    if (!TracksDamage())
+    {
+        Clear(background);
+        DrawAllPrimitives();
+        return;
+    }
+
+    _primitives.CollectDamage(_damage);
+    if (_damage.Empty())
+    {
+        return;
+    }
+    // MSAA 的边缘样本只能整体清除
+    if (_msaa)
+    {
+        _damage.AddAll();
+    }
+    _primitives.ExpandDamage(_damage);
+
+    if (_damage.IsFull())
+    {
+        _screen.Clear(background);
+        if (_msaa)
+        {
+            _msaa->Clear();
+        }
+    }
+    else
+    {
+        for (const auto& rect : _damage.Rects())
+        {
+            _screen.ClearRect(rect.MinX(), rect.MinY(), rect.Width(), rect.Height(), background);
+        }
+    }
+    _primitives.DrawDamaged(_screen, _damage);
+}
+
+void GraphicsRenderer::SetMultisample(int samples)
+{
+    if (samples <= 1)
+    {
+        _msaa.reset();
+        _screen.SetMultisample(nullptr);
+        return;
+    }
+    if (_msaa && _msaa->Samples() == samples)
+    {
+        return;
+    }
+    // 切换样本数前先把已有样本解析到缓冲区
+    Resolve();
+    _msaa = std::make_unique<MsaaBuffer>(_screen.Width(), _screen.Height(), samples);
+    _screen.SetMultisample(_msaa.get());
+}
+
+void GraphicsRenderer::Resolve()
+{
+    if (_msaa)
+    {
+        _msaa->Resolve(_screen);
+    }
+}
+
+void GraphicsRenderer::EndFrame()
+{
+    _arena.Reset();
+    // 本帧立即绘制的内容在下一帧被擦除
+    _damage.Clear();
+    _damage.Merge(_immediate_damage);
+    _immediate_damage.Clear();
 }
 
 void GraphicsRenderer::Draw(const pri::IPrimitive& primitive)
 {
-    primitive.Draw(_buffer);
+    if (TracksDamage())
+    {
+        AddImmediateDamage(primitive.Bounds());
+    }
+    primitive.Draw(*_buffer);
 }
 
 void GraphicsRenderer::DrawPoint(int x, int y, const Color& color)
 {
-    pri::PointPrimitive point(x, y, color);
-    point.Draw(_buffer);
+    DrawImmediate(pri::PointPrimitive(x, y, color));
 }
 
 void GraphicsRenderer::DrawPoint(const pri::PointPrimitive& point)
 {
-    point.Draw(_buffer);
+    DrawImmediate(point);
 }
 
 void GraphicsRenderer::DrawLine(int x1, int y1, int x2, int y2, const Color& color)
 {
     // 使用 LinePrimitive 来绘制直线
     pri::LinePrimitive line(x1, y1, x2, y2, color);
-    line.Draw(_buffer);
+    DrawImmediate(line);
 }
 
 void GraphicsRenderer::DrawLine(const pri::PointPrimitive& start, const pri::PointPrimitive& end)
 {
     pri::LinePrimitive line(start, end);
-    line.Draw(_buffer);
+    DrawImmediate(line);
 }
 
 void GraphicsRenderer::DrawAntialiasedLine(int x1, int y1, int x2, int y2, const Color& color)
 {
     // 使用 LinePrimitive 并启用抗锯齿来绘制直线
     pri::LinePrimitive line(x1, y1, x2, y2, color, true);
-    line.Draw(_buffer);
+    DrawImmediate(line);
 }
 
 void GraphicsRenderer::DrawAntialiasedLine(const pri::PointPrimitive& start, const pri::PointPrimitive& end)
 {
     pri::LinePrimitive line(start, end, true);
-    line.Draw(_buffer);
+    DrawImmediate(line);
 }
 
 void GraphicsRenderer::DrawPoint(const math::Point2i& point, const Color& color)
@@ -94,8 +359,9 @@ void GraphicsRenderer::DrawAntialiasedLine(const math::Point2i& start, const mat
 
 void GraphicsRenderer::DrawAntialiasedLine(const math::Point2f& start, const math::Point2f& end, const Color& color)
 {
-    DrawAntialiasedLine(static_cast<int>(std::round(start.X())), static_cast<int>(std::round(start.Y())),
-                        static_cast<int>(std::round(end.X())), static_cast<int>(std::round(end.Y())), color);
+    // 保留浮点端点，Wu 算法按亚像素位置计算覆盖率
+    pri::LinePrimitive line(start, end, color, true);
+    DrawImmediate(line);
 }
 
 void GraphicsRenderer::DrawAntialiasedLine(const math::Line2i& line, const Color& color)
@@ -112,35 +378,145 @@ void GraphicsRenderer::DrawImage(std::shared_ptr<image::Image> image)
 {
     if (!image)
         return;
-    int offset_y = image->Position().Y();
-    int offset_x = image->Position().X();
-    int limit_y = image->Height() + offset_y;
-    int limit_x = image->Width() + offset_x;
+    DrawImage(*image, image->Position().X(), image->Position().Y());
+}
+
+void GraphicsRenderer::DrawImage(const image::Image& image, int x, int y)
+{
+    DrawImage(image, math::Affine2f::Translation(static_cast<float>(x), static_cast<float>(y)), ImageFilter::Nearest);
+}
 
-    for (int j = offset_y; j < limit_y; j++)
+void GraphicsRenderer::DrawImage(const image::Image& image, const math::Affine2f& transform, ImageFilter filter)
+{
+    if (!image.IsValid())
+        return;
+    const math::BoundingBox2i bounds = ImageBlitter::Bounds(image.Width(), image.Height(), transform);
+    if (TracksDamage())
+    {
+        AddImmediateDamage(bounds);
+    }
+    // 行暂存只需覆盖包围盒与裁剪矩形相交的列
+    const int count = std::min(bounds.MaxX(), _buffer->ClipMaxX()) - std::max(bounds.MinX(), _buffer->ClipMinX());
+    if (count <= 0)
+    {
+        return;
+    }
+    FrameArena::Scope scope(&_arena);
+    uint32_t* scratch = _arena.AllocateArray<uint32_t>(static_cast<size_t>(count));
+    const ImageBlitter::Source source{image.Pixels().data(), image.Width(), image.Height(), image.Width(),
+                                      image.IsPremultiplied()};
+    ImageBlitter::Blit(*_buffer, source, transform, filter, bounds, scratch);
+}
+
+void GraphicsRenderer::DrawRenderTarget(const RenderTarget& source, int x, int y, uint8_t opacity,
+                                        const math::BoundingBox2i& clip)
+{
+    if (opacity == 0 || &source.Buffer() == _buffer)
+    {
+        return;
+    }
+    // 目标区域 = 源矩形 ∩ clip ∩ 当前目标的裁剪矩形
+    int x0 = std::max(x, _buffer->ClipMinX());
+    int y0 = std::max(y, _buffer->ClipMinY());
+    int x1 = std::min(x + source.Width(), _buffer->ClipMaxX());
+    int y1 = std::min(y + source.Height(), _buffer->ClipMaxY());
+    if (clip.IsValid())
+    {
+        x0 = std::max(x0, clip.MinX());
+        y0 = std::max(y0, clip.MinY());
+        x1 = std::min(x1, clip.MaxX());
+        y1 = std::min(y1, clip.MaxY());
+    }
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+    if (TracksDamage())
+    {
+        AddImmediateDamage(math::BoundingBox2i(x0, y0, x1, y1));
+    }
+
+    const int width = x1 - x0;
+    const PixelsBuffer& src = source.Buffer();
+    const uint32_t* src_pixels = src.Pixels();
+    uint32_t* dst_pixels = _buffer->PixelsForRegion(x0, y0, x1, y1);
+    const BlendMode mode = _buffer->GetBlendMode();
+
+    FrameArena::Scope scope(&_arena);
+    uint32_t* scratch = opacity == 255 ? nullptr : _arena.AllocateArray<uint32_t>(width);
+    for (int row = y0; row < y1; ++row)
     {
-        for (int i = offset_x; i < limit_x; i++)
+        const uint32_t* src_row = src_pixels + static_cast<size_t>(row - y) * src.Width() + (x0 - x);
+        if (scratch)
         {
-            const Color color = image->GetPixel(i - offset_x, j - offset_y);
-            _buffer.SetPixel(i, j, color);
+            Blender::ScaleSpan(scratch, src_row, width, opacity);
+            src_row = scratch;
         }
+        uint32_t* dst_row = dst_pixels + static_cast<size_t>(row) * _buffer->Width();
+        _buffer->ForEachWritableRun(row, x0, x1, [&](int begin, int end) {
+            Blender::BlendSpan(dst_row + begin, src_row + (begin - x0), end - begin, mode);
+        });
     }
 }
 
-void GraphicsRenderer::AddPrimitive(std::unique_ptr<pri::IPrimitive> primitive)
+void GraphicsRenderer::SetCommandListCount(size_t count)
 {
-    _primitives.push_back(std::move(primitive));
+    // 每个列表单独分配，避免不同线程写入的数据落在同一缓存行
+    _command_lists.resize(count);
+    for (auto& list : _command_lists)
+    {
+        if (!list)
+        {
+            list = std::make_unique<CommandBuffer>();
+        }
+        list->Clear();
+    }
+}
+
+void GraphicsRenderer::SubmitCommands()
+{
+    for (auto& list : _command_lists)
+    {
+        _commands.Append(*list);
+        list->Clear();
+    }
+    if (TracksDamage())
+    {
+        _commands.CollectDamage(_damage);
+        _commands.CollectDamage(_immediate_damage);
+    }
+    _commands.Submit(*this);
+}
+
+pri::PrimitiveHandle GraphicsRenderer::AddPrimitive(std::unique_ptr<pri::IPrimitive> primitive, uint64_t sort_key)
+{
+    if (!primitive)
+    {
+        return {};
+    }
+    return _primitives.Add(std::move(primitive), sort_key);
+}
+
+bool GraphicsRenderer::RemovePrimitive(pri::PrimitiveHandle handle)
+{
+    return _primitives.Remove(handle, _damage_tracking ? &_damage : nullptr);
 }
 
 void GraphicsRenderer::ClearPrimitives()
 {
-    _primitives.clear();
+    _primitives.Clear();
+    if (_damage_tracking)
+    {
+        _damage.AddAll();
+    }
 }
 
 void GraphicsRenderer::DrawAllPrimitives()
 {
-    for (const auto& primitive : _primitives)
+    if (TracksDamage())
     {
-        primitive->Draw(_buffer);
+        // 全部重绘时同步各图元的已绘制包围盒，之后可以切换到 RedrawDamaged
+        _primitives.CollectDamage(_damage);
     }
-}
\ No newline at end of file
+    _primitives.Draw(*_buffer);
+}
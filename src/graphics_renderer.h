@@ -5,25 +5,198 @@
 #ifndef GRAPHICS_RENDERER_H
 #define GRAPHICS_RENDERER_H
 
+#include "blender.h"
 #include "color.h"
+#include "command_buffer.h"
+#include "damage_tracker.h"
+#include "frame_arena.h"
 #include "image/image.h"
+#include "image_blitter.h"
+#include "math/affine.h"
 #include "math/line.h"
 #include "math/point.h"
+#include "msaa_buffer.h"
 #include "pixels_buffer.h"
 #include "primitive/point_primitive.h"
 #include "primitive/primitive.h"
+#include "primitive/primitive_store.h"
+#include "render_target.h"
+#include "stencil_buffer.h"
+#include <concepts>
 #include <memory>
 #include <vector>
 
 class GraphicsRenderer
 {
   public:
-    // 构造函数，接受像素缓冲区引用
+    // 构造函数，接受像素缓冲区（屏幕）引用
     explicit GraphicsRenderer(PixelsBuffer& buffer);
 
-    // 清空缓冲区（填充指定颜色）
+    /**
+     * @brief 把之后的绘制重定向到离屏渲染目标（可嵌套），PopRenderTarget 恢复之前的目标
+     *
+     * 绑定期间立即绘制、命令提交和保留模式图元都绘制到 target，混合模式沿用当前的设置；
+     * 离屏绘制不计入屏幕的损坏区域，也不使用 MSAA 和模板平面。target 的裁剪矩形重置为整个目标，
+     * 绑定期间压入的裁剪矩形应在弹出目标之前弹出。target 在弹出之前必须有效。
+     */
+    void PushRenderTarget(RenderTarget& target);
+    void PopRenderTarget();
+
+    /**
+     * @brief 当前是否绑定了离屏渲染目标
+     */
+    [[nodiscard]] bool IsOffscreen() const
+    {
+        return _buffer != &_screen;
+    }
+
+    // 清空缓冲区（填充指定颜色，不受裁剪矩形和模板测试影响）
     void Clear(const Color& color = Color::Black());
 
+    /**
+     * @brief 压入裁剪矩形（当前目标坐标，半开区间），与栈顶的裁剪矩形求交后生效，PopClipRect 恢复
+     *
+     * 裁剪矩形保存在当前目标的像素缓冲区中，光栅化器计算图元的行 / 列范围时直接与它求交，
+     * 矩形之外的像素不做扫描转换，裁剪没有逐像素的开销。立即绘制、SubmitCommands 和保留模式图元
+     * 都按绘制时的裁剪矩形裁剪（Commands() 记录的命令保存录制时的裁剪矩形，命令列表需用
+     * CommandBuffer::SetClipRect 显式设置）；损坏区域也只记录裁剪后的部分。
+     * 典型用法是滚动面板：压入面板的可见区域，按滚动偏移绘制内容，再弹出。
+     */
+    void PushClipRect(const math::BoundingBox2i& rect);
+    void PopClipRect();
+
+    /**
+     * @brief 当前目标的裁剪矩形（没有压入时为整个目标）
+     */
+    [[nodiscard]] math::BoundingBox2i ClipRect() const
+    {
+        return _buffer->ClipRect();
+    }
+
+    /**
+     * @brief 开启 / 关闭屏幕的 8 位模板平面（默认关闭），开启时模板值全部为 0，测试函数为 Always
+     */
+    void SetStencilEnabled(bool enabled);
+
+    [[nodiscard]] bool IsStencilEnabled() const
+    {
+        return _stencil != nullptr;
+    }
+
+    /**
+     * @brief 把整个模板平面设为 value（模板平面未开启时无操作）
+     */
+    void ClearStencil(uint8_t value = 0);
+
+    /**
+     * @brief 把图元覆盖的像素写入模板平面，不修改颜色（模板平面未开启时无操作）
+     *
+     * 图元先绘制到与屏幕同尺寸的暂存目标中（只清除和绘制它的包围盒与裁剪矩形的交集），
+     * 覆盖后 alpha >= 128 的像素按 op 修改模板值，因此图元应使用不透明的颜色。
+     * 任意形状的图元（圆、圆角矩形、多边形、路径等）都可以作为遮罩。
+     */
+    void DrawToStencil(const pri::IPrimitive& shape, uint8_t value, StencilOp op = StencilOp::Replace);
+
+    /**
+     * @brief 按 op 修改矩形区域（与裁剪矩形求交）的模板值
+     */
+    void FillStencilRect(const math::BoundingBox2i& rect, uint8_t value, StencilOp op = StencilOp::Replace);
+
+    /**
+     * @brief 设置模板测试：之后绘制到屏幕的像素只有通过测试时才写入
+     *
+     * 测试按扫描线片段执行：span 先按模板值拆分成连续通过的片段再整段混合。
+     * StencilFunc::Always 关闭测试。模板平面未开启时无操作。
+     */
+    void SetStencilTest(StencilFunc func, uint8_t reference);
+
+    /**
+     * @brief 设置混合模式，之后绘制的所有图元都按该模式与帧缓冲混合
+     * @param mode 混合模式（默认 Replace）
+     */
+    void SetBlendMode(BlendMode mode)
+    {
+        _buffer->SetBlendMode(mode);
+    }
+
+    [[nodiscard]] BlendMode GetBlendMode() const
+    {
+        return _buffer->GetBlendMode();
+    }
+
+    /**
+     * @brief 设置多重采样抗锯齿（只作用于三角形边缘）
+     * @param samples 每像素样本数：4 或 8，小于等于 1 表示关闭
+     */
+    void SetMultisample(int samples);
+
+    [[nodiscard]] int GetMultisample() const
+    {
+        return _msaa ? _msaa->Samples() : 1;
+    }
+
+    /**
+     * @brief 将 MSAA 边缘样本解析到像素缓冲区，应在呈现前调用（未开启 MSAA 时无操作）
+     */
+    void Resolve();
+
+    /**
+     * @brief 帧内分配器：临时图元、命令记录和扫描线缓冲从这里分配，EndFrame 时整体回收
+     */
+    FrameArena& Arena()
+    {
+        return _arena;
+    }
+
+    /**
+     * @brief 结束一帧（呈现之后调用）：回收帧内分配器中的全部对象，并记录本帧的分配统计
+     */
+    void EndFrame();
+
+    /**
+     * @brief 上一帧的分配统计，稳定状态下 block_allocations 与 heap_allocations 应为 0
+     */
+    [[nodiscard]] const FrameArena::Stats& LastFrameStats() const
+    {
+        return _arena.LastFrameStats();
+    }
+
+    /**
+     * @brief 开启 / 关闭损坏区域跟踪（默认关闭）
+     *
+     * 开启后渲染器记录每帧改变了的像素区域（Damage），呈现时只上传这些区域：
+     *   - 保留模式图元：RedrawDamaged 比较每个图元上次绘制的包围盒，只清除并重绘变化的区域
+     *   - 立即绘制的内容（Draw*、命令缓冲区）：本帧计入损坏区域，下一帧再计入一次以便被擦除，
+     *     即开启跟踪后立即绘制的内容视为每帧重新绘制的覆盖层，应在 RedrawDamaged 之后绘制
+     *   - Clear 使整个屏幕损坏
+     * 开启时整个屏幕标记为损坏。
+     */
+    void SetDamageTracking(bool enabled);
+
+    [[nodiscard]] bool IsDamageTracking() const
+    {
+        return _damage_tracking;
+    }
+
+    /**
+     * @brief 手动把一个区域（半开区间）标记为损坏，例如直接修改了像素缓冲区
+     */
+    void AddDamage(const math::BoundingBox2i& rect);
+
+    /**
+     * @brief 本帧的损坏区域（EndFrame 时重置）
+     */
+    [[nodiscard]] const DamageTracker& Damage() const
+    {
+        return _damage;
+    }
+
+    /**
+     * @brief 重绘保留模式图元：开启损坏区域跟踪时只清除并重绘损坏的区域，否则清除整个屏幕后全部重绘
+     * @param background 背景色
+     */
+    void RedrawDamaged(const Color& background = Color::Black());
+
     void Draw(const pri::IPrimitive& primitive);
 
     // 直接绘制函数（立即绘制到缓冲区）
@@ -49,24 +222,157 @@ class GraphicsRenderer
 
     void DrawImage(std::shared_ptr<image::Image> image);
 
-    // 图元管理
-    void AddPrimitive(std::unique_ptr<pri::IPrimitive> primitive);
+    /**
+     * @brief 绘制图像，左上角位于 (x, y)（忽略图像自身的位置）
+     */
+    void DrawImage(const image::Image& image, int x, int y);
+
+    /**
+     * @brief 按仿射变换（图像坐标 -> 目标坐标，可旋转、缩放、错切）绘制图像（忽略图像自身的位置）
+     *
+     * 只遍历变换后包围盒与裁剪矩形的交集，每行以 16.16 定点增量计算源坐标，见 ImageBlitter。
+     * 整数平移时与 DrawImage(image, x, y) 相同，逐行直接混合。
+     */
+    void DrawImage(const image::Image& image, const math::Affine2f& transform,
+                   ImageFilter filter = ImageFilter::Bilinear);
+
+    /**
+     * @brief 把离屏渲染目标按当前混合模式合成到当前目标，左上角位于 (x, y)
+     * @param opacity 不透明度 [0, 255]，源像素先整体乘以 opacity / 255
+     * @param clip 裁剪矩形（当前目标坐标，半开区间），无效矩形表示不裁剪
+     */
+    void DrawRenderTarget(const RenderTarget& source, int x, int y, uint8_t opacity = 255,
+                          const math::BoundingBox2i& clip = {});
+
+    /**
+     * @brief 命令缓冲区：通过它记录的绘制命令在 SubmitCommands 时排序合批后统一绘制
+     *
+     * 它的裁剪矩形和模板测试随 PushClipRect / PopClipRect / SetStencilTest 同步，命令按录制时的状态绘制；
+     * 对它调用 CommandBuffer::Begin 会把这两项一起重置。
+     */
+    CommandBuffer& Commands()
+    {
+        return _commands;
+    }
+
+    /**
+     * @brief 设置供并行任务录制的命令列表个数（应在录制开始前调用，会丢弃列表中已有的命令）
+     */
+    void SetCommandListCount(size_t count);
+
+    [[nodiscard]] size_t GetCommandListCount() const
+    {
+        return _command_lists.size();
+    }
+
+    /**
+     * @brief 第 index 个命令列表，同一时间只能有一个作业录制同一个列表，不同列表之间无需同步
+     *
+     * index 应是确定的任务编号，不能用 JobSystem::CurrentThreadIndex()：作业在哪个线程上执行取决于时序，
+     * 按线程编号录制时每帧的合并顺序都可能不同。例如把工作固定分成 GetCommandListCount() 份，第 task 份录制到
+     * CommandList(task)：
+     *     jobs.ParallelFor(renderer.GetCommandListCount(), 1, [&](size_t begin, size_t end) {
+     *         for (size_t task = begin; task < end; ++task)
+     *         {
+     *             CommandBuffer::RecordScope scope(renderer.CommandList(task));
+     *             ...
+     *         }
+     *     });
+     * 列表可能被多个作业先后录制，每段录制应放在 CommandBuffer::RecordScope 内，避免继承上一段设置的状态
+     */
+    CommandBuffer& CommandList(size_t index)
+    {
+        return *_command_lists[index];
+    }
+
+    /**
+     * @brief 绘制并清空全部命令：命令列表按下标顺序合并到 Commands() 之后，再统一排序合批
+     */
+    void SubmitCommands();
+
+    /**
+     * @brief 图元管理（保留模式）
+     *
+     * 图元按类型存放在各自的连续数组中，DrawAllPrimitives 按排序键（默认 0）和添加顺序绘制，
+     * 返回的句柄可用于之后修改、调整顺序或删除。
+     */
+    pri::PrimitiveHandle AddPrimitive(std::unique_ptr<pri::IPrimitive> primitive, uint64_t sort_key = 0);
+    template <typename T>
+        requires std::derived_from<T, pri::IPrimitive>
+    pri::PrimitiveHandle AddPrimitive(T primitive, uint64_t sort_key = 0)
+    {
+        return _primitives.Add(std::move(primitive), sort_key);
+    }
+    bool RemovePrimitive(pri::PrimitiveHandle handle);
+
+    /**
+     * @brief 标记图元已修改（通过 Primitives().Get 取得的图元会自动标记）
+     */
+    bool MarkPrimitiveDirty(pri::PrimitiveHandle handle)
+    {
+        return _primitives.MarkDirty(handle);
+    }
+
     void ClearPrimitives();
     void DrawAllPrimitives();
 
-    // 获取关联的像素缓冲区
+    pri::PrimitiveStore& Primitives()
+    {
+        return _primitives;
+    }
+
+    // 获取当前绘制的像素缓冲区（屏幕或绑定的离屏渲染目标）
     PixelsBuffer& Buffer()
     {
-        return _buffer;
+        return *_buffer;
     }
     const PixelsBuffer& Buffer() const
     {
-        return _buffer;
+        return *_buffer;
     }
 
   private:
-    PixelsBuffer& _buffer;
-    std::vector<std::unique_ptr<pri::IPrimitive>> _primitives;
+    // 立即绘制一个图元，开启损坏区域跟踪时记录它的包围盒（本帧和下一帧）
+    template <typename T>
+    void DrawImmediate(const T& primitive)
+    {
+        if (TracksDamage())
+        {
+            AddImmediateDamage(primitive.T::Bounds());
+        }
+        primitive.T::Draw(*_buffer);
+    }
+
+    // 绘制到屏幕且开启了损坏区域跟踪
+    [[nodiscard]] bool TracksDamage() const
+    {
+        return _damage_tracking && _buffer == &_screen;
+    }
+
+    void AddImmediateDamage(const math::BoundingBox2i& rect);
+
+    // PushClipRect 之前的裁剪矩形及其所属的目标
+    struct ClipState
+    {
+        PixelsBuffer* buffer;
+        math::BoundingBox2i previous;
+    };
+
+    PixelsBuffer& _screen;
+    PixelsBuffer* _buffer;                     // 当前绘制目标
+    std::vector<PixelsBuffer*> _target_stack; // PushRenderTarget 之前的目标
+    std::vector<ClipState> _clip_stack;
+    std::unique_ptr<MsaaBuffer> _msaa;
+    std::unique_ptr<StencilBuffer> _stencil;
+    std::unique_ptr<RenderTarget> _stencil_scratch; // DrawToStencil 的暂存目标，第一次使用时分配
+    FrameArena _arena;
+    CommandBuffer _commands;
+    std::vector<std::unique_ptr<CommandBuffer>> _command_lists;
+    pri::PrimitiveStore _primitives;
+
+    bool _damage_tracking = false;
+    DamageTracker _damage;           // 本帧需要重绘和上传的区域
+    DamageTracker _immediate_damage; // 本帧立即绘制的区域，下一帧需要擦除
 };
 
 #endif // GRAPHICS_RENDERER_H
\ No newline at end of file
@@ -3,6 +3,7 @@
 //
 
 #include "image.h"
+#include "blender.h"
 #include "image_loader.h"
 #include <algorithm>
 
@@ -69,4 +70,14 @@ void Image::SetPixel(int x, int y, const Color& color)
     }
 }
 
+void Image::Premultiply()
+{
+    if (_premultiplied)
+    {
+        return;
+    }
+    Blender::PremultiplySpan(_pixels.data(), static_cast<int>(_pixels.size()));
+    _premultiplied = true;
+}
+
 } // namespace image
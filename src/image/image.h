@@ -124,6 +124,19 @@ class Image
         return !_pixels.empty();
     }
 
+    /**
+     * @brief 将像素原地转换为预乘 alpha（重复调用无副作用）
+     */
+    void Premultiply();
+
+    /**
+     * @brief 像素是否已经是预乘 alpha
+     */
+    [[nodiscard]] bool IsPremultiplied() const
+    {
+        return _premultiplied;
+    }
+
     /**
      * @brief 获取原始像素数据（只读）
      */
@@ -145,6 +158,7 @@ class Image
     int _width;
     int _height;
     int _channels;
+    bool _premultiplied = false;
     /** 对应图片左上角在屏幕坐标的开始位置 */
     math::Point2i _start_position{0, 0};
 };
@@ -0,0 +1,284 @@
+//
+// Created by admin on 2026/2/23.
+//
+
+#include "image_blitter.h"
+#include "blender.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if COLOR_LITTLE_ENDIAN && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define IMAGE_BLITTER_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define IMAGE_BLITTER_USE_SSE2 0
+#endif
+
+namespace
+{
+
+constexpr int kFixedBits = 16;
+constexpr double kFixedOne = 65536.0;
+constexpr int kMaxSourceSize = 32767;
+
+int64_t FloorDiv(int64_t a, int64_t b)
+{
+    const int64_t q = a / b;
+    return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+int64_t CeilDiv(int64_t a, int64_t b)
+{
+    return -FloorDiv(-a, b);
+}
+
+// 把 [k0, k1] 收紧到满足 lo <= start + k * step <= hi 的 k
+void ClampSteps(int64_t start, int64_t step, int64_t lo, int64_t hi, int64_t& k0, int64_t& k1)
+{
+    if (step == 0)
+    {
+        if (start < lo || start > hi)
+        {
+            k1 = k0 - 1;
+        }
+        return;
+    }
+    if (step > 0)
+    {
+        k0 = std::max(k0, CeilDiv(lo - start, step));
+        k1 = std::min(k1, FloorDiv(hi - start, step));
+    }
+    else
+    {
+        k0 = std::max(k0, CeilDiv(hi - start, step));
+        k1 = std::min(k1, FloorDiv(lo - start, step));
+    }
+}
+
+// 取样坐标和步长都是 16.16 定点数，[0, count) 内的取样点都在图像内；步长可能接近 int32 的范围，
+// 按 64 位累加，越过最后一个取样点时不会溢出
+void SampleNearest(const ImageBlitter::Source& src, int64_t u, int64_t v, int64_t du, int64_t dv, uint32_t* out,
+                   int count)
+{
+    int k = 0;
+#if IMAGE_BLITTER_USE_SSE2
+    // 每个 32 位通道拼成 (u 的整数部分, v 的整数部分) 两个 16 位数，madd 一次得到 v * stride + u
+    const __m128i index_weights = _mm_set1_epi32(1 | (src.stride << 16));
+    const __m128i high_mask = _mm_set1_epi32(static_cast<int>(0xFFFF0000u));
+    // 通道按 32 位回绕相加：每组 4 个取样点都在图像内时回绕不影响结果，组外的通道不会被读取
+    auto lane = [](int64_t value) { return static_cast<int32_t>(static_cast<uint32_t>(value)); };
+    const __m128i du4 = _mm_set1_epi32(lane(du * 4));
+    const __m128i dv4 = _mm_set1_epi32(lane(dv * 4));
+    __m128i uu = _mm_setr_epi32(lane(u), lane(u + du), lane(u + 2 * du), lane(u + 3 * du));
+    __m128i vv = _mm_setr_epi32(lane(v), lane(v + dv), lane(v + 2 * dv), lane(v + 3 * dv));
+    alignas(16) int32_t index[4];
+    for (; k + 4 <= count; k += 4)
+    {
+        const __m128i packed = _mm_or_si128(_mm_srli_epi32(uu, kFixedBits), _mm_and_si128(vv, high_mask));
+        _mm_store_si128(reinterpret_cast<__m128i*>(index), _mm_madd_epi16(packed, index_weights));
+        out[k] = src.pixels[index[0]];
+        out[k + 1] = src.pixels[index[1]];
+        out[k + 2] = src.pixels[index[2]];
+        out[k + 3] = src.pixels[index[3]];
+        uu = _mm_add_epi32(uu, du4);
+        vv = _mm_add_epi32(vv, dv4);
+    }
+    u += du * k;
+    v += dv * k;
+#endif
+    for (; k < count; ++k)
+    {
+        out[k] = src.pixels[static_cast<size_t>(v >> kFixedBits) * src.stride + (u >> kFixedBits)];
+        u += du;
+        v += dv;
+    }
+}
+
+void SampleBilinear(const ImageBlitter::Source& src, int64_t u, int64_t v, int64_t du, int64_t dv, uint32_t* out,
+                    int count)
+{
+    // 取样点是像素中心，左移半个像素后截断到 [0, size - 1)，右 / 下邻居总在图像内；
+    // 宽或高为 1 时邻居就是自身
+    const int64_t half = 1 << (kFixedBits - 1);
+    const int64_t u_max = std::max((src.width - 1) * (1 << kFixedBits) - 1, 0);
+    const int64_t v_max = std::max((src.height - 1) * (1 << kFixedBits) - 1, 0);
+    const int right = src.width > 1 ? 1 : 0;
+    const size_t down = src.height > 1 ? static_cast<size_t>(src.stride) : 0;
+#if IMAGE_BLITTER_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(128);
+    // 左右两个像素展开成 16 位：低 4 个通道是左侧像素，高 4 个是右侧像素
+    auto load_pair = [zero](uint32_t left, uint32_t right_pixel)
+    {
+        return _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(static_cast<int>(left)),
+                                                    _mm_cvtsi32_si128(static_cast<int>(right_pixel))),
+                                 zero);
+    };
+#endif
+    for (int k = 0; k < count; ++k, u += du, v += dv)
+    {
+        const int64_t us = std::clamp<int64_t>(u - half, 0, u_max);
+        const int64_t vs = std::clamp<int64_t>(v - half, 0, v_max);
+        const uint32_t* p = src.pixels + static_cast<size_t>(vs >> kFixedBits) * src.stride + (us >> kFixedBits);
+        const int fx = static_cast<int>((us >> 8) & 0xFF);
+        const int fy = static_cast<int>((vs >> 8) & 0xFF);
+#if IMAGE_BLITTER_USE_SSE2
+        const __m128i top = load_pair(p[0], p[right]);
+        const __m128i bottom = load_pair(p[down], p[down + right]);
+        // 竖直插值：top * (256 - fy) + bottom * fy 不超过 16 位
+        __m128i column = _mm_add_epi16(_mm_mullo_epi16(top, _mm_set1_epi16(static_cast<int16_t>(256 - fy))),
+                                       _mm_mullo_epi16(bottom, _mm_set1_epi16(static_cast<int16_t>(fy))));
+        column = _mm_srli_epi16(_mm_add_epi16(column, round), 8);
+        // 水平插值：左右两半分别乘以权重后相加
+        const __m128i wx = _mm_set_epi16(fx, fx, fx, fx, 256 - fx, 256 - fx, 256 - fx, 256 - fx);
+        __m128i row = _mm_mullo_epi16(column, wx);
+        row = _mm_add_epi16(row, _mm_srli_si128(row, 8));
+        row = _mm_srli_epi16(_mm_add_epi16(row, round), 8);
+        out[k] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(row, row)));
+#else
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            auto channel = [shift](uint32_t pixel) { return static_cast<int>((pixel >> shift) & 0xFFu); };
+            const int left = (channel(p[0]) * (256 - fy) + channel(p[down]) * fy + 128) >> 8;
+            const int right_value = (channel(p[right]) * (256 - fy) + channel(p[down + right]) * fy + 128) >> 8;
+            result |= static_cast<uint32_t>((left * (256 - fx) + right_value * fx + 128) >> 8) << shift;
+        }
+        out[k] = result;
+#endif
+    }
+}
+
+bool IsIntegerTranslation(const math::Affine2f& t)
+{
+    return t.A() == 1.0f && t.B() == 0.0f && t.C() == 0.0f && t.D() == 1.0f && t.Tx() == std::floor(t.Tx()) &&
+           t.Ty() == std::floor(t.Ty());
+}
+
+} // namespace
+
+math::BoundingBox2i ImageBlitter::Bounds(int width, int height, const math::Affine2f& transform)
+{
+    const auto w = static_cast<float>(width);
+    const auto h = static_cast<float>(height);
+    const math::Point2f corners[4] = {
+        transform.Apply(math::Point2f(0.0f, 0.0f)), transform.Apply(math::Point2f(w, 0.0f)),
+        transform.Apply(math::Point2f(0.0f, h)), transform.Apply(math::Point2f(w, h))};
+    float min_x = corners[0].X();
+    float min_y = corners[0].Y();
+    float max_x = min_x;
+    float max_y = min_y;
+    for (const auto& corner : corners)
+    {
+        min_x = std::min(min_x, corner.X());
+        min_y = std::min(min_y, corner.Y());
+        max_x = std::max(max_x, corner.X());
+        max_y = std::max(max_y, corner.Y());
+    }
+    return math::BoundingBox2i(static_cast<int>(std::floor(min_x)), static_cast<int>(std::floor(min_y)),
+                               static_cast<int>(std::ceil(max_x)), static_cast<int>(std::ceil(max_y)));
+}
+
+void ImageBlitter::Blit(PixelsBuffer& dst, const Source& source, const math::Affine2f& transform, ImageFilter filter,
+                        const math::BoundingBox2i& region, uint32_t* scratch)
+{
+    if (source.pixels == nullptr || source.width <= 0 || source.height <= 0 || source.stride < source.width ||
+        source.stride > kMaxSourceSize || source.height > kMaxSourceSize || !transform.IsInvertible())
+    {
+        return;
+    }
+    const int x0 = std::max(region.MinX(), dst.ClipMinX());
+    const int y0 = std::max(region.MinY(), dst.ClipMinY());
+    const int x1 = std::min(region.MaxX(), dst.ClipMaxX());
+    const int y1 = std::min(region.MaxY(), dst.ClipMaxY());
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+
+    if (IsIntegerTranslation(transform))
+    {
+        // 整数平移：源行与目标行一一对应，直接混合源图像的行
+        const int tx = static_cast<int>(transform.Tx());
+        const int ty = static_cast<int>(transform.Ty());
+        const int col_begin = std::max(x0, tx);
+        const int col_end = std::min(x1, tx + source.width);
+        if (col_begin >= col_end)
+        {
+            return;
+        }
+        const int count = col_end - col_begin;
+        for (int y = std::max(y0, ty); y < std::min(y1, ty + source.height); ++y)
+        {
+            const uint32_t* row = source.pixels + static_cast<size_t>(y - ty) * source.stride + (col_begin - tx);
+            if (!source.premultiplied)
+            {
+                std::memcpy(scratch, row, static_cast<size_t>(count) * sizeof(uint32_t));
+                Blender::PremultiplySpan(scratch, count);
+                row = scratch;
+            }
+            dst.BlendSpan(col_begin, y, row, count);
+        }
+        return;
+    }
+
+    // 逆变换在双精度下计算，每行的起点直接求出，误差不会跨行累积
+    const double a = transform.A();
+    const double b = transform.B();
+    const double c = transform.C();
+    const double d = transform.D();
+    const double inv_det = 1.0 / (a * d - b * c);
+    const double ia = d * inv_det;
+    const double ib = -b * inv_det;
+    const double ic = -c * inv_det;
+    const double id = a * inv_det;
+    const double itx = -(ia * transform.Tx() + ic * transform.Ty());
+    const double ity = -(ib * transform.Tx() + id * transform.Ty());
+    // 每个目标像素的源坐标步长：超过 int32 定点数的范围时（一个目标像素跨过的源像素多于 32767，
+    // 整幅图像在一行中最多只占一个像素）不绘制
+    constexpr double kMaxStep = 2147483647.0;
+    if (!(std::abs(ia * kFixedOne) <= kMaxStep) || !(std::abs(ib * kFixedOne) <= kMaxStep))
+    {
+        return;
+    }
+    const int64_t du = std::llround(ia * kFixedOne);
+    const int64_t dv = std::llround(ib * kFixedOne);
+    const int64_t u_hi = (static_cast<int64_t>(source.width) << kFixedBits) - 1;
+    const int64_t v_hi = (static_cast<int64_t>(source.height) << kFixedBits) - 1;
+
+    for (int y = y0; y < y1; ++y)
+    {
+        // 行首像素中心对应的源坐标
+        const double px = x0 + 0.5;
+        const double py = y + 0.5;
+        const int64_t u_start = std::llround((ia * px + ic * py + itx) * kFixedOne);
+        const int64_t v_start = std::llround((ib * px + id * py + ity) * kFixedOne);
+
+        // 源坐标落在 [0, width) x [0, height) 内的连续片段
+        int64_t k0 = 0;
+        int64_t k1 = x1 - x0 - 1;
+        ClampSteps(u_start, du, 0, u_hi, k0, k1);
+        ClampSteps(v_start, dv, 0, v_hi, k0, k1);
+        if (k0 > k1)
+        {
+            continue;
+        }
+        const int count = static_cast<int>(k1 - k0 + 1);
+        const int64_t u = u_start + k0 * du;
+        const int64_t v = v_start + k0 * dv;
+        if (filter == ImageFilter::Bilinear)
+        {
+            SampleBilinear(source, u, v, du, dv, scratch, count);
+        }
+        else
+        {
+            SampleNearest(source, u, v, du, dv, scratch, count);
+        }
+        if (!source.premultiplied)
+        {
+            Blender::PremultiplySpan(scratch, count);
+        }
+        dst.BlendSpan(x0 + static_cast<int>(k0), y, scratch, count);
+    }
+}
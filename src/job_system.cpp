@@ -0,0 +1,338 @@
+//
+// Created by admin on 2026/2/17.
+//
+
+#include "job_system.h"
+
+#include <cassert>
+
+namespace parallel
+{
+
+namespace
+{
+
+// 空闲线程进入休眠前的自旋次数
+constexpr int kSpinCount = 64;
+
+thread_local JobSystem* t_system = nullptr;
+thread_local int t_thread_index = -1;
+
+uint32_t NextRandom(uint32_t& state)
+{
+    // xorshift32
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+} // namespace
+
+bool JobSystem::WorkQueue::Push(Job* job)
+{
+    const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+    const int64_t top = _top.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<int64_t>(kQueueCapacity))
+    {
+        return false;
+    }
+    _jobs[static_cast<size_t>(bottom) & (kQueueCapacity - 1)].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Job* JobSystem::WorkQueue::Pop()
+{
+    const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = _top.load(std::memory_order_relaxed);
+    if (top > bottom)
+    {
+        // 队列为空
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = _jobs[static_cast<size_t>(bottom) & (kQueueCapacity - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // 最后一个作业，与窃取线程竞争
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            job = nullptr;
+        }
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* JobSystem::WorkQueue::Steal()
+{
+    int64_t top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = _bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+        return nullptr;
+    }
+    Job* job = _jobs[static_cast<size_t>(top) & (kQueueCapacity - 1)].load(std::memory_order_relaxed);
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+    return job;
+}
+
+JobSystem::JobSystem(int thread_count)
+{
+    if (thread_count <= 0)
+    {
+        thread_count = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+    _states.reserve(thread_count);
+    for (int i = 0; i < thread_count; ++i)
+    {
+        _states.push_back(std::make_unique<ThreadState>());
+        _states.back()->random = 0x9E3779B9u * static_cast<uint32_t>(i + 1);
+    }
+
+    t_system = this;
+    t_thread_index = 0;
+    _threads.resize(thread_count);
+    for (int i = 1; i < thread_count; ++i)
+    {
+        _threads[i] = std::thread(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    EndFrame();
+    _running.store(false);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _wake.notify_all();
+    }
+    for (auto& thread : _threads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    if (t_system == this)
+    {
+        t_system = nullptr;
+        t_thread_index = -1;
+    }
+}
+
+JobSystem* JobSystem::Current()
+{
+    return t_system;
+}
+
+int JobSystem::CurrentThreadIndex()
+{
+    return t_thread_index;
+}
+
+void JobSystem::AddDependency(Job* job, Job* dependency)
+{
+    assert(dependency->continuation_count < Job::kMaxContinuations);
+    job->pending.fetch_add(1, std::memory_order_relaxed);
+    dependency->continuations[dependency->continuation_count++] = job;
+}
+
+void JobSystem::Submit(Job* job)
+{
+    _outstanding.fetch_add(1);
+    if (job->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        Enqueue(job);
+    }
+}
+
+void JobSystem::Wait(const Job* job)
+{
+    if (t_system != this)
+    {
+        // 不属于本系统的线程没有作业队列，只能阻塞等待
+        while (!IsFinished(job))
+        {
+            std::this_thread::yield();
+        }
+        return;
+    }
+    ThreadState& state = CurrentState();
+    while (!IsFinished(job))
+    {
+        if (Job* next = FindJob(state))
+        {
+            Execute(next);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::EndFrame()
+{
+    assert(t_system == this && t_thread_index == 0);
+    ThreadState& state = *_states[0];
+    while (_outstanding.load() > 0)
+    {
+        if (Job* next = FindJob(state))
+        {
+            Execute(next);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    // 所有作业都已完成，工作线程不会再访问自己的作业池
+    for (auto& thread_state : _states)
+    {
+        thread_state->pool.used = 0;
+    }
+}
+
+Job* JobSystem::AllocateJob()
+{
+    JobPool& pool = CurrentState().pool;
+    const size_t block = pool.used / JobPool::kJobsPerBlock;
+    if (block == pool.blocks.size())
+    {
+        pool.blocks.push_back(std::make_unique<Job[]>(JobPool::kJobsPerBlock));
+    }
+    Job* job = &pool.blocks[block][pool.used % JobPool::kJobsPerBlock];
+    ++pool.used;
+
+    job->parent = nullptr;
+    job->unfinished.store(1, std::memory_order_relaxed);
+    job->pending.store(1, std::memory_order_relaxed);
+    job->continuation_count = 0;
+    return job;
+}
+
+JobSystem::ThreadState& JobSystem::CurrentState()
+{
+    // 其它线程的 t_thread_index 为 -1，或者是另一个作业系统中的编号
+    assert(t_system == this && t_thread_index >= 0);
+    return *_states[static_cast<size_t>(t_thread_index)];
+}
+
+Job* JobSystem::CurrentJob()
+{
+    return t_system ? t_system->_states[t_thread_index]->current : nullptr;
+}
+
+void JobSystem::Enqueue(Job* job)
+{
+    ThreadState& state = CurrentState();
+    if (!state.queue.Push(job))
+    {
+        // 队列已满：直接在当前线程执行
+        Execute(job);
+        return;
+    }
+    _queued.fetch_add(1);
+    if (_sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _wake.notify_one();
+    }
+}
+
+Job* JobSystem::FindJob(ThreadState& state)
+{
+    if (Job* job = state.queue.Pop())
+    {
+        _queued.fetch_sub(1);
+        return job;
+    }
+    const size_t count = _states.size();
+    const size_t start = NextRandom(state.random) % count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        ThreadState& victim = *_states[(start + i) % count];
+        if (&victim == &state)
+        {
+            continue;
+        }
+        if (Job* job = victim.queue.Steal())
+        {
+            _queued.fetch_sub(1);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::Execute(Job* job)
+{
+    ThreadState& state = CurrentState();
+    Job* previous = state.current;
+    state.current = job;
+    job->invoke(job->data);
+    state.current = previous;
+    Finish(job);
+}
+
+void JobSystem::Finish(Job* job)
+{
+    if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+    // 子作业可能引用父作业中的函数对象，因此在作业完成（而不是执行完）时才析构
+    job->destroy(job->data);
+    for (int i = 0; i < job->continuation_count; ++i)
+    {
+        Job* continuation = job->continuations[i];
+        if (continuation->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            Enqueue(continuation);
+        }
+    }
+    if (job->parent)
+    {
+        Finish(job->parent);
+    }
+    _outstanding.fetch_sub(1);
+}
+
+void JobSystem::WorkerLoop(int index)
+{
+    t_system = this;
+    t_thread_index = index;
+    ThreadState& state = *_states[index];
+    int spins = 0;
+    while (_running.load(std::memory_order_relaxed))
+    {
+        if (Job* job = FindJob(state))
+        {
+            Execute(job);
+            spins = 0;
+            continue;
+        }
+        if (++spins < kSpinCount)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_mutex);
+        _sleeping.fetch_add(1);
+        _wake.wait(lock, [this]() { return _queued.load() > 0 || !_running.load(); });
+        _sleeping.fetch_sub(1);
+        spins = 0;
+    }
+}
+
+} // namespace parallel
@@ -0,0 +1,244 @@
+//
+// Created by admin on 2026/2/17.
+//
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace parallel
+{
+
+/**
+ * @brief 作业：由 JobSystem 创建，在 JobSystem::EndFrame 之前有效
+ *
+ * 作业的函数对象直接存放在作业内部（不超过 kMaxDataSize 字节），创建作业不分配堆内存。
+ * unfinished 为自身加上未完成的子作业个数，归零时作业完成；
+ * pending 为提交本身加上未完成的依赖个数，归零时作业进入队列。
+ */
+struct alignas(64) Job
+{
+    static constexpr size_t kMaxDataSize = 64;
+    static constexpr int kMaxContinuations = 8;
+
+    alignas(std::max_align_t) std::byte data[kMaxDataSize];
+    void (*invoke)(void*) = nullptr;
+    void (*destroy)(void*) = nullptr;
+    Job* parent = nullptr;
+    std::atomic<int> unfinished{1};
+    std::atomic<int> pending{1};
+    int continuation_count = 0;
+    Job* continuations[kMaxContinuations] = {};
+};
+
+/**
+ * @brief 工作窃取作业系统
+ *
+ * 每个线程（主线程为 0 号，工作线程为 1..N-1）拥有一个作业双端队列：
+ *   - 线程只从自己队列的底部压入 / 弹出作业（后进先出，数据仍在缓存中），
+ *     队列为空时随机从其它线程队列的顶部窃取（Chase-Lev 无锁双端队列）
+ *   - 作业之间的关系：子作业（父作业等所有子作业完成才算完成）和依赖（作业在所有依赖完成后才开始），
+ *     可以组成每帧的依赖图，如 动画更新 -> 剔除 -> 分箱 -> 光栅化 -> 上传
+ *   - Wait 的调用线程（包括主线程）在等待期间执行其它作业，不会空等
+ *   - 作业从每个线程自己的作业池中分配，EndFrame 时整体回收，稳定状态下不分配堆内存
+ *
+ * 作业只能由属于本系统的线程（主线程或工作线程）创建和提交（调试版本中断言）；
+ * 其它线程可以调用 Wait，但只阻塞等待，不参与执行作业。
+ * 空闲的工作线程短暂自旋后进入休眠，有新作业时被唤醒。
+ */
+class JobSystem
+{
+  public:
+    // 每个线程队列的容量，队列满时作业在提交线程上直接执行
+    static constexpr size_t kQueueCapacity = 4096;
+
+    /**
+     * @param thread_count 线程总数（包括调用线程），0 表示使用硬件并发数
+     *
+     * 构造函数的调用线程成为 0 号线程（主线程）。
+     */
+    explicit JobSystem(int thread_count = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief 线程总数（包括主线程）
+     */
+    [[nodiscard]] int ThreadCount() const
+    {
+        return static_cast<int>(_threads.size());
+    }
+
+    /**
+     * @brief 当前线程所属的作业系统，不属于任何作业系统时为空
+     */
+    static JobSystem* Current();
+
+    /**
+     * @brief 当前线程在所属作业系统中的编号，不属于任何作业系统时为 -1
+     */
+    static int CurrentThreadIndex();
+
+    /**
+     * @brief 创建作业（尚未提交），只能在本系统的线程上调用
+     */
+    template <typename F>
+    Job* Create(F&& function)
+    {
+        return CreateChild(nullptr, std::forward<F>(function));
+    }
+
+    /**
+     * @brief 创建 parent 的子作业（尚未提交），parent 要等它完成才算完成
+     *
+     * 应在 parent 完成之前调用：在 parent 提交之前，或在 parent 的函数体内。
+     */
+    template <typename F>
+    Job* CreateChild(Job* parent, F&& function)
+    {
+        using Function = std::decay_t<F>;
+        static_assert(sizeof(Function) <= Job::kMaxDataSize, "job function object is too large");
+        static_assert(alignof(Function) <= alignof(std::max_align_t), "job function object is over-aligned");
+
+        Job* job = AllocateJob();
+        ::new (static_cast<void*>(job->data)) Function(std::forward<F>(function));
+        job->invoke = [](void* data) { (*static_cast<Function*>(data))(); };
+        job->destroy = [](void* data) { static_cast<Function*>(data)->~Function(); };
+        job->parent = parent;
+        if (parent)
+        {
+            parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    /**
+     * @brief 创建并行循环作业：把 [0, count) 按 grain 分块，每块以子作业调用 function(begin, end)
+     *
+     * 返回的作业可以像普通作业一样建立依赖、提交和等待，所有块执行完毕后才算完成。
+     */
+    template <typename F>
+    Job* CreateParallelFor(size_t count, size_t grain, F&& function)
+    {
+        using Function = std::decay_t<F>;
+        // 分块数不超过线程数的 4 倍，块太小时调度开销超过收益
+        const size_t threads = static_cast<size_t>(ThreadCount());
+        const size_t chunk = std::max({grain, size_t{1}, (count + threads * 4 - 1) / (threads * 4)});
+        return Create(
+            [this, count, chunk, function = Function(std::forward<F>(function))]()
+            {
+                Job* self = CurrentJob();
+                for (size_t begin = 0; begin < count; begin += chunk)
+                {
+                    const size_t end = std::min(begin + chunk, count);
+                    // 函数对象存放在父作业中，父作业在所有子作业完成后才析构它
+                    Submit(CreateChild(self, [&function, begin, end]() { function(begin, end); }));
+                }
+            });
+    }
+
+    /**
+     * @brief job 在 dependency 完成之后才开始执行，两个作业都必须尚未提交
+     */
+    void AddDependency(Job* job, Job* dependency);
+
+    /**
+     * @brief 提交作业，依赖都已完成时立即进入当前线程的队列（只能在本系统的线程上调用）
+     */
+    void Submit(Job* job);
+
+    /**
+     * @brief 等待作业完成，等待期间当前线程执行其它作业（不属于本系统的线程只阻塞等待）
+     */
+    void Wait(const Job* job);
+
+    [[nodiscard]] static bool IsFinished(const Job* job)
+    {
+        return job->unfinished.load(std::memory_order_acquire) == 0;
+    }
+
+    /**
+     * @brief 并行执行 function(begin, end) 并等待全部完成（只能在本系统的线程上调用）
+     */
+    template <typename F>
+    void ParallelFor(size_t count, size_t grain, F&& function)
+    {
+        Job* job = CreateParallelFor(count, grain, std::forward<F>(function));
+        Submit(job);
+        Wait(job);
+    }
+
+    /**
+     * @brief 等待所有已提交的作业完成，然后回收本帧创建的全部作业（只能在主线程调用）
+     */
+    void EndFrame();
+
+  private:
+    // Chase-Lev 工作窃取双端队列（固定容量）
+    class WorkQueue
+    {
+      public:
+        bool Push(Job* job);
+        Job* Pop();
+        Job* Steal();
+
+      private:
+        alignas(64) std::atomic<int64_t> _top{0};
+        alignas(64) std::atomic<int64_t> _bottom{0};
+        std::unique_ptr<std::atomic<Job*>[]> _jobs{new std::atomic<Job*>[kQueueCapacity]};
+    };
+
+    // 每个线程独占的作业池（按块分配，EndFrame 时整体回收）
+    struct JobPool
+    {
+        static constexpr size_t kJobsPerBlock = 256;
+        std::vector<std::unique_ptr<Job[]>> blocks;
+        size_t used = 0;
+    };
+
+    struct alignas(64) ThreadState
+    {
+        WorkQueue queue;
+        JobPool pool;
+        uint32_t random = 0; // 选择窃取对象的随机数状态
+        Job* current = nullptr;
+    };
+
+    // 当前线程的状态（当前线程必须属于本系统）
+    ThreadState& CurrentState();
+    Job* AllocateJob();
+    static Job* CurrentJob();
+    void Enqueue(Job* job);
+    Job* FindJob(ThreadState& state);
+    void Execute(Job* job);
+    void Finish(Job* job);
+    void WorkerLoop(int index);
+
+    std::vector<std::unique_ptr<ThreadState>> _states;
+    std::vector<std::thread> _threads; // _threads[0] 为空（主线程）
+    std::atomic<bool> _running{true};
+
+    std::atomic<int> _queued{0};      // 队列中的作业数
+    std::atomic<int> _outstanding{0}; // 已提交但尚未完成的作业数
+    std::atomic<int> _sleeping{0};
+    std::mutex _mutex;
+    std::condition_variable _wake;
+};
+
+} // namespace parallel
+
+#endif // JOB_SYSTEM_H
@@ -4,16 +4,27 @@
 #include "color.h"
 #include "image.h"
 #include "math/vector.h"
+#include "primitive/circle_primitive.h"
+#include "primitive/ellipse_primitive.h"
+#include "primitive/line_batch.h"
 #include "primitive/line_primitive.h"
+#include "primitive/path_primitive.h"
+#include "primitive/point_cloud_primitive.h"
+#include "primitive/polygon_primitive.h"
+#include "primitive/polyline_primitive.h"
+#include "primitive/rounded_rect_primitive.h"
 #include "sdl2_window.h"
 #include "sprite/sprite.h"
 #include "triangle_primitive.h"
 
 
+#include <array>
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
 #include <memory>
+#include <random>
 
 using namespace math;
 using namespace std;
@@ -27,10 +38,41 @@ using namespace std;
 
 void TestRenderer(GraphicsRenderer& renderer, Sdl2Window* window = nullptr);
 void TestVector();
+void TestCommandClip();
+void TestMsaaSeam();
+void BenchmarkMsaa();
+void BenchmarkPolygon();
+void BenchmarkPolyline();
+void BenchmarkBresenham();
+void BenchmarkLineBatch();
+void BenchmarkPointCloud();
 
 const int g_width = 800;
 const int g_height = 600;
 
+namespace
+{
+
+// 连续执行 frames 次 frame，返回平均每帧耗时（毫秒）
+template <typename Frame> double TimeFrames(int frames, Frame&& frame)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i)
+    {
+        frame();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+// 计时并输出 "name: x ms/frame"
+template <typename Frame> void MeasureFrames(const char* name, int frames, Frame&& frame)
+{
+    std::cout << name << ": " << TimeFrames(frames, frame) << " ms/frame" << std::endl;
+}
+
+} // namespace
+
 int main(int argc, char* argv[])
 {
     (void)argc; // 避免未使用参数警告
@@ -46,6 +88,38 @@ int main(int argc, char* argv[])
 #if 0
     TestVector();
 #endif
+
+#if 0
+    TestCommandClip();
+#endif
+
+#if 0
+    TestMsaaSeam();
+#endif
+
+#if 0
+    BenchmarkMsaa();
+#endif
+
+#if 0
+    BenchmarkPolygon();
+#endif
+
+#if 0
+    BenchmarkPolyline();
+#endif
+
+#if 0
+    BenchmarkBresenham();
+#endif
+
+#if 0
+    BenchmarkLineBatch();
+#endif
+
+#if 0
+    BenchmarkPointCloud();
+#endif
     // 启动事件循环
     window.EventLoop();
 
@@ -127,78 +201,500 @@ void TestVector()
     std::cout << "v33 = " << v33.PrintToString() << std::endl;
 }
 
-void BresenhamLine(const pri::PointPrimitive point1, const pri::PointPrimitive point2, GraphicsRenderer& renderer)
+void TestCommandClip()
 {
-    pri::PointPrimitive start_point = point1;
-    pri::PointPrimitive end_point = point2;
-    // 1、保证x是从小到大的顺序
-    if (start_point.X() > end_point.X())
+    // 在压入的裁剪矩形内录制命令，提交后裁剪矩形之外的像素都不应被写入
+    PixelsBuffer buffer(g_width, g_height);
+    GraphicsRenderer renderer(buffer);
+    renderer.SetCommandListCount(1);
+    renderer.Clear(Color::Black());
+
+    const math::BoundingBox2i clip(100, 100, 300, 200);
+    renderer.PushClipRect(clip);
+    renderer.Commands().DrawTriangle(Point2i(0, 0), Point2i(g_width - 1, 0), Point2i(0, g_height - 1), Color::Red());
+    renderer.Commands().DrawLine(0, 150, g_width - 1, 150, Color::Green());
+    renderer.PopClipRect();
+
+    // 命令列表不跟随渲染器的裁剪矩形，需要显式设置
+    CommandBuffer& list = renderer.CommandList(0);
     {
-        start_point.Swap(end_point);
+        CommandBuffer::RecordScope scope(list);
+        list.SetClipRect(clip);
+        list.DrawTriangle(Point2i(g_width - 1, g_height - 1), Point2i(0, g_height - 1), Point2i(g_width - 1, 0),
+                          Color::Blue());
     }
 
-    // 2、保证y是从小到大的顺序
-    bool flip_y = false;
-    if (start_point.Y() > end_point.Y())
+    // 弹出裁剪矩形后录制的同状态命令不裁剪，也不能与上面的命令合并
+    renderer.Commands().DrawLine(0, 250, g_width - 1, 250, Color::Green());
+    renderer.SubmitCommands();
+
+    int outside = 0;
+    for (int y = 0; y < g_height; ++y)
     {
-        start_point.SetY(start_point.Y() * -1);
-        end_point.SetY(end_point.Y() * -1);
-        flip_y = true;
+        for (int x = 0; x < g_width; ++x)
+        {
+            const bool inside = x >= clip.MinX() && x < clip.MaxX() && y >= clip.MinY() && y < clip.MaxY();
+            if (!inside && y != 250 && buffer.GetPixel(x, y).ToUint32() != Color::Black().ToUint32())
+            {
+                ++outside;
+            }
+        }
     }
+    const bool line_drawn = buffer.GetPixel(10, 250).ToUint32() == Color::Green().ToUint32();
+    std::cout << "command clip: " << outside << " pixels outside the clip rect, unclipped line "
+              << (line_drawn ? "drawn" : "missing") << std::endl;
+}
 
-    int dx = end_point.X() - start_point.X();
-    int dy = end_point.Y() - start_point.Y();
-    // 斜率大于1，交换xy
-    bool swapxy = false;
-    if (dx < dy)
+void TestMsaaSeam()
+{
+    // 两个三角形沿对角线拼成矩形，半透明叠加：共享边上的样本只能被覆盖一次，矩形内部应当颜色一致
+    PixelsBuffer buffer(g_width, g_height);
+    GraphicsRenderer renderer(buffer);
+    renderer.SetBlendMode(BlendMode::SrcOver);
+    const Color color(255, 255, 255, 128);
+    for (int samples : {4, 8})
     {
-        start_point.SwapXY();
-        end_point.SwapXY();
-        std::swap(dx, dy);
-        swapxy = true;
+        renderer.SetMultisample(samples);
+        renderer.Clear(Color::Black());
+        renderer.Draw(pri::TrianglePrimitive(10, 10, 100, 10, 100, 28, color));
+        renderer.Draw(pri::TrianglePrimitive(10, 10, 100, 28, 10, 28, color));
+        renderer.Resolve();
+
+        const uint32_t expected = buffer.GetPixel(50, 15).ToUint32();
+        int seam = 0;
+        for (int y = 11; y < 28; ++y)
+        {
+            for (int x = 11; x < 100; ++x)
+            {
+                if (buffer.GetPixel(x, y).ToUint32() != expected)
+                {
+                    ++seam;
+                }
+            }
+        }
+        std::cout << "MSAA " << samples << "x seam: " << seam << " pixels differ from the interior" << std::endl;
     }
+    renderer.SetMultisample(1);
+}
 
-    pri::PointPrimitive current_point = start_point;
-    pri::PointPrimitive result_point{0, 0};
-    int p = 2 * dy - dx;
-    for (int i = 0; i < dx; ++i)
+// MSAA 与整幅超采样（SSAA）的开销对比：绘制同一组随机三角形，统计每帧耗时
+void BenchmarkMsaa()
+{
+    constexpr int kTriangles = 2000;
+    constexpr int kFrames = 20;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pos_x(0, g_width - 1);
+    std::uniform_int_distribution<int> pos_y(0, g_height - 1);
+    std::uniform_int_distribution<int> offset(-40, 40);
+    std::vector<std::array<int, 6>> triangles(kTriangles);
+    for (auto& t : triangles)
     {
-        if (p >= 0)
+        t[0] = pos_x(rng);
+        t[1] = pos_y(rng);
+        t[2] = t[0] + offset(rng);
+        t[3] = t[1] + offset(rng);
+        t[4] = t[0] + offset(rng);
+        t[5] = t[1] + offset(rng);
+    }
+    const Color color(255, 0, 0, 160);
+
+    auto draw_all = [&](GraphicsRenderer& renderer, int scale)
+    {
+        for (size_t i = 0; i < triangles.size(); ++i)
         {
-            p = p - 2 * dx;
-            current_point.SetY(current_point.Y() + 1);
+            const auto& t = triangles[i];
+            pri::TrianglePrimitive triangle(t[0] * scale, t[1] * scale, t[2] * scale, t[3] * scale, t[4] * scale,
+                                            t[5] * scale, color);
+            renderer.Draw(triangle);
         }
-        p = p + 2 * dy;
-        current_point.SetX(current_point.X() + 1);
+    };
+
+    PixelsBuffer buffer(g_width, g_height);
+    GraphicsRenderer renderer(buffer);
 
-        result_point = current_point;
-        if (swapxy)
+    MeasureFrames("no AA", kFrames, [&]() {
+        renderer.Clear();
+        draw_all(renderer, 1);
+    });
+
+    for (int samples : {4, 8})
+    {
+        renderer.SetMultisample(samples);
+        size_t sample_bytes = 0;
+        MeasureFrames(samples == 4 ? "MSAA 4x" : "MSAA 8x", kFrames, [&]() {
+            renderer.Clear();
+            draw_all(renderer, 1);
+            sample_bytes = buffer.Multisample()->SampleMemoryBytes();
+            renderer.Resolve();
+        });
+        std::cout << "  sample memory: " << sample_bytes / 1024 << " KiB" << std::endl;
+    }
+    renderer.SetMultisample(1);
+
+    // 2x2 超采样：在 4 倍面积的缓冲区中绘制后做盒式滤波降采样
+    PixelsBuffer super_buffer(g_width * 2, g_height * 2);
+    GraphicsRenderer super_renderer(super_buffer);
+    MeasureFrames("SSAA 2x2", kFrames, [&]() {
+        super_renderer.Clear();
+        draw_all(super_renderer, 2);
+        const uint32_t* src = super_buffer.Pixels();
+        uint32_t* dst = buffer.Pixels();
+        const int src_width = super_buffer.Width();
+        for (int y = 0; y < g_height; ++y)
         {
-            result_point.SwapXY();
+            for (int x = 0; x < g_width; ++x)
+            {
+                const uint32_t* p = src + static_cast<size_t>(y * 2) * src_width + x * 2;
+                const uint32_t quad[4] = {p[0], p[1], p[src_width], p[src_width + 1]};
+                uint32_t resolved = 0;
+                for (int shift = 0; shift < 32; shift += 8)
+                {
+                    uint32_t sum = 0;
+                    for (uint32_t q : quad)
+                    {
+                        sum += (q >> shift) & 0xFF;
+                    }
+                    resolved |= ((sum + 2) / 4) << shift;
+                }
+                dst[static_cast<size_t>(y) * g_width + x] = resolved;
+            }
         }
+    });
+    std::cout << "  sample memory: " << super_buffer.Width() * super_buffer.Height() * 4 / 1024 << " KiB"
+              << std::endl;
+}
 
-        if (flip_y)
+void BenchmarkPolygon()
+{
+    constexpr int kPolygons = 300;
+    constexpr int kVertices = 12;
+    constexpr int kFrames = 10;
+
+    // 随机星形多边形（顶点按角度排序，半径随机）
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> center_x(0.0f, g_width);
+    std::uniform_real_distribution<float> center_y(0.0f, g_height);
+    std::uniform_real_distribution<float> radius(10.0f, 60.0f);
+    std::vector<std::vector<Point2f>> polygons(kPolygons);
+    for (auto& polygon : polygons)
+    {
+        const float cx = center_x(rng);
+        const float cy = center_y(rng);
+        for (int i = 0; i < kVertices; ++i)
         {
-            result_point.SetY(result_point.Y() * -1);
+            const float angle = static_cast<float>(DEG2RAD(360.0 * i / kVertices));
+            const float r = radius(rng);
+            polygon.emplace_back(cx + r * std::cos(angle), cy + r * std::sin(angle));
         }
+    }
+    const Color color(255, 0, 0, 160);
 
-        float t = 0.0f;
-        if (point1.X() != point2.X())
+    PixelsBuffer buffer(g_width, g_height);
+    GraphicsRenderer renderer(buffer);
+    renderer.SetBlendMode(BlendMode::SrcOver);
+
+    std::vector<std::unique_ptr<pri::PolygonPrimitive>> primitives;
+    for (size_t i = 0; i < polygons.size(); ++i)
+    {
+        primitives.push_back(std::make_unique<pri::PolygonPrimitive>(polygons[i], color));
+    }
+    MeasureFrames("analytic coverage", kFrames, [&]() {
+        renderer.Clear();
+        for (const auto& polygon : primitives)
         {
-            t = static_cast<float>((result_point.X() - point1.X())) / (static_cast<float>(point2.X() - point1.X()));
+            renderer.Draw(*polygon);
         }
-        else if (point1.Y() != point2.Y())
+    });
+
+    // 16x 超采样：每个像素 4x4 个样本，逐样本做非零环绕测试
+    auto winding = [](const std::vector<Point2f>& polygon, float px, float py)
+    {
+        int w = 0;
+        for (size_t i = 0; i < polygon.size(); ++i)
         {
-            t = static_cast<float>((result_point.Y() - point1.Y())) / (static_cast<float>(point2.Y() - point1.Y()));
+            const Point2f& a = polygon[i];
+            const Point2f& b = polygon[(i + 1) % polygon.size()];
+            const float cross = (b.X() - a.X()) * (py - a.Y()) - (px - a.X()) * (b.Y() - a.Y());
+            if (a.Y() <= py && b.Y() > py && cross > 0)
+            {
+                ++w;
+            }
+            else if (a.Y() > py && b.Y() <= py && cross < 0)
+            {
+                --w;
+            }
         }
+        return w;
+    };
+    MeasureFrames("SSAA 16x", kFrames, [&]() {
+        renderer.Clear();
+        for (size_t i = 0; i < polygons.size(); ++i)
+        {
+            const auto& polygon = polygons[i];
+            float min_x = polygon[0].X(), max_x = min_x, min_y = polygon[0].Y(), max_y = min_y;
+            for (const auto& p : polygon)
+            {
+                min_x = std::min(min_x, p.X());
+                max_x = std::max(max_x, p.X());
+                min_y = std::min(min_y, p.Y());
+                max_y = std::max(max_y, p.Y());
+            }
+            const int x0 = std::max(static_cast<int>(std::floor(min_x)), 0);
+            const int x1 = std::min(static_cast<int>(std::ceil(max_x)), g_width - 1);
+            const int y0 = std::max(static_cast<int>(std::floor(min_y)), 0);
+            const int y1 = std::min(static_cast<int>(std::ceil(max_y)), g_height - 1);
+            for (int y = y0; y <= y1; ++y)
+            {
+                for (int x = x0; x <= x1; ++x)
+                {
+                    int inside = 0;
+                    for (int s = 0; s < 16; ++s)
+                    {
+                        const float px = static_cast<float>(x) - 0.375f + 0.25f * static_cast<float>(s % 4);
+                        const float py = static_cast<float>(y) - 0.375f + 0.25f * static_cast<float>(s / 4);
+                        inside += winding(polygon, px, py) != 0;
+                    }
+                    buffer.BlendPixel(x, y, color, static_cast<uint8_t>(inside * 255 / 16));
+                }
+            }
+        }
+    });
+}
 
-        Color color = Color::Lerp(point1.GetColor(), point2.GetColor(), t);
-        result_point.SetColor(color);
+void BenchmarkPolyline()
+{
+    constexpr int kSegments = 100000;
+    constexpr int kFrames = 10;
+
+    // 模拟图表叠加层：横跨整个屏幕的随机游走折线
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> step(-3.0f, 3.0f);
+    std::vector<Point2f> points;
+    points.reserve(kSegments + 1);
+    float y = g_height / 2.0f;
+    for (int i = 0; i <= kSegments; ++i)
+    {
+        y = std::clamp(y + step(rng), 10.0f, g_height - 10.0f);
+        points.emplace_back(static_cast<float>(i) * g_width / kSegments, y);
+    }
 
-        renderer.DrawPoint(result_point);
+    PixelsBuffer buffer(g_width, g_height);
+    GraphicsRenderer renderer(buffer);
+    const std::pair<const char*, pri::LineJoin> joins[] = {
+        {"miter", pri::LineJoin::Miter}, {"round", pri::LineJoin::Round}, {"bevel", pri::LineJoin::Bevel}};
+    for (const auto& [name, join] : joins)
+    {
+        pri::PolylinePrimitive polyline(points, 2.0f, Color::White());
+        polyline.SetJoin(join);
+        const double ms = TimeFrames(kFrames, [&]() {
+            // 每帧重新设置顶点，计入展开三角形带的开销
+            polyline.SetPoints(points);
+            renderer.Clear();
+            renderer.Draw(polyline);
+        });
+        std::cout << "polyline " << kSegments << " segments, " << name << " join: " << ms << " ms/frame ("
+                  << polyline.Strip().size() << " strip vertices)" << std::endl;
     }
 }
 
+void BenchmarkBresenham()
+{
+    constexpr int kLines = 20000;
+    constexpr int kFrames = 10;
+
+    // 斜率在 [0, 1/8] 内的平缓直线（方向随机），以及交换 xy 得到的陡峭直线
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> length(200, g_height - 1);
+    std::uniform_real_distribution<float> slope(0.0f, 1.0f / 8.0f);
+    std::uniform_int_distribution<int> sign(0, 1);
+    std::vector<std::array<int, 4>> shallow(kLines);
+    for (auto& l : shallow)
+    {
+        const int dx = length(rng);
+        const int dy = static_cast<int>(static_cast<float>(dx) * slope(rng));
+        l[0] = std::uniform_int_distribution<int>(0, g_width - 1 - dx)(rng);
+        l[1] = std::uniform_int_distribution<int>(0, g_height - 1 - dy)(rng);
+        l[2] = l[0] + dx;
+        l[3] = l[1] + dy;
+        if (sign(rng))
+        {
+            std::swap(l[0], l[2]);
+        }
+        if (sign(rng))
+        {
+            std::swap(l[1], l[3]);
+        }
+    }
+    std::vector<std::array<int, 4>> steep(kLines);
+    for (size_t i = 0; i < steep.size(); ++i)
+    {
+        const auto& l = shallow[i];
+        steep[i] = {l[1], std::min(l[0], g_height - 1), l[3], std::min(l[2], g_height - 1)};
+    }
+
+    // 原来的逐像素 Bresenham（每个像素一次边界检查）
+    auto per_pixel = [](PixelsBuffer& buffer, const std::array<int, 4>& l, const Color& color)
+    {
+        int dx = std::abs(l[2] - l[0]);
+        int dy = std::abs(l[3] - l[1]);
+        int sx = l[0] < l[2] ? 1 : -1;
+        int sy = l[1] < l[3] ? 1 : -1;
+        int err = dx - dy;
+        int x = l[0];
+        int y = l[1];
+        while (true)
+        {
+            buffer.BlendPixel(x, y, color);
+            if (x == l[2] && y == l[3])
+                break;
+            int e2 = 2 * err;
+            if (e2 > -dy)
+            {
+                err -= dy;
+                x += sx;
+            }
+            if (e2 < dx)
+            {
+                err += dx;
+                y += sy;
+            }
+        }
+    };
+
+    const Color color(255, 0, 0, 160);
+    PixelsBuffer reference(g_width, g_height);
+    PixelsBuffer buffer(g_width, g_height);
+    GraphicsRenderer renderer(buffer);
+
+    for (const auto* lines : {&shallow, &steep})
+    {
+        const char* kind = lines == &shallow ? "shallow" : "steep";
+        std::cout << kind << " lines:" << std::endl;
+        MeasureFrames("  per-pixel", kFrames, [&]() {
+            reference.Clear(Color::Black());
+            for (size_t i = 0; i < lines->size(); ++i)
+            {
+                per_pixel(reference, (*lines)[i], color);
+            }
+        });
+        MeasureFrames("  run-slice", kFrames, [&]() {
+            renderer.Clear();
+            for (size_t i = 0; i < lines->size(); ++i)
+            {
+                const auto& l = (*lines)[i];
+                renderer.DrawLine(l[0], l[1], l[2], l[3], color);
+            }
+        });
+        const bool identical = std::equal(reference.Pixels(), reference.Pixels() + g_width * g_height, buffer.Pixels());
+        std::cout << "  identical: " << (identical ? "yes" : "no") << std::endl;
+    }
+}
+
+void BenchmarkLineBatch()
+{
+    constexpr int kLines = 1000000;
+    constexpr int kFrames = 5;
+
+    // 百万条短线段（线框 / 点云连接图的典型长度），约 2% 的端点落在屏幕外
+    std::mt19937 rng(13);
+    std::uniform_int_distribution<int> px(-10, g_width + 10);
+    std::uniform_int_distribution<int> py(-10, g_height + 10);
+    std::uniform_int_distribution<int> offset(-24, 24);
+    std::vector<std::array<int, 4>> lines(kLines);
+    for (auto& l : lines)
+    {
+        l[0] = px(rng);
+        l[1] = py(rng);
+        l[2] = l[0] + offset(rng);
+        l[3] = l[1] + offset(rng);
+    }
+
+    // 半透明颜色，同时检查混合顺序是否与逐条绘制一致
+    const Color colors[] = {Color(255, 0, 0, 160), Color(0, 255, 0, 160), Color(0, 0, 255, 160),
+                            Color(255, 255, 0, 160)};
+    PixelsBuffer reference(g_width, g_height);
+    PixelsBuffer buffer(g_width, g_height);
+    GraphicsRenderer renderer(reference);
+    reference.SetBlendMode(BlendMode::SrcOver);
+    buffer.SetBlendMode(BlendMode::SrcOver);
+
+    MeasureFrames("DrawLine per call", kFrames, [&]() {
+        reference.Clear(Color::Black());
+        for (size_t i = 0; i < lines.size(); ++i)
+        {
+            const auto& l = lines[i];
+            renderer.DrawLine(l[0], l[1], l[2], l[3], colors[i % 4]);
+        }
+    });
+
+    pri::LineBatch batch;
+    batch.Reserve(kLines);
+    for (int threads : {1, 0})
+    {
+        batch.SetThreadCount(threads);
+        MeasureFrames(threads == 1 ? "LineBatch 1 thread" : "LineBatch all threads", kFrames, [&]() {
+            buffer.Clear(Color::Black());
+            batch.Clear();
+            for (size_t i = 0; i < lines.size(); ++i)
+            {
+                const auto& l = lines[i];
+                batch.Add(l[0], l[1], l[2], l[3], colors[i % 4]);
+            }
+            batch.Draw(buffer);
+        });
+        const bool identical = std::equal(reference.Pixels(), reference.Pixels() + g_width * g_height, buffer.Pixels());
+        std::cout << "  identical: " << (identical ? "yes" : "no") << std::endl;
+    }
+}
+
+void BenchmarkPointCloud()
+{
+    constexpr int kPoints = 10000000;
+    constexpr int kFrames = 5;
+
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> px(0.0f, static_cast<float>(g_width));
+    std::uniform_real_distribution<float> py(0.0f, static_cast<float>(g_height));
+    std::uniform_int_distribution<int> channel(0, 255);
+    std::vector<math::Point2f> positions(kPoints);
+    std::vector<Color> colors(kPoints);
+    std::vector<float> depths(kPoints);
+    for (int i = 0; i < kPoints; ++i)
+    {
+        positions[i] = math::Point2f(px(rng), py(rng));
+        colors[i] = Color(channel(rng), channel(rng), channel(rng), 64);
+        depths[i] = static_cast<float>(channel(rng));
+    }
+
+    PixelsBuffer buffer(g_width, g_height);
+    buffer.SetBlendMode(BlendMode::Additive);
+    pri::PointCloudPrimitive cloud(std::move(positions), std::move(colors));
+    cloud.SetDepths(std::move(depths));
+
+    auto measure = [&](const char* name)
+    {
+        for (int threads : {1, 0})
+        {
+            cloud.SetThreadCount(threads);
+            cloud.Draw(buffer); // 预热（分配分箱缓冲）
+            const double ms = TimeFrames(kFrames, [&]() { cloud.Draw(buffer); });
+            std::cout << name << (threads == 1 ? " (1 thread): " : " (all threads): ") << ms << " ms/frame, "
+                      << kPoints / ms / 1000.0 << " M points/s" << std::endl;
+        }
+    };
+
+    measure("1px additive");
+    cloud.SetSplatSize(3);
+    measure("3x3 additive");
+    cloud.SetSplatSize(5);
+    cloud.SetSplatShape(pri::SplatShape::Round);
+    measure("round 5px additive");
+    cloud.SetSplatSize(1);
+    cloud.SetDepthTest(true);
+    measure("1px depth test");
+}
+
 void TestRenderer(GraphicsRenderer& renderer, Sdl2Window* window)
 {
 #if 0
@@ -262,21 +758,21 @@ void TestRenderer(GraphicsRenderer& renderer, Sdl2Window* window)
 
 #if 0
 
-    // Bresenham 直线算法
+    // Bresenham 直线算法（两个端点颜色不同时由 LinePrimitive 逐像素渐变）
 
     // x1 < x2 y1 < y2, k > 1 (红色到黄色)
     pri::PointPrimitive start_point{10, 100, Color::Red()};
     pri::PointPrimitive end_point{100, 500, Color::Yellow()};
-    BresenhamLine(start_point, end_point, renderer);
+    renderer.DrawLine(start_point, end_point);
     // x1 < x2 y1 > y2, k > 1 (青色到洋红)
     start_point = {10, 500, Color::Cyan()};
     end_point = {100, 100, Color::Magenta()};
-    BresenhamLine(start_point, end_point, renderer);
+    renderer.DrawLine(start_point, end_point);
 
     // x1 > x2, y1 > y2, k > 1 (粉色到紫色)
     start_point = {100, 400, Color::Pink()};
     end_point = {50, 100, Color::Purple()};
-    BresenhamLine(start_point, end_point, renderer);
+    renderer.DrawLine(start_point, end_point);
 
     start_point = {400, 100, Color::Green()};
     end_point = {90, 420};
@@ -297,7 +793,7 @@ void TestRenderer(GraphicsRenderer& renderer, Sdl2Window* window)
                                Color{static_cast<unsigned char>(rand() % 255), static_cast<unsigned char>(rand() % 255),
                                      static_cast<unsigned char>(rand() % 255), 255}};
         // renderer.DrawLine(c, pt); // 从圆心画线到圆周
-        BresenhamLine(c, pt, renderer);
+        renderer.DrawLine(c, pt);
         // renderer.DrawAntialiasedLine(c, pt);
     }
 
@@ -314,6 +810,30 @@ void TestRenderer(GraphicsRenderer& renderer, Sdl2Window* window)
 
 #endif
 
+#if 0 // 圆 / 椭圆 / 圆角矩形：上排不抗锯齿，下排抗锯齿
+
+    for (int row = 0; row < 2; ++row)
+    {
+        const bool antialiased = row == 1;
+        const float y = 120.0f + 250.0f * static_cast<float>(row);
+
+        pri::CirclePrimitive disc{{120.0f, y}, 80.0f, Color::Red(), true, antialiased};
+        renderer.Draw(disc);
+        pri::CirclePrimitive ring{{320.0f, y}, 80.0f, Color::Green(), false, antialiased};
+        ring.SetStrokeWidth(6.0f);
+        renderer.Draw(ring);
+
+        pri::EllipsePrimitive ellipse{{560.0f, y}, 120.0f, 60.0f, Color::Blue(), true, antialiased};
+        renderer.Draw(ellipse);
+
+        pri::RoundedRectPrimitive card{{720.0f, y - 80.0f}, 220.0f, 160.0f, 24.0f, Color::Yellow(), false,
+                                       antialiased};
+        card.SetStrokeWidth(3.0f);
+        renderer.Draw(card);
+    }
+
+#endif
+
 #if 0 // 三角形加载纹理和重心插值颜色变化测试
 
     math::Point2i p1{400, 500};
@@ -363,6 +883,29 @@ void TestRenderer(GraphicsRenderer& renderer, Sdl2Window* window)
 
 #endif
 
+#if 0 // 矢量路径：贝塞尔曲线填充与描边（替代用大量 LinePrimitive 拼接曲线）
+    renderer.SetBlendMode(BlendMode::SrcOver);
+    pri::PathPrimitive path{Color::Orange()};
+    path.MoveTo(0, -120)
+        .CubicTo(70, -200, 200, -90, 0, 120)
+        .CubicTo(-200, -90, -70, -200, 0, -120)
+        .Close();
+    path.SetStroke(Color::White(), 4.0f);
+    path.SetTransform(math::Affine2f::Translation(g_width / 2.0f, g_height / 2.0f) *
+                      math::Affine2f::Rotation(static_cast<float>(DEG2RAD(15))));
+    renderer.Draw(path);
+
+    pri::PathPrimitive wave;
+    wave.SetFilled(false);
+    wave.SetStroke(Color::Cyan(), 2.0f);
+    wave.MoveTo(50, 520);
+    for (int i = 0; i < 7; ++i)
+    {
+        wave.QuadTo(100.0f + 100.0f * i, i % 2 == 0 ? 440.0f : 600.0f, 150.0f + 100.0f * i, 520.0f);
+    }
+    renderer.Draw(wave);
+#endif
+
 #if 1 // 跑马灯效果测试（UV 按速度增加）
     pri::TrianglePrimitive triangle_right{{600, 500}, {600, 10}, {200, 10}};
     pri::TrianglePrimitive triangle_left{{200, 500}, {600, 500}, {200, 10}};
@@ -387,8 +930,8 @@ void TestRenderer(GraphicsRenderer& renderer, Sdl2Window* window)
 
     // if (window)
     // {
-    //     renderer.AddPrimitive(triangle_left.Clone());
-    //     renderer.AddPrimitive(triangle_right.Clone());
+    //     renderer.AddPrimitive(triangle_left);
+    //     renderer.AddPrimitive(triangle_right);
     //     renderer.DrawAllPrimitives();
     //     window->SetFrameCallback(
     //         [texture](GraphicsRenderer& r, float dt)
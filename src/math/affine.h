@@ -0,0 +1,191 @@
+//
+// Created by admin on 2026/2/9.
+//
+
+#ifndef AFFINE_H
+#define AFFINE_H
+
+#include "point.h"
+#include <algorithm>
+#include <cmath>
+
+namespace math
+{
+
+/**
+ * @brief 二维仿射变换类模板（2x3 矩阵）
+ *
+ *   | a  c  tx |   | x |
+ *   | b  d  ty | * | y |
+ *                  | 1 |
+ *
+ * @tparam T 数据类型（如float, double等）
+ */
+template <class T> class Affine2
+{
+  public:
+    /**
+     * @brief 默认构造函数，初始化为单位变换
+     */
+    Affine2() : _a(1), _b(0), _c(0), _d(1), _tx(0), _ty(0) {}
+
+    /**
+     * @brief 参数化构造函数
+     */
+    Affine2(T a, T b, T c, T d, T tx, T ty) : _a(a), _b(b), _c(c), _d(d), _tx(tx), _ty(ty) {}
+
+    /**
+     * @brief 单位变换
+     */
+    static Affine2 Identity()
+    {
+        return Affine2();
+    }
+
+    /**
+     * @brief 平移变换
+     */
+    static Affine2 Translation(T tx, T ty)
+    {
+        return Affine2(1, 0, 0, 1, tx, ty);
+    }
+
+    /**
+     * @brief 缩放变换
+     */
+    static Affine2 Scale(T sx, T sy)
+    {
+        return Affine2(sx, 0, 0, sy, 0, 0);
+    }
+
+    /**
+     * @brief 旋转变换（弧度，屏幕坐标系下 y 轴向下时为顺时针）
+     */
+    static Affine2 Rotation(T radians)
+    {
+        const T cos_r = static_cast<T>(std::cos(radians));
+        const T sin_r = static_cast<T>(std::sin(radians));
+        return Affine2(cos_r, sin_r, -sin_r, cos_r, 0, 0);
+    }
+
+    // 获取矩阵元素
+    T A() const
+    {
+        return _a;
+    }
+    T B() const
+    {
+        return _b;
+    }
+    T C() const
+    {
+        return _c;
+    }
+    T D() const
+    {
+        return _d;
+    }
+    T Tx() const
+    {
+        return _tx;
+    }
+    T Ty() const
+    {
+        return _ty;
+    }
+
+    /**
+     * @brief 变换一个点
+     */
+    Point2<T> Apply(const Point2<T>& p) const
+    {
+        return Point2<T>(_a * p.X() + _c * p.Y() + _tx, _b * p.X() + _d * p.Y() + _ty);
+    }
+
+    /**
+     * @brief 变换一个向量（忽略平移）
+     */
+    Vector2<T> ApplyVector(const Vector2<T>& v) const
+    {
+        return Vector2<T>(_a * v[0] + _c * v[1], _b * v[0] + _d * v[1]);
+    }
+
+    /**
+     * @brief 组合变换：结果等价于先应用 other，再应用 *this
+     */
+    Affine2 operator*(const Affine2& other) const
+    {
+        return Affine2(_a * other._a + _c * other._b, _b * other._a + _d * other._b, _a * other._c + _c * other._d,
+                       _b * other._c + _d * other._d, _a * other._tx + _c * other._ty + _tx,
+                       _b * other._tx + _d * other._ty + _ty);
+    }
+
+    /**
+     * @brief 行列式
+     */
+    T Determinant() const
+    {
+        return _a * _d - _b * _c;
+    }
+
+    /**
+     * @brief 是否可逆
+     */
+    bool IsInvertible() const
+    {
+        return Determinant() != 0;
+    }
+
+    /**
+     * @brief 逆变换（不可逆时返回单位变换）
+     */
+    Affine2 Inverse() const
+    {
+        const T det = Determinant();
+        if (det == 0)
+        {
+            return Affine2();
+        }
+        const T inv = static_cast<T>(1) / det;
+        const T a = _d * inv;
+        const T b = -_b * inv;
+        const T c = -_c * inv;
+        const T d = _a * inv;
+        return Affine2(a, b, c, d, -(a * _tx + c * _ty), -(b * _tx + d * _ty));
+    }
+
+    /**
+     * @brief 变换对长度的最大放大倍数（矩阵的最大奇异值）
+     * 用于把屏幕空间的容差换算到局部坐标
+     */
+    T MaxScale() const
+    {
+        const T p = _a * _a + _b * _b + _c * _c + _d * _d;
+        const T q = Determinant();
+        const T disc = std::sqrt(std::max(p * p / 4 - q * q, static_cast<T>(0)));
+        return static_cast<T>(std::sqrt(p / 2 + disc));
+    }
+
+    bool operator==(const Affine2& other) const
+    {
+        return _a == other._a && _b == other._b && _c == other._c && _d == other._d && _tx == other._tx &&
+               _ty == other._ty;
+    }
+
+    bool operator!=(const Affine2& other) const
+    {
+        return !(*this == other);
+    }
+
+  private:
+    T _a, _b, _c, _d;
+    T _tx, _ty;
+};
+
+// 常用类型别名
+using Affine2f = Affine2<float>;
+using Affine2d = Affine2<double>;
+
+} // namespace math
+
+#endif // AFFINE_H
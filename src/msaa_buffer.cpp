@@ -0,0 +1,273 @@
+//
+// Created by admin on 2026/2/5.
+//
+
+#include "msaa_buffer.h"
+#include "pixels_buffer.h"
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+
+// 标准采样位置（与 D3D 的 4x / 8x 模式一致），单位 1/16 像素，相对于像素中心
+constexpr int kPattern4[4][2] = {{-2, -6}, {6, -2}, {-6, 2}, {2, 6}};
+constexpr int kPattern8[8][2] = {{1, -3}, {-1, 3}, {5, 1}, {-3, -5}, {-5, 5}, {-7, -1}, {3, 7}, {7, -7}};
+
+} // namespace
+
+MsaaBuffer::MsaaBuffer(int width, int height, int samples)
+    : _width(width), _height(height), _samples(samples >= 8 ? 8 : 4),
+      _tiles_x((width + kTileSize - 1) / kTileSize), _tiles_y((height + kTileSize - 1) / kTileSize)
+{
+    assert(width > 0 && height > 0);
+    for (int i = 0; i < _samples; ++i)
+    {
+        const int* offset = _samples == 8 ? kPattern8[i] : kPattern4[i];
+        _offsets_x[i] = static_cast<float>(offset[0]) / 16.0f;
+        _offsets_y[i] = static_cast<float>(offset[1]) / 16.0f;
+    }
+    _tiles.resize(static_cast<size_t>(_tiles_x) * _tiles_y);
+}
+
+void MsaaBuffer::WritePixel(PixelsBuffer& buffer, int x, int y, uint32_t mask, uint32_t premultiplied)
+{
+    if (mask == 0 || !buffer.IsWritable(x, y))
+    {
+        return;
+    }
+
+    Tile& tile = TileAt(x, y);
+    uint16_t& state = tile.state[LocalIndex(x, y)];
+    uint32_t& pixel = buffer.PixelsForRegion(x, y, x + 1, y + 1)[static_cast<size_t>(y) * buffer.Width() + x];
+    const BlendMode mode = buffer.GetBlendMode();
+
+    // 内部像素：直接写帧缓冲，不占用样本存储
+    if (state == kStateSimple && mask == FullMask())
+    {
+        pixel = Blender::BlendPixel(pixel, premultiplied, mode);
+        return;
+    }
+
+    uint32_t samples[kMaxSamples];
+    LoadSamples(tile, state, pixel, samples);
+    for (int i = 0; i < _samples; ++i)
+    {
+        if (mask & (1u << i))
+        {
+            samples[i] =
+                mode == BlendMode::Replace ? premultiplied : Blender::BlendPixel(samples[i], premultiplied, mode);
+        }
+    }
+    state = StoreSamples(tile, state, samples, pixel);
+}
+
+void MsaaBuffer::Resolve(PixelsBuffer& buffer)
+{
+    uint32_t* pixels = buffer.Pixels();
+    uint32_t samples[kMaxSamples];
+
+    for (int ty = 0; ty < _tiles_y; ++ty)
+    {
+        for (int tx = 0; tx < _tiles_x; ++tx)
+        {
+            Tile& tile = _tiles[static_cast<size_t>(ty) * _tiles_x + tx];
+            if (tile.complex_count == 0)
+            {
+                continue;
+            }
+
+            for (int local = 0; local < kTileSize * kTileSize; ++local)
+            {
+                const uint16_t state = tile.state[local];
+                if (state == kStateSimple)
+                {
+                    continue;
+                }
+                const int x = tx * kTileSize + local % kTileSize;
+                const int y = ty * kTileSize + local / kTileSize;
+                uint32_t& pixel = pixels[static_cast<size_t>(y) * _width + x];
+                LoadSamples(tile, state, pixel, samples);
+
+                // 逐通道求平均（四舍五入）
+                uint32_t resolved = 0;
+                for (int shift = 0; shift < 32; shift += 8)
+                {
+                    uint32_t sum = 0;
+                    for (int i = 0; i < _samples; ++i)
+                    {
+                        sum += (samples[i] >> shift) & 0xFFu;
+                    }
+                    resolved |= ((sum + _samples / 2) / _samples) << shift;
+                }
+                pixel = resolved;
+            }
+
+            tile.state.fill(kStateSimple);
+            tile.compact.clear();
+            tile.compact_free.clear();
+            tile.expanded.clear();
+            tile.expanded_free.clear();
+            tile.complex_count = 0;
+        }
+    }
+}
+
+void MsaaBuffer::Clear()
+{
+    for (auto& tile : _tiles)
+    {
+        if (tile.complex_count == 0)
+        {
+            continue;
+        }
+        tile.state.fill(kStateSimple);
+        tile.compact.clear();
+        tile.compact_free.clear();
+        tile.expanded.clear();
+        tile.expanded_free.clear();
+        tile.complex_count = 0;
+    }
+}
+
+size_t MsaaBuffer::SampleMemoryBytes() const
+{
+    size_t bytes = _tiles.size() * sizeof(Tile);
+    for (const auto& tile : _tiles)
+    {
+        bytes += tile.compact.capacity() * sizeof(CompactPixel) + tile.expanded.capacity() * sizeof(uint32_t) +
+                 (tile.compact_free.capacity() + tile.expanded_free.capacity()) * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+void MsaaBuffer::LoadSamples(const Tile& tile, uint16_t state, uint32_t simple_color, uint32_t* samples) const
+{
+    if (state == kStateSimple)
+    {
+        std::fill_n(samples, _samples, simple_color);
+    }
+    else if (state & kStateExpanded)
+    {
+        const size_t slot = state & ~kStateExpanded;
+        std::copy_n(&tile.expanded[slot * _samples], _samples, samples);
+    }
+    else
+    {
+        const CompactPixel& compact = tile.compact[state - 1];
+        for (int i = 0; i < _samples; ++i)
+        {
+            samples[i] = compact.colors[(compact.mask >> i) & 1u];
+        }
+    }
+}
+
+uint16_t MsaaBuffer::StoreSamples(Tile& tile, uint16_t state, const uint32_t* samples, uint32_t& simple_color)
+{
+    // 统计不同颜色的个数（最多关心 3 种）
+    const uint32_t c0 = samples[0];
+    uint32_t c1 = c0;
+    bool has_c1 = false;
+    bool has_third = false;
+    uint8_t mask = 0;
+    for (int i = 1; i < _samples; ++i)
+    {
+        if (samples[i] == c0)
+        {
+            continue;
+        }
+        if (!has_c1)
+        {
+            c1 = samples[i];
+            has_c1 = true;
+        }
+        if (samples[i] != c1)
+        {
+            has_third = true;
+            break;
+        }
+        mask |= static_cast<uint8_t>(1u << i);
+    }
+
+    // 所有样本相同：回到简单像素
+    if (!has_c1)
+    {
+        if (state != kStateSimple)
+        {
+            ReleaseSlot(tile, state);
+            --tile.complex_count;
+        }
+        simple_color = c0;
+        return kStateSimple;
+    }
+
+    if (state == kStateSimple)
+    {
+        ++tile.complex_count;
+    }
+
+    if (!has_third)
+    {
+        // 两种颜色：压缩存储
+        if (state == kStateSimple || (state & kStateExpanded))
+        {
+            if (state != kStateSimple)
+            {
+                ReleaseSlot(tile, state);
+            }
+            uint16_t slot;
+            if (!tile.compact_free.empty())
+            {
+                slot = tile.compact_free.back();
+                tile.compact_free.pop_back();
+            }
+            else
+            {
+                slot = static_cast<uint16_t>(tile.compact.size());
+                tile.compact.push_back({});
+            }
+            state = static_cast<uint16_t>(slot + 1);
+        }
+        CompactPixel& compact = tile.compact[state - 1];
+        compact.colors[0] = c0;
+        compact.colors[1] = c1;
+        compact.mask = mask;
+        return state;
+    }
+
+    // 三种及以上颜色：展开存储
+    if (!(state & kStateExpanded))
+    {
+        if (state != kStateSimple)
+        {
+            ReleaseSlot(tile, state);
+        }
+        uint16_t slot;
+        if (!tile.expanded_free.empty())
+        {
+            slot = tile.expanded_free.back();
+            tile.expanded_free.pop_back();
+        }
+        else
+        {
+            slot = static_cast<uint16_t>(tile.expanded.size() / _samples);
+            tile.expanded.resize(tile.expanded.size() + _samples);
+        }
+        state = static_cast<uint16_t>(kStateExpanded | slot);
+    }
+    const size_t slot = state & ~kStateExpanded;
+    std::copy_n(samples, _samples, &tile.expanded[slot * _samples]);
+    return state;
+}
+
+void MsaaBuffer::ReleaseSlot(Tile& tile, uint16_t state)
+{
+    if (state & kStateExpanded)
+    {
+        tile.expanded_free.push_back(static_cast<uint16_t>(state & ~kStateExpanded));
+    }
+    else
+    {
+        tile.compact_free.push_back(static_cast<uint16_t>(state - 1));
+    }
+}
@@ -0,0 +1,159 @@
+//
+// Created by admin on 2026/2/5.
+//
+
+#ifndef MSAA_BUFFER_H
+#define MSAA_BUFFER_H
+
+#include "blender.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class PixelsBuffer;
+
+/**
+ * @brief 多重采样（MSAA）样本缓冲区
+ * 职责：
+ *   1. 记录三角形边缘像素的多个样本颜色（每像素着色一次，按覆盖掩码写入样本）
+ *   2. 在呈现前把边缘像素的样本求平均（Resolve）写回 PixelsBuffer
+ *
+ * 设计思路：
+ *   - 完全覆盖的内部像素不需要样本，直接写入 PixelsBuffer（"简单像素"）
+ *   - 只有部分覆盖的边缘像素才分配样本存储，存储按 8x8 的 tile 组织
+ *   - 边缘像素通常只包含两种颜色（内外各一），用 "两种颜色 + 样本掩码" 压缩存储，
+ *     出现第三种颜色时才展开为完整的 N 个样本
+ *
+ * 注意：Resolve 会用样本平均值覆盖边缘像素，在两次 Resolve 之间直接写入这些像素的
+ *       非三角形图元（如直线）会被覆盖。
+ */
+class MsaaBuffer
+{
+  public:
+    static constexpr int kTileSize = 8;
+    static constexpr int kMaxSamples = 8;
+
+    /**
+     * @param width 宽度（与 PixelsBuffer 一致）
+     * @param height 高度
+     * @param samples 每像素样本数（4 或 8）
+     */
+    MsaaBuffer(int width, int height, int samples);
+
+    int Width() const
+    {
+        return _width;
+    }
+    int Height() const
+    {
+        return _height;
+    }
+    int Samples() const
+    {
+        return _samples;
+    }
+
+    /**
+     * @brief 所有样本都被覆盖时的掩码
+     */
+    uint32_t FullMask() const
+    {
+        return (1u << _samples) - 1u;
+    }
+
+    /**
+     * @brief 第 index 个样本相对于像素中心的偏移（单位：像素）
+     */
+    float SampleOffsetX(int index) const
+    {
+        return _offsets_x[index];
+    }
+    float SampleOffsetY(int index) const
+    {
+        return _offsets_y[index];
+    }
+
+    /**
+     * @brief 像素是否只有一个颜色（没有样本存储）
+     */
+    bool IsSimple(int x, int y) const
+    {
+        return TileAt(x, y).state[LocalIndex(x, y)] == kStateSimple;
+    }
+
+    /**
+     * @brief 按覆盖掩码写入一个像素（颜色已在像素级着色一次）
+     * @param buffer 目标像素缓冲区（简单像素的颜色存放在这里）
+     * @param mask 覆盖掩码，第 i 位表示第 i 个样本被覆盖
+     * @param premultiplied 颜色（预乘 alpha）
+     */
+    void WritePixel(PixelsBuffer& buffer, int x, int y, uint32_t mask, uint32_t premultiplied);
+
+    /**
+     * @brief 将边缘像素的样本求平均写回缓冲区，并释放所有样本存储
+     */
+    void Resolve(PixelsBuffer& buffer);
+
+    /**
+     * @brief 丢弃所有样本（清屏时调用）
+     */
+    void Clear();
+
+    /**
+     * @brief 当前样本存储占用的字节数（用于统计内存）
+     */
+    size_t SampleMemoryBytes() const;
+
+  private:
+    static constexpr uint16_t kStateSimple = 0;
+    static constexpr uint16_t kStateExpanded = 0x8000; // 最高位为 1 表示展开存储，低位是槽位索引
+
+    // 压缩的边缘像素：两种颜色 + 掩码（第 i 位为 1 表示第 i 个样本使用 colors[1]）
+    struct CompactPixel
+    {
+        uint32_t colors[2];
+        uint8_t mask;
+    };
+
+    struct Tile
+    {
+        std::array<uint16_t, kTileSize * kTileSize> state{}; // 0 = 简单像素，其余为槽位索引 + 1
+        std::vector<CompactPixel> compact;
+        std::vector<uint16_t> compact_free;
+        std::vector<uint32_t> expanded; // 每个槽位 _samples 个颜色
+        std::vector<uint16_t> expanded_free;
+        int complex_count = 0;
+    };
+
+    Tile& TileAt(int x, int y)
+    {
+        return _tiles[static_cast<size_t>(y / kTileSize) * _tiles_x + x / kTileSize];
+    }
+    const Tile& TileAt(int x, int y) const
+    {
+        return _tiles[static_cast<size_t>(y / kTileSize) * _tiles_x + x / kTileSize];
+    }
+    static int LocalIndex(int x, int y)
+    {
+        return (y % kTileSize) * kTileSize + x % kTileSize;
+    }
+
+    // 读出像素的全部样本
+    void LoadSamples(const Tile& tile, uint16_t state, uint32_t simple_color, uint32_t* samples) const;
+
+    // 把样本重新压缩存回 tile，返回新的状态；若所有样本相同则写回 simple_color 并返回简单状态
+    uint16_t StoreSamples(Tile& tile, uint16_t state, const uint32_t* samples, uint32_t& simple_color);
+
+    void ReleaseSlot(Tile& tile, uint16_t state);
+
+    int _width;
+    int _height;
+    int _samples;
+    int _tiles_x;
+    int _tiles_y;
+    std::array<float, kMaxSamples> _offsets_x{};
+    std::array<float, kMaxSamples> _offsets_y{};
+    std::vector<Tile> _tiles;
+};
+
+#endif // MSAA_BUFFER_H
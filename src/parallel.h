@@ -0,0 +1,74 @@
+//
+// Created by admin on 2026/2/12.
+//
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "job_system.h"
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 批量图元共用的简单并行工具
+ *
+ * 批量图元（LineBatch、PointCloudPrimitive）按屏幕瓦片划分工作，每个线程独占自己的瓦片，
+ * 这里只负责决定线程数并把任务分发到线程上。调用线程属于某个 JobSystem 时任务作为作业分发，
+ * 不再临时创建线程。
+ */
+namespace parallel
+{
+
+/**
+ * @brief 计算实际使用的线程数
+ * @param requested 请求的线程数，0 表示使用硬件并发数
+ * @param work 工作量（如图元个数）
+ * @param threshold 工作量低于该值时只用调用线程
+ */
+inline int ResolveThreadCount(int requested, size_t work, size_t threshold)
+{
+    if (work < threshold)
+    {
+        return 1;
+    }
+    const int threads = requested > 0 ? requested : static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(threads, 1);
+}
+
+/**
+ * @brief 用 threads 个线程执行 task(thread_index)，调用线程执行第 0 份，返回时所有线程均已结束
+ */
+template <typename Task>
+void RunParallel(int threads, const Task& task)
+{
+    if (JobSystem* jobs = JobSystem::Current(); jobs && threads > 1)
+    {
+        Job* root = jobs->Create([]() {});
+        for (int i = 1; i < threads; ++i)
+        {
+            jobs->Submit(jobs->CreateChild(root, [&task, i]() { task(i); }));
+        }
+        jobs->Submit(root);
+        task(0);
+        jobs->Wait(root);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads > 1 ? threads - 1 : 0);
+    for (int i = 1; i < threads; ++i)
+    {
+        pool.emplace_back(task, i);
+    }
+    task(0);
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+}
+
+} // namespace parallel
+
+#endif // PARALLEL_H
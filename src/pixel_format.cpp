@@ -0,0 +1,355 @@
+//
+// Created by admin on 2026/2/19.
+//
+
+#include "pixel_format.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if COLOR_LITTLE_ENDIAN && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define PIXEL_FORMAT_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define PIXEL_FORMAT_USE_SSE2 0
+#endif
+
+namespace
+{
+
+// 8 位分量 c 对应的半精度值 c / 255，首次使用时生成
+const std::array<uint16_t, 256>& UnormHalfTable()
+{
+    static const std::array<uint16_t, 256> table = []()
+    {
+        std::array<uint16_t, 256> result{};
+        for (int i = 0; i < 256; ++i)
+        {
+            result[i] = PixelConverter::FloatToHalf(static_cast<float>(i) / 255.0f);
+        }
+        return result;
+    }();
+    return table;
+}
+
+// 半精度分量转 8 位：截断到 [0, 1] 后四舍五入
+// 去掉符号后把指数和尾数整体左移 13 位，再乘以 2^112 修正指数偏置（非规格化数也由乘法得到正确结果）；
+// 无穷大和 NaN 变为 2^16 量级的有限值，截断为 1
+constexpr float kHalfExponentAdjust = 5.192296858534828e33f; // 2^112
+
+uint8_t HalfToUnorm(uint16_t half)
+{
+    if (half & 0x8000u)
+    {
+        return 0;
+    }
+    const uint32_t bits = static_cast<uint32_t>(half) << 13;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    value *= kHalfExponentAdjust;
+    return static_cast<uint8_t>((value < 1.0f ? value : 1.0f) * 255.0f + 0.5f);
+}
+
+void RGBA8888ToRGB565(const uint32_t* src, uint16_t* dst, size_t count)
+{
+    size_t i = 0;
+#if PIXEL_FORMAT_USE_SSE2
+    // 0xRRGGBBAA -> rrrrrggggggbbbbb，每次 8 个像素
+    const __m128i mask_r = _mm_set1_epi32(0xF800);
+    const __m128i mask_g = _mm_set1_epi32(0x07E0);
+    const __m128i mask_b = _mm_set1_epi32(0x001F);
+    auto convert4 = [&](__m128i p)
+    {
+        __m128i v = _mm_and_si128(_mm_srli_epi32(p, 16), mask_r);
+        v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(p, 13), mask_g));
+        v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(p, 11), mask_b));
+        // 符号扩展后有符号饱和打包不会改变低 16 位
+        return _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+    };
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i lo = convert4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        const __m128i hi = convert4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = PixelConverter::EncodeRGB565(src[i]);
+    }
+}
+
+void RGB565ToRGBA8888(const uint16_t* src, uint32_t* dst, size_t count)
+{
+    size_t i = 0;
+#if PIXEL_FORMAT_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask5 = _mm_set1_epi32(0x1F);
+    const __m128i mask6 = _mm_set1_epi32(0x3F);
+    const __m128i alpha = _mm_set1_epi32(0xFF);
+    auto convert4 = [&](__m128i v)
+    {
+        const __m128i r = _mm_and_si128(_mm_srli_epi32(v, 11), mask5);
+        const __m128i g = _mm_and_si128(_mm_srli_epi32(v, 5), mask6);
+        const __m128i b = _mm_and_si128(v, mask5);
+        // 高位补齐低位：r8 = r << 3 | r >> 2，g8 = g << 2 | g >> 4
+        const __m128i r8 = _mm_or_si128(_mm_slli_epi32(r, 3), _mm_srli_epi32(r, 2));
+        const __m128i g8 = _mm_or_si128(_mm_slli_epi32(g, 2), _mm_srli_epi32(g, 4));
+        const __m128i b8 = _mm_or_si128(_mm_slli_epi32(b, 3), _mm_srli_epi32(b, 2));
+        __m128i p = _mm_or_si128(_mm_slli_epi32(r8, 24), _mm_slli_epi32(g8, 16));
+        p = _mm_or_si128(p, _mm_slli_epi32(b8, 8));
+        return _mm_or_si128(p, alpha);
+    };
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), convert4(_mm_unpacklo_epi16(v, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), convert4(_mm_unpackhi_epi16(v, zero)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = PixelConverter::DecodeRGB565(src[i]);
+    }
+}
+
+void RGBA8888ToA8(const uint32_t* src, uint8_t* dst, size_t count)
+{
+    size_t i = 0;
+#if PIXEL_FORMAT_USE_SSE2
+    // 取每个像素的最低字节（alpha），每次 16 个像素
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i* p = reinterpret_cast<const __m128i*>(src + i);
+        const __m128i a0 = _mm_and_si128(_mm_loadu_si128(p), mask);
+        const __m128i a1 = _mm_and_si128(_mm_loadu_si128(p + 1), mask);
+        const __m128i a2 = _mm_and_si128(_mm_loadu_si128(p + 2), mask);
+        const __m128i a3 = _mm_and_si128(_mm_loadu_si128(p + 3), mask);
+        const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = PixelConverter::EncodeA8(src[i]);
+    }
+}
+
+void A8ToRGBA8888(const uint8_t* src, uint32_t* dst, size_t count)
+{
+    size_t i = 0;
+#if PIXEL_FORMAT_USE_SSE2
+    // 字节自身交错两次得到 (a, a, a, a)，每次 16 个像素
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i lo = _mm_unpacklo_epi8(a, a);
+        const __m128i hi = _mm_unpackhi_epi8(a, a);
+        __m128i* out = reinterpret_cast<__m128i*>(dst + i);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, lo));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, lo));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, hi));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, hi));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = PixelConverter::DecodeA8(src[i]);
+    }
+}
+
+void RGBA8888ToRGBA16F(const uint32_t* src, uint16_t* dst, size_t count)
+{
+    // 每个分量查表，表只有 512 字节，始终在 L1 中
+    const uint16_t* table = UnormHalfTable().data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Color color(src[i]);
+        uint16_t* out = dst + i * 4;
+        out[0] = table[color.R()];
+        out[1] = table[color.G()];
+        out[2] = table[color.B()];
+        out[3] = table[color.A()];
+    }
+}
+
+void RGBA16FToRGBA8888(const uint16_t* src, uint32_t* dst, size_t count)
+{
+    size_t i = 0;
+#if PIXEL_FORMAT_USE_SSE2
+    // 每次 2 个像素（8 个半精度分量），转换方式与 HalfToUnorm 相同
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i magnitude_mask = _mm_set1_epi32(0x7FFF);
+    const __m128i sign_mask = _mm_set1_epi32(0x8000);
+    const __m128 adjust = _mm_set1_ps(kHalfExponentAdjust);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    auto convert = [&](__m128i h)
+    {
+        // 符号移到单精度的符号位，负数在 max 中变为 0
+        const __m128i bits = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(h, magnitude_mask), 13),
+                                          _mm_slli_epi32(_mm_and_si128(h, sign_mask), 16));
+        __m128 v = _mm_mul_ps(_mm_castsi128_ps(bits), adjust);
+        v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), one);
+        const __m128i c = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half));
+        // (r, g, b, a) -> (a, b, g, r)，打包后按小端读出即 0xRRGGBBAA
+        return _mm_shuffle_epi32(c, _MM_SHUFFLE(0, 1, 2, 3));
+    };
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        const __m128i p0 = convert(_mm_unpacklo_epi16(h, zero));
+        const __m128i p1 = convert(_mm_unpackhi_epi16(h, zero));
+        const __m128i packed = _mm_packs_epi32(p0, p1);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(packed, packed));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        const uint16_t* in = src + i * 4;
+        dst[i] = Color(HalfToUnorm(in[0]), HalfToUnorm(in[1]), HalfToUnorm(in[2]), HalfToUnorm(in[3])).ToUint32();
+    }
+}
+
+} // namespace
+
+void PixelConverter::FromRGBA8888(PixelFormat format, const uint32_t* src, void* dst, size_t count)
+{
+    switch (format)
+    {
+    case PixelFormat::RGBA8888:
+        std::memcpy(dst, src, count * sizeof(uint32_t));
+        break;
+    case PixelFormat::RGB565:
+        RGBA8888ToRGB565(src, static_cast<uint16_t*>(dst), count);
+        break;
+    case PixelFormat::A8:
+        RGBA8888ToA8(src, static_cast<uint8_t*>(dst), count);
+        break;
+    case PixelFormat::RGBA16F:
+        RGBA8888ToRGBA16F(src, static_cast<uint16_t*>(dst), count);
+        break;
+    }
+}
+
+void PixelConverter::ToRGBA8888(PixelFormat format, const void* src, uint32_t* dst, size_t count)
+{
+    switch (format)
+    {
+    case PixelFormat::RGBA8888:
+        std::memcpy(dst, src, count * sizeof(uint32_t));
+        break;
+    case PixelFormat::RGB565:
+        RGB565ToRGBA8888(static_cast<const uint16_t*>(src), dst, count);
+        break;
+    case PixelFormat::A8:
+        A8ToRGBA8888(static_cast<const uint8_t*>(src), dst, count);
+        break;
+    case PixelFormat::RGBA16F:
+        RGBA16FToRGBA8888(static_cast<const uint16_t*>(src), dst, count);
+        break;
+    }
+}
+
+void PixelConverter::Convert(PixelFormat src_format, const void* src, PixelFormat dst_format, void* dst, size_t count)
+{
+    if (src_format == dst_format)
+    {
+        std::memcpy(dst, src, count * BytesPerPixel(src_format));
+        return;
+    }
+    if (src_format == PixelFormat::RGBA8888)
+    {
+        FromRGBA8888(dst_format, static_cast<const uint32_t*>(src), dst, count);
+        return;
+    }
+    if (dst_format == PixelFormat::RGBA8888)
+    {
+        ToRGBA8888(src_format, src, static_cast<uint32_t*>(dst), count);
+        return;
+    }
+
+    // 分块经由栈上的 RGBA8888 缓冲中转，块大小保证中转数据留在 L1 中
+    constexpr size_t kChunk = 256;
+    uint32_t staging[kChunk];
+    const auto* in = static_cast<const uint8_t*>(src);
+    auto* out = static_cast<uint8_t*>(dst);
+    for (size_t done = 0; done < count; done += kChunk)
+    {
+        const size_t n = std::min(kChunk, count - done);
+        ToRGBA8888(src_format, in + done * BytesPerPixel(src_format), staging, n);
+        FromRGBA8888(dst_format, staging, out + done * BytesPerPixel(dst_format), n);
+    }
+}
+
+uint16_t PixelConverter::FloatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    constexpr uint32_t kFloatInfinity = 255u << 23;
+    constexpr uint32_t kHalfOverflow = (127u + 16u) << 23; // 2^16，舍入后超出半精度范围
+    constexpr uint32_t kDenormMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+    uint32_t half;
+    if (bits >= kHalfOverflow)
+    {
+        // 无穷大或溢出；NaN 保持为安静 NaN
+        half = bits > kFloatInfinity ? 0x7E00u : 0x7C00u;
+    }
+    else if (bits < (113u << 23))
+    {
+        // 结果为半精度非规格化数：加上魔数让浮点加法完成移位和舍入
+        float magnitude;
+        float magic;
+        std::memcpy(&magnitude, &bits, sizeof(magnitude));
+        std::memcpy(&magic, &kDenormMagic, sizeof(magic));
+        magnitude += magic;
+        std::memcpy(&bits, &magnitude, sizeof(bits));
+        half = bits - kDenormMagic;
+    }
+    else
+    {
+        // 规格化数：调整指数偏置，尾数就近舍入到偶数
+        const uint32_t mantissa_odd = (bits >> 13) & 1u;
+        bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFFu;
+        bits += mantissa_odd;
+        half = bits >> 13;
+    }
+    return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+float PixelConverter::HalfToFloat(uint16_t half)
+{
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1Fu;
+    const uint32_t mantissa = half & 0x3FFu;
+
+    uint32_t bits;
+    if (exponent == 0)
+    {
+        // 零和非规格化数：mantissa * 2^-24
+        const float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+        return sign ? -magnitude : magnitude;
+    }
+    if (exponent == 31)
+    {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    }
+    else
+    {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+uint16_t PixelConverter::UnormToHalf(uint8_t value)
+{
+    return UnormHalfTable()[value];
+}
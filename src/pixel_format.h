@@ -0,0 +1,122 @@
+//
+// Created by admin on 2026/2/19.
+//
+
+#ifndef PIXEL_FORMAT_H
+#define PIXEL_FORMAT_H
+
+#include "color.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 帧缓冲像素格式
+ *
+ * 所有格式都保存预乘 alpha 的颜色：
+ *   - RGBA8888: 32 位，与 Color::ToUint32 布局一致（光栅化使用的工作格式）
+ *   - RGB565:   16 位，r5 g6 b5，没有 alpha（相当于已经合成到黑色背景上），用于带宽受限的嵌入式显示
+ *   - A8:       8 位，只有 alpha，用于遮罩和字形覆盖率
+ *   - RGBA16F:  64 位，内存顺序为 R, G, B, A 四个半精度浮点数，不截断到 [0, 1]，用于 HDR 累加
+ */
+enum class PixelFormat
+{
+    RGBA8888,
+    RGB565,
+    A8,
+    RGBA16F
+};
+
+/**
+ * @brief 每个像素占用的字节数
+ */
+constexpr size_t BytesPerPixel(PixelFormat format)
+{
+    switch (format)
+    {
+    case PixelFormat::RGB565:
+        return 2;
+    case PixelFormat::A8:
+        return 1;
+    case PixelFormat::RGBA16F:
+        return 8;
+    case PixelFormat::RGBA8888:
+    default:
+        return 4;
+    }
+}
+
+/**
+ * @brief 像素格式转换内核
+ * 职责：
+ *   1. 在 RGBA8888（预乘）与其它格式之间按行转换，支持 SSE2 时一次处理多个像素
+ *   2. 提供单个像素的编码 / 解码（按格式模板化的绘制代码使用）
+ *   3. 提供半精度浮点数转换
+ *
+ * 约定：
+ *   - RGBA8888 -> RGB565 直接截断低位（与 SDL 一致），RGB565 -> RGBA8888 用高位补齐低位，alpha 为 255
+ *   - A8 -> RGBA8888 展开为预乘的白色遮罩 (a, a, a, a)
+ *   - RGBA16F -> 8 位格式时截断到 [0, 1] 再四舍五入（无穷大和 NaN 截断为 1）
+ */
+class PixelConverter
+{
+  public:
+    PixelConverter() = delete;
+
+    /**
+     * @brief 把 count 个 RGBA8888 像素转换为 format 格式写入 dst
+     */
+    static void FromRGBA8888(PixelFormat format, const uint32_t* src, void* dst, size_t count);
+
+    /**
+     * @brief 把 count 个 format 格式的像素转换为 RGBA8888 写入 dst
+     */
+    static void ToRGBA8888(PixelFormat format, const void* src, uint32_t* dst, size_t count);
+
+    /**
+     * @brief 在任意两种格式之间转换（经由 RGBA8888 分块中转，不分配堆内存）
+     */
+    static void Convert(PixelFormat src_format, const void* src, PixelFormat dst_format, void* dst, size_t count);
+
+    static uint16_t EncodeRGB565(uint32_t rgba)
+    {
+        const Color color(rgba);
+        return static_cast<uint16_t>(((color.R() >> 3) << 11) | ((color.G() >> 2) << 5) | (color.B() >> 3));
+    }
+
+    static uint32_t DecodeRGB565(uint16_t pixel)
+    {
+        const uint32_t r = (pixel >> 11) & 0x1Fu;
+        const uint32_t g = (pixel >> 5) & 0x3Fu;
+        const uint32_t b = pixel & 0x1Fu;
+        return Color(static_cast<uint8_t>((r << 3) | (r >> 2)), static_cast<uint8_t>((g << 2) | (g >> 4)),
+                     static_cast<uint8_t>((b << 3) | (b >> 2)), 255)
+            .ToUint32();
+    }
+
+    static uint8_t EncodeA8(uint32_t rgba)
+    {
+        return Color(rgba).A();
+    }
+
+    static uint32_t DecodeA8(uint8_t alpha)
+    {
+        return Color(alpha, alpha, alpha, alpha).ToUint32();
+    }
+
+    /**
+     * @brief 单精度转半精度（就近舍入到偶数，溢出为无穷大）
+     */
+    static uint16_t FloatToHalf(float value);
+
+    /**
+     * @brief 半精度转单精度（精确）
+     */
+    static float HalfToFloat(uint16_t half);
+
+    /**
+     * @brief 8 位分量 c 对应的半精度值 c / 255（查表）
+     */
+    static uint16_t UnormToHalf(uint8_t value);
+};
+
+#endif // PIXEL_FORMAT_H
@@ -7,34 +7,312 @@
 #include <algorithm>
 #include <cassert>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+// 无法查询时假定的末级缓存大小
+constexpr size_t kDefaultLastLevelCacheSize = size_t{8} << 20;
+
+size_t QueryLastLevelCacheSize()
+{
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    const long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (l3 > 0)
+    {
+        return static_cast<size_t>(l3);
+    }
+    const long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (l2 > 0)
+    {
+        return static_cast<size_t>(l2);
+    }
+#endif
+    return kDefaultLastLevelCacheSize;
+}
+
+} // namespace
+
 PixelsBuffer::PixelsBuffer(int width, int height) : _width(width), _height(height), _pitch(width * 4)
 {
     assert(width > 0 && height > 0);
     _pixel_data.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+    _tiles_x = (width + kClearTileSize - 1) / kClearTileSize;
+    _tiles_y = (height + kClearTileSize - 1) / kClearTileSize;
+    _tile_pending.resize(static_cast<size_t>(_tiles_x) * _tiles_y, 0);
+    ResetClipRect();
     Clear(); // 默认清除为透明黑色
 }
 
+size_t PixelsBuffer::LastLevelCacheSize()
+{
+    static const size_t size = QueryLastLevelCacheSize();
+    return size;
+}
+
 Color PixelsBuffer::GetPixel(int x, int y) const
 {
     if (!IsValidCoordinate(x, y))
     {
         return Color(0);
     }
+    if (_pending_tiles > 0)
+    {
+        MaterializeRegion(x, y, x + 1, y + 1);
+    }
     return Color(_pixel_data[static_cast<size_t>(y) * _width + x]);
 }
 
 void PixelsBuffer::SetPixel(int x, int y, const Color& color)
 {
-    if (!IsValidCoordinate(x, y))
+    if (!IsWritable(x, y))
+    {
+        return;
+    }
+    PixelsForRegion(x, y, x + 1, y + 1)[static_cast<size_t>(y) * _width + x] = Blender::Premultiply(color.ToUint32());
+}
+
+void PixelsBuffer::BlendPixel(int x, int y, const Color& color, uint8_t coverage)
+{
+    BlendPremultipliedPixel(x, y, Blender::Premultiply(color.ToUint32()), coverage);
+}
+
+void PixelsBuffer::BlendPremultipliedPixel(int x, int y, uint32_t premultiplied, uint8_t coverage)
+{
+    if (!IsWritable(x, y))
+    {
+        return;
+    }
+    uint32_t& dst = PixelsForRegion(x, y, x + 1, y + 1)[static_cast<size_t>(y) * _width + x];
+    dst = Blender::BlendPixel(dst, premultiplied, coverage, _blend_mode);
+}
+
+void PixelsBuffer::FillSpan(int x, int y, int count, const Color& color)
+{
+    if (y < _clip_y0 || y >= _clip_y1)
+    {
+        return;
+    }
+    const int x0 = std::max(x, _clip_x0);
+    const int x1 = std::min(x + count, _clip_x1);
+    if (x0 >= x1)
+    {
+        return;
+    }
+    uint32_t* row = PixelsForRegion(x0, y, x1, y + 1) + static_cast<size_t>(y) * _width;
+    const uint32_t premultiplied = Blender::Premultiply(color.ToUint32());
+    ForEachWritableRun(y, x0, x1, [&](int begin, int end) {
+        Blender::BlendSolidSpan(row + begin, premultiplied, end - begin, _blend_mode);
+    });
+}
+
+void PixelsBuffer::BlendSpan(int x, int y, const uint32_t* premultiplied, int count)
+{
+    if (y < _clip_y0 || y >= _clip_y1)
     {
         return;
     }
-    _pixel_data[static_cast<size_t>(y) * _width + x] = color.ToUint32();
+    const int x0 = std::max(x, _clip_x0);
+    const int x1 = std::min(x + count, _clip_x1);
+    if (x0 >= x1)
+    {
+        return;
+    }
+    uint32_t* row = PixelsForRegion(x0, y, x1, y + 1) + static_cast<size_t>(y) * _width;
+    ForEachWritableRun(y, x0, x1, [&](int begin, int end) {
+        Blender::BlendSpan(row + begin, premultiplied + (begin - x), end - begin, _blend_mode);
+    });
+}
+
+void PixelsBuffer::BlendCoverageSpan(int x, int y, uint32_t premultiplied, const uint8_t* coverage, int count)
+{
+    if (y < _clip_y0 || y >= _clip_y1)
+    {
+        return;
+    }
+    const int x0 = std::max(x, _clip_x0);
+    const int x1 = std::min(x + count, _clip_x1);
+    if (x0 >= x1)
+    {
+        return;
+    }
+    uint32_t* row = PixelsForRegion(x0, y, x1, y + 1) + static_cast<size_t>(y) * _width;
+    ForEachWritableRun(y, x0, x1, [&](int begin, int end) {
+        Blender::BlendMaskSpan(row + begin, premultiplied, coverage + (begin - x), end - begin, _blend_mode);
+    });
 }
 
 void PixelsBuffer::Clear(const Color& color)
 {
-    std::fill(_pixel_data.begin(), _pixel_data.end(), color.ToUint32());
+    const uint32_t value = Blender::Premultiply(color.ToUint32());
+    if (_fast_clear)
+    {
+        // 只标记瓦片，像素在第一次访问时再填充
+        _clear_value = value;
+        std::fill(_tile_pending.begin(), _tile_pending.end(), uint8_t{1});
+        _pending_tiles = _tile_pending.size();
+        return;
+    }
+    std::fill(_tile_pending.begin(), _tile_pending.end(), uint8_t{0});
+    _pending_tiles = 0;
+    FillRows(0, 0, _width, _height, value);
+}
+
+void PixelsBuffer::ClearRect(int x, int y, int width, int height, const Color& color)
+{
+    const int x0 = std::max(x, 0);
+    const int y0 = std::max(y, 0);
+    const int x1 = std::min(x + width, _width);
+    const int y1 = std::min(y + height, _height);
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+    FillRegion(x0, y0, x1, y1, Blender::Premultiply(color.ToUint32()));
+}
+
+void PixelsBuffer::FillRect(int x, int y, int width, int height, const Color& color)
+{
+    const int x0 = std::max(x, _clip_x0);
+    const int y0 = std::max(y, _clip_y0);
+    const int x1 = std::min(x + width, _clip_x1);
+    const int y1 = std::min(y + height, _clip_y1);
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+    const uint32_t premultiplied = Blender::Premultiply(color.ToUint32());
+    const bool stencil_test = StencilTest() != nullptr;
+    if (!stencil_test && (_blend_mode == BlendMode::Replace ||
+                          (_blend_mode == BlendMode::SrcOver && Blender::AlphaOf(premultiplied) == 255)))
+    {
+        FillRegion(x0, y0, x1, y1, premultiplied);
+        return;
+    }
+    uint32_t* pixels = PixelsForRegion(x0, y0, x1, y1);
+    for (int row = y0; row < y1; ++row)
+    {
+        uint32_t* dst = pixels + static_cast<size_t>(row) * _width;
+        ForEachWritableRun(row, x0, x1, [&](int begin, int end) {
+            Blender::BlendSolidSpan(dst + begin, premultiplied, end - begin, _blend_mode);
+        });
+    }
+}
+
+void PixelsBuffer::SetClipRect(const math::BoundingBox2i& rect)
+{
+    if (!rect.IsValid())
+    {
+        _clip_x0 = _clip_y0 = _clip_x1 = _clip_y1 = 0;
+        return;
+    }
+    _clip_x0 = std::clamp(rect.MinX(), 0, _width);
+    _clip_y0 = std::clamp(rect.MinY(), 0, _height);
+    _clip_x1 = std::clamp(rect.MaxX(), _clip_x0, _width);
+    _clip_y1 = std::clamp(rect.MaxY(), _clip_y0, _height);
+}
+
+void PixelsBuffer::SetFastClear(bool enabled)
+{
+    if (!enabled && _pending_tiles > 0)
+    {
+        MaterializeRegion(0, 0, _width, _height);
+    }
+    _fast_clear = enabled;
+}
+
+void PixelsBuffer::MaterializeRegion(int x0, int y0, int x1, int y1) const
+{
+    const int tx0 = std::max(x0, 0) / kClearTileSize;
+    const int ty0 = std::max(y0, 0) / kClearTileSize;
+    const int tx1 = (std::min(x1, _width) + kClearTileSize - 1) / kClearTileSize;
+    const int ty1 = (std::min(y1, _height) + kClearTileSize - 1) / kClearTileSize;
+    for (int ty = ty0; ty < ty1; ++ty)
+    {
+        for (int tx = tx0; tx < tx1; ++tx)
+        {
+            uint8_t& pending = _tile_pending[static_cast<size_t>(ty) * _tiles_x + tx];
+            if (pending)
+            {
+                // 瓦片马上要被访问，用普通写入把它留在缓存中
+                const int px = tx * kClearTileSize;
+                const int py = ty * kClearTileSize;
+                for (int row = py; row < std::min(py + kClearTileSize, _height); ++row)
+                {
+                    Blender::FillSpan(_pixel_data.data() + static_cast<size_t>(row) * _width + px, _clear_value,
+                                      static_cast<size_t>(std::min(kClearTileSize, _width - px)));
+                }
+                pending = 0;
+                --_pending_tiles;
+            }
+        }
+    }
+}
+
+void PixelsBuffer::FillRegion(int x0, int y0, int x1, int y1, uint32_t value)
+{
+    if (_pending_tiles > 0)
+    {
+        // 完整覆盖的瓦片即将被整体改写，不需要先填充清除色；部分覆盖的瓦片先实体化
+        const int tx0 = x0 / kClearTileSize;
+        const int ty0 = y0 / kClearTileSize;
+        const int tx1 = (x1 + kClearTileSize - 1) / kClearTileSize;
+        const int ty1 = (y1 + kClearTileSize - 1) / kClearTileSize;
+        for (int ty = ty0; ty < ty1; ++ty)
+        {
+            const int py = ty * kClearTileSize;
+            const bool rows_covered = y0 <= py && y1 >= std::min(py + kClearTileSize, _height);
+            for (int tx = tx0; tx < tx1; ++tx)
+            {
+                uint8_t& pending = _tile_pending[static_cast<size_t>(ty) * _tiles_x + tx];
+                if (!pending)
+                {
+                    continue;
+                }
+                const int px = tx * kClearTileSize;
+                if (rows_covered && x0 <= px && x1 >= std::min(px + kClearTileSize, _width))
+                {
+                    pending = 0;
+                    --_pending_tiles;
+                }
+                else
+                {
+                    MaterializeRegion(px, py, px + 1, py + 1);
+                }
+            }
+        }
+    }
+    FillRows(x0, y0, x1, y1, value);
+}
+
+void PixelsBuffer::FillRows(int x0, int y0, int x1, int y1, uint32_t value)
+{
+    const size_t row_pixels = static_cast<size_t>(x1 - x0);
+    // 整行连续时一次写完
+    const bool contiguous = x0 == 0 && x1 == _width;
+    const size_t span = contiguous ? row_pixels * static_cast<size_t>(y1 - y0) : row_pixels;
+    const int rows = contiguous ? 1 : y1 - y0;
+    const bool streaming = row_pixels * static_cast<size_t>(y1 - y0) * sizeof(uint32_t) > LastLevelCacheSize();
+
+    uint32_t* pixels = _pixel_data.data() + static_cast<size_t>(y0) * _width + x0;
+    for (int row = 0; row < rows; ++row, pixels += _width)
+    {
+        if (streaming)
+        {
+            Blender::StreamFillSpan(pixels, value, span);
+        }
+        else
+        {
+            Blender::FillSpan(pixels, value, span);
+        }
+    }
+    if (streaming)
+    {
+        Blender::StreamFence();
+    }
 }
 
 bool PixelsBuffer::IsValidCoordinate(int x, int y) const
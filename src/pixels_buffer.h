@@ -5,10 +5,18 @@
 #ifndef PIXELS_BUFFER_H
 #define PIXELS_BUFFER_H
 
+#include "blender.h"
 #include "color.h"
+#include "math/bounding_box.h"
+#include "stencil_buffer.h"
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+class FrameArena;
+class MsaaBuffer;
+
 class PixelsBuffer
 {
   public:
@@ -29,36 +37,298 @@ class PixelsBuffer
         return _pitch;
     }
 
-    // 像素数据访问
+    // 像素数据访问（快速清除模式下先把待清除的瓦片全部实体化）
     uint32_t* Pixels()
     {
+        if (_pending_tiles > 0)
+        {
+            MaterializeRegion(0, 0, _width, _height);
+        }
         return _pixel_data.data();
     }
     const uint32_t* Pixels() const
     {
+        if (_pending_tiles > 0)
+        {
+            MaterializeRegion(0, 0, _width, _height);
+        }
+        return _pixel_data.data();
+    }
+
+    /**
+     * @brief 像素数据首地址，只保证区域 [x0, x1) x [y0, y1) 内的像素已实体化，调用方只能访问该区域
+     *
+     * 已知写入范围的光栅化代码用它代替 Pixels()，快速清除模式下范围外的瓦片保持待清除状态。
+     * 实体化会修改瓦片元数据，多线程绘制时应在分发前由一个线程调用，再把指针交给各线程。
+     */
+    uint32_t* PixelsForRegion(int x0, int y0, int x1, int y1)
+    {
+        if (_pending_tiles > 0)
+        {
+            MaterializeRegion(x0, y0, x1, y1);
+        }
         return _pixel_data.data();
     }
 
-    // 获取/设置指定位置的像素
+    /**
+     * @brief 快速清除模式（默认关闭）
+     *
+     * 开启后 Clear 只在瓦片元数据中把所有瓦片标记为待清除，不写像素；瓦片在第一次被写入或读取时
+     * 才填充清除色（实体化），这时这块内存马上就要被图元写入，填充在缓存中完成。
+     * 被 ClearRect / FillRect（Replace）完整覆盖的瓦片直接跳过填充。关闭时立即实体化全部瓦片。
+     */
+    void SetFastClear(bool enabled);
+
+    bool IsFastClear() const
+    {
+        return _fast_clear;
+    }
+
+    /**
+     * @brief 尚未实体化的瓦片数
+     */
+    size_t PendingClearTiles() const
+    {
+        return _pending_tiles;
+    }
+
+    /**
+     * @brief 末级缓存的大小（字节），超过它的清除和填充使用非临时写入
+     */
+    static size_t LastLevelCacheSize();
+
+    /**
+     * @brief 读取一个像素，返回缓冲区中存储的预乘 alpha 值（不做反预乘）
+     */
     Color GetPixel(int x, int y) const;
+
+    /**
+     * @brief 直接覆盖一个像素，不受混合模式影响，但受裁剪矩形和模板测试限制
+     * @param color 颜色（直通 alpha，写入时转换为预乘）
+     */
     void SetPixel(int x, int y, const Color& color);
 
+    /**
+     * @brief 设置混合模式（由 GraphicsRenderer 设置，图元绘制时使用）
+     */
+    void SetBlendMode(BlendMode mode)
+    {
+        _blend_mode = mode;
+    }
+
+    BlendMode GetBlendMode() const
+    {
+        return _blend_mode;
+    }
+
+    /**
+     * @brief 绑定 MSAA 样本缓冲区（由 GraphicsRenderer 管理，nullptr 表示关闭 MSAA）
+     */
+    void SetMultisample(MsaaBuffer* msaa)
+    {
+        _msaa = msaa;
+    }
+
+    MsaaBuffer* Multisample() const
+    {
+        return _msaa;
+    }
+
+    /**
+     * @brief 绑定帧内分配器（由 GraphicsRenderer 管理），图元绘制时的临时缓冲从这里借用
+     */
+    void SetFrameArena(FrameArena* arena)
+    {
+        _arena = arena;
+    }
+
+    FrameArena* GetFrameArena() const
+    {
+        return _arena;
+    }
+
+    /**
+     * @brief 设置裁剪矩形（半开区间，自动裁剪到缓冲区，无效矩形表示不写任何像素）
+     *
+     * 所有绘制路径（逐像素、Span、FillRect 以及直接写像素的光栅化器）都只写裁剪矩形内的像素：
+     * 光栅化器在计算图元的行 / 列范围时就与裁剪矩形求交，裁剪不需要逐像素判断。
+     * Clear / ClearRect 不受裁剪矩形影响。一般由 GraphicsRenderer::PushClipRect 设置。
+     */
+    void SetClipRect(const math::BoundingBox2i& rect);
+
+    /**
+     * @brief 恢复为整个缓冲区
+     */
+    void ResetClipRect()
+    {
+        _clip_x0 = 0;
+        _clip_y0 = 0;
+        _clip_x1 = _width;
+        _clip_y1 = _height;
+    }
+
+    math::BoundingBox2i ClipRect() const
+    {
+        return math::BoundingBox2i(_clip_x0, _clip_y0, _clip_x1, _clip_y1);
+    }
+
+    // 裁剪矩形的边界（半开区间 [ClipMinX, ClipMaxX) x [ClipMinY, ClipMaxY)）
+    int ClipMinX() const
+    {
+        return _clip_x0;
+    }
+    int ClipMinY() const
+    {
+        return _clip_y0;
+    }
+    int ClipMaxX() const
+    {
+        return _clip_x1;
+    }
+    int ClipMaxY() const
+    {
+        return _clip_y1;
+    }
+
+    bool IsInsideClip(int x, int y) const
+    {
+        return x >= _clip_x0 && x < _clip_x1 && y >= _clip_y0 && y < _clip_y1;
+    }
+
+    /**
+     * @brief 绑定模板平面（由 GraphicsRenderer 管理，nullptr 表示没有模板平面）
+     */
+    void SetStencil(StencilBuffer* stencil)
+    {
+        _stencil = stencil;
+    }
+
+    StencilBuffer* Stencil() const
+    {
+        return _stencil;
+    }
+
+    /**
+     * @brief 需要执行模板测试时返回模板平面，否则返回 nullptr
+     */
+    const StencilBuffer* StencilTest() const
+    {
+        return _stencil != nullptr && _stencil->IsTestEnabled() ? _stencil : nullptr;
+    }
+
+    /**
+     * @brief 像素 (x, y) 是否可写：在裁剪矩形内且通过模板测试
+     */
+    bool IsWritable(int x, int y) const
+    {
+        return IsInsideClip(x, y) && (_stencil == nullptr || _stencil->Test(x, y));
+    }
+
+    /**
+     * @brief 把第 y 行已裁剪的 [x0, x1) 按模板测试拆分成可写的片段，对每个片段调用 fn(x_begin, x_end)
+     *
+     * 没有开启模板测试时整段只调用一次。直接写像素指针的光栅化器在写一行之前通过它处理模板。
+     */
+    template <typename Fn> void ForEachWritableRun(int y, int x0, int x1, Fn&& fn) const
+    {
+        const StencilBuffer* stencil = StencilTest();
+        if (stencil == nullptr)
+        {
+            if (x0 < x1)
+            {
+                fn(x0, x1);
+            }
+            return;
+        }
+        stencil->ForEachPassingRun(x0, y, x1 - x0, [&](int begin, int length) { fn(begin, begin + length); });
+    }
+
+    /**
+     * @brief 按当前混合模式绘制一个像素
+     * @param color 颜色（直通 alpha，内部转换为预乘）
+     * @param coverage 覆盖率 [0, 255]，用于抗锯齿
+     */
+    void BlendPixel(int x, int y, const Color& color, uint8_t coverage = 255);
+
+    /**
+     * @brief 按当前混合模式绘制一个预乘 alpha 像素
+     */
+    void BlendPremultipliedPixel(int x, int y, uint32_t premultiplied, uint8_t coverage = 255);
+
+    /**
+     * @brief 按当前混合模式用纯色填充一行 [x, x + count)，自动裁剪到裁剪矩形并执行模板测试
+     * @param color 颜色（直通 alpha）
+     */
+    void FillSpan(int x, int y, int count, const Color& color);
+
+    /**
+     * @brief 按当前混合模式将一行预乘像素写入 [x, x + count)，自动裁剪到裁剪矩形并执行模板测试
+     */
+    void BlendSpan(int x, int y, const uint32_t* premultiplied, int count);
+
+    /**
+     * @brief 按当前混合模式和逐像素覆盖率将纯色写入 [x, x + count)，自动裁剪到裁剪矩形并执行模板测试
+     * @param premultiplied 颜色（预乘 alpha）
+     * @param coverage 覆盖率数组，coverage[0] 对应像素 x
+     */
+    void BlendCoverageSpan(int x, int y, uint32_t premultiplied, const uint8_t* coverage, int count);
+
     void SetPixelData(const std::vector<uint32_t>& data)
     {
         _pixel_data = data;
+        std::fill(_tile_pending.begin(), _tile_pending.end(), uint8_t{0});
+        _pending_tiles = 0;
     }
 
-    // 清除缓冲区（填充指定颜色）
+    // 清除缓冲区（填充指定颜色，颜色为直通 alpha，写入时转换为预乘）
     void Clear(const Color& color = Color::Transparent());
 
+    // 清除矩形区域 [x, x + width) x [y, y + height)（不混合，自动裁剪到缓冲区）
+    void ClearRect(int x, int y, int width, int height, const Color& color = Color::Transparent());
+
+    /**
+     * @brief 按当前混合模式用纯色填充矩形区域 [x, x + width) x [y, y + height)，自动裁剪到裁剪矩形并执行模板测试
+     * @param color 颜色（直通 alpha）
+     */
+    void FillRect(int x, int y, int width, int height, const Color& color);
+
     // 检查坐标是否在有效范围内
     bool IsValidCoordinate(int x, int y) const;
 
   private:
+    // 快速清除的瓦片边长（像素）
+    static constexpr int kClearTileSize = 64;
+
+    // 实体化与区域 [x0, x1) x [y0, y1) 相交的待清除瓦片
+    void MaterializeRegion(int x0, int y0, int x1, int y1) const;
+
+    // 用 value 覆盖已裁剪的区域；完整覆盖的待清除瓦片不再实体化
+    void FillRegion(int x0, int y0, int x1, int y1, uint32_t value);
+
+    // 直接写像素（不检查瓦片状态），区域超过末级缓存时使用非临时写入
+    void FillRows(int x0, int y0, int x1, int y1, uint32_t value);
+
     int _width;
     int _height;
     int _pitch;                        // 每行字节数 = _width * 4
-    std::vector<uint32_t> _pixel_data; // RGBA8888 格式，每个像素 32 位
+    // RGBA8888 格式（预乘 alpha），每个像素 32 位。
+    // 快速清除的瓦片在读取时才实体化，不改变逻辑上的内容，因此这三项在 const 函数中也可以修改
+    mutable std::vector<uint32_t> _pixel_data;
+    mutable std::vector<uint8_t> _tile_pending; // 每个瓦片是否待清除
+    mutable size_t _pending_tiles = 0;
+    int _tiles_x = 0;
+    int _tiles_y = 0;
+    uint32_t _clear_value = 0; // 待清除瓦片的像素值（预乘）
+    bool _fast_clear = false;
+    BlendMode _blend_mode = BlendMode::Replace;
+    MsaaBuffer* _msaa = nullptr;   // 非拥有，MSAA 关闭时为空
+    FrameArena* _arena = nullptr; // 非拥有，为空时图元自行分配临时缓冲
+    StencilBuffer* _stencil = nullptr; // 非拥有，没有模板平面时为空
+    // 裁剪矩形（半开区间，总在缓冲区内）
+    int _clip_x0 = 0;
+    int _clip_y0 = 0;
+    int _clip_x1 = 0;
+    int _clip_y1 = 0;
 };
 
 #endif // PIXELS_BUFFER_H
@@ -0,0 +1,581 @@
+//
+// Created by admin on 2026/2/22.
+//
+
+#include "post_process.h"
+#include "blender.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#if COLOR_LITTLE_ENDIAN && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define POST_PROCESS_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define POST_PROCESS_USE_SSE2 0
+#endif
+
+namespace
+{
+
+// 高斯权重的定点位数：权重之和为 2^kWeightBits
+constexpr int kWeightBits = 14;
+
+// 以 taps[k] + x 为第 k 个抽头的像素，按 weights 卷积出 count 个像素写入 dst（tap_count 为偶数）
+void Convolve(const uint32_t* const* taps, const int16_t* weights, int tap_count, uint32_t* dst, int count)
+{
+    int x = 0;
+#if POST_PROCESS_USE_SSE2
+    // 相邻两个抽头的权重打包在一个 32 位通道中，与交错后的像素做 madd
+    __m128i pairs[GaussianBlurPass::kMaxRadius + 1];
+    for (int k = 0; k < tap_count; k += 2)
+    {
+        pairs[k / 2] = _mm_set1_epi32(static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(weights[k + 1]))
+                                                        << 16) |
+                                                       static_cast<uint16_t>(weights[k])));
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(1 << (kWeightBits - 1));
+    for (; x + 4 <= count; x += 4)
+    {
+        __m128i acc0 = round;
+        __m128i acc1 = round;
+        __m128i acc2 = round;
+        __m128i acc3 = round;
+        for (int k = 0; k < tap_count; k += 2)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(taps[k] + x));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(taps[k + 1] + x));
+            // 交错后每个 32 位通道为 (a 的分量, b 的分量)
+            const __m128i lo = _mm_unpacklo_epi8(a, b);
+            const __m128i hi = _mm_unpackhi_epi8(a, b);
+            const __m128i w = pairs[k / 2];
+            acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), w));
+            acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), w));
+            acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), w));
+            acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), w));
+        }
+        const __m128i p01 = _mm_packs_epi32(_mm_srai_epi32(acc0, kWeightBits), _mm_srai_epi32(acc1, kWeightBits));
+        const __m128i p23 = _mm_packs_epi32(_mm_srai_epi32(acc2, kWeightBits), _mm_srai_epi32(acc3, kWeightBits));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(p01, p23));
+    }
+#endif
+    for (; x < count; ++x)
+    {
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            int32_t sum = 1 << (kWeightBits - 1);
+            for (int k = 0; k < tap_count; ++k)
+            {
+                sum += weights[k] * static_cast<int32_t>((taps[k][x] >> shift) & 0xFFu);
+            }
+            result |= static_cast<uint32_t>(std::min(sum >> kWeightBits, 255)) << shift;
+        }
+        dst[x] = result;
+    }
+}
+
+// 把一行复制到 padded[radius, radius + count)，两侧各用边缘像素补齐 radius + extra 个
+void PadRow(const uint32_t* row, int count, int radius, int extra, uint32_t* padded)
+{
+    std::fill(padded, padded + radius, row[0]);
+    std::memcpy(padded + radius, row, static_cast<size_t>(count) * sizeof(uint32_t));
+    std::fill(padded + radius + count, padded + radius + count + radius + extra, row[count - 1]);
+}
+
+void CopyRows(const PixelsBuffer& src, PixelsBuffer& dst)
+{
+    std::memcpy(dst.Pixels(), src.Pixels(), static_cast<size_t>(src.Width()) * src.Height() * sizeof(uint32_t));
+}
+
+#if POST_PROCESS_USE_SSE2
+inline __m128i UnpackPixel(uint32_t pixel, __m128i zero)
+{
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(pixel)), zero), zero);
+}
+
+inline uint32_t PackPixel(__m128i channels)
+{
+    const __m128i packed = _mm_packs_epi32(channels, channels);
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(packed, packed)));
+}
+#endif
+
+// 盒式模糊的一行累加和：sums（每像素 4 个通道）加上 add 行、减去 sub 行（sub 可以为空）
+void AccumulateRow(int32_t* sums, const uint32_t* add, const uint32_t* sub, int count)
+{
+    int x = 0;
+#if POST_PROCESS_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 4 <= count; x += 4)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + x));
+        const __m128i s = sub ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + x)) : zero;
+        const __m128i a_lo = _mm_unpacklo_epi8(a, zero);
+        const __m128i a_hi = _mm_unpackhi_epi8(a, zero);
+        const __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+        const __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+        // 16 位差值可能为负，符号扩展到 32 位
+        const __m128i d_lo = _mm_sub_epi16(a_lo, s_lo);
+        const __m128i d_hi = _mm_sub_epi16(a_hi, s_hi);
+        const __m128i d[4] = {_mm_srai_epi32(_mm_unpacklo_epi16(d_lo, d_lo), 16),
+                              _mm_srai_epi32(_mm_unpackhi_epi16(d_lo, d_lo), 16),
+                              _mm_srai_epi32(_mm_unpacklo_epi16(d_hi, d_hi), 16),
+                              _mm_srai_epi32(_mm_unpackhi_epi16(d_hi, d_hi), 16)};
+        for (int i = 0; i < 4; ++i)
+        {
+            __m128i* p = reinterpret_cast<__m128i*>(sums + (x + i) * 4);
+            _mm_storeu_si128(p, _mm_add_epi32(_mm_loadu_si128(p), d[i]));
+        }
+    }
+#endif
+    for (; x < count; ++x)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            sums[x * 4 + c] += static_cast<int32_t>((add[x] >> (c * 8)) & 0xFFu);
+            if (sub)
+            {
+                sums[x * 4 + c] -= static_cast<int32_t>((sub[x] >> (c * 8)) & 0xFFu);
+            }
+        }
+    }
+}
+
+// dst[x] = sums[x] / window（四舍五入）
+void DivideRow(const int32_t* sums, float inv_window, uint32_t* dst, int count)
+{
+    int x = 0;
+#if POST_PROCESS_USE_SSE2
+    const __m128 inv = _mm_set1_ps(inv_window);
+    auto divide = [&](int i)
+    {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sums + i * 4));
+        return _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(s), inv));
+    };
+    for (; x + 4 <= count; x += 4)
+    {
+        const __m128i p01 = _mm_packs_epi32(divide(x), divide(x + 1));
+        const __m128i p23 = _mm_packs_epi32(divide(x + 2), divide(x + 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(p01, p23));
+    }
+#endif
+    for (; x < count; ++x)
+    {
+        uint32_t result = 0;
+        for (int c = 0; c < 4; ++c)
+        {
+            const long value = std::lround(static_cast<float>(sums[x * 4 + c]) * inv_window);
+            result |= static_cast<uint32_t>(std::clamp(value, 0L, 255L)) << (c * 8);
+        }
+        dst[x] = result;
+    }
+}
+
+// 水平盒式模糊一行：padded 两侧已补齐 radius 个边缘像素
+void BoxRow(const uint32_t* padded, int radius, float inv_window, uint32_t* dst, int count)
+{
+    const int window = 2 * radius + 1;
+#if POST_PROCESS_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 inv = _mm_set1_ps(inv_window);
+    __m128i sum = zero;
+    for (int k = 0; k < window; ++k)
+    {
+        sum = _mm_add_epi32(sum, UnpackPixel(padded[k], zero));
+    }
+    for (int x = 0;; ++x)
+    {
+        dst[x] = PackPixel(_mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(sum), inv)));
+        if (x + 1 == count)
+        {
+            break;
+        }
+        sum = _mm_sub_epi32(_mm_add_epi32(sum, UnpackPixel(padded[x + window], zero)), UnpackPixel(padded[x], zero));
+    }
+#else
+    int32_t sum[4] = {0, 0, 0, 0};
+    for (int k = 0; k < window; ++k)
+    {
+        AccumulateRow(sum, padded + k, nullptr, 1);
+    }
+    for (int x = 0;; ++x)
+    {
+        DivideRow(sum, inv_window, dst + x, 1);
+        if (x + 1 == count)
+        {
+            break;
+        }
+        AccumulateRow(sum, padded + x + window, padded + x, 1);
+    }
+#endif
+}
+
+} // namespace
+
+GaussianBlurPass::GaussianBlurPass(float sigma)
+{
+    SetSigma(sigma);
+}
+
+void GaussianBlurPass::SetSigma(float sigma)
+{
+    _sigma = std::max(sigma, 0.0f);
+    _radius = _sigma > 0.0f ? std::clamp(static_cast<int>(std::ceil(3.0f * _sigma)), 1, kMaxRadius) : 0;
+
+    // 浮点权重归一化后量化，误差补到中心抽头，保证权重和严格为 2^kWeightBits
+    const int taps = 2 * _radius + 1;
+    std::vector<float> gauss(static_cast<size_t>(taps));
+    float total = 0.0f;
+    for (int k = 0; k < taps; ++k)
+    {
+        const float d = static_cast<float>(k - _radius);
+        gauss[k] = _sigma > 0.0f ? std::exp(-d * d / (2.0f * _sigma * _sigma)) : 1.0f;
+        total += gauss[k];
+    }
+    _weights.assign(static_cast<size_t>(taps) + 1, 0);
+    int sum = 0;
+    for (int k = 0; k < taps; ++k)
+    {
+        _weights[k] = static_cast<int16_t>(std::lround(gauss[k] / total * (1 << kWeightBits)));
+        sum += _weights[k];
+    }
+    _weights[_radius] = static_cast<int16_t>(_weights[_radius] + (1 << kWeightBits) - sum);
+}
+
+void GaussianBlurPass::Apply(const PixelsBuffer& src, PixelsBuffer& dst, PostProcessor& pipeline)
+{
+    if (_radius == 0)
+    {
+        CopyRows(src, dst);
+        return;
+    }
+    const int width = src.Width();
+    const int height = src.Height();
+    const int radius = _radius;
+    const int tap_count = 2 * radius + 2;
+    const int16_t* weights = _weights.data();
+    const size_t pixels = static_cast<size_t>(width) * height;
+
+    const std::shared_ptr<RenderTarget> temp = pipeline.AcquireScratch(width, height);
+    const uint32_t* src_pixels = src.Pixels();
+    uint32_t* temp_pixels = temp->Buffer().Pixels();
+    uint32_t* dst_pixels = dst.Pixels();
+
+    // 水平：每行补齐边缘后，第 k 个抽头就是补齐行偏移 k
+    pipeline.ForEachBand(height, pixels, [&](int band, int y_begin, int y_end) {
+        uint32_t* padded = pipeline.BandScratch(band, static_cast<size_t>(width) + 2 * radius + 1);
+        const uint32_t* taps[2 * kMaxRadius + 2];
+        for (int k = 0; k < tap_count; ++k)
+        {
+            taps[k] = padded + k;
+        }
+        for (int y = y_begin; y < y_end; ++y)
+        {
+            PadRow(src_pixels + static_cast<size_t>(y) * width, width, radius, 1, padded);
+            Convolve(taps, weights, tap_count, temp_pixels + static_cast<size_t>(y) * width, width);
+        }
+    });
+
+    // 竖直：第 k 个抽头是第 y - radius + k 行（截断到边缘），按行整行卷积
+    pipeline.ForEachBand(height, pixels, [&](int, int y_begin, int y_end) {
+        const uint32_t* taps[2 * kMaxRadius + 2];
+        for (int y = y_begin; y < y_end; ++y)
+        {
+            for (int k = 0; k < tap_count - 1; ++k)
+            {
+                taps[k] = temp_pixels + static_cast<size_t>(std::clamp(y - radius + k, 0, height - 1)) * width;
+            }
+            taps[tap_count - 1] = taps[tap_count - 2];
+            Convolve(taps, weights, tap_count, dst_pixels + static_cast<size_t>(y) * width, width);
+        }
+    });
+}
+
+BoxBlurPass::BoxBlurPass(int radius, int iterations) : _radius(0), _iterations(1)
+{
+    SetRadius(radius);
+    SetIterations(iterations);
+}
+
+void BoxBlurPass::Apply(const PixelsBuffer& src, PixelsBuffer& dst, PostProcessor& pipeline)
+{
+    if (_radius == 0)
+    {
+        CopyRows(src, dst);
+        return;
+    }
+    const int width = src.Width();
+    const int height = src.Height();
+    const int radius = _radius;
+    const float inv_window = 1.0f / static_cast<float>(2 * radius + 1);
+    const size_t pixels = static_cast<size_t>(width) * height;
+
+    const std::shared_ptr<RenderTarget> temp = pipeline.AcquireScratch(width, height);
+    uint32_t* temp_pixels = temp->Buffer().Pixels();
+    uint32_t* dst_pixels = dst.Pixels();
+
+    // 每次迭代：current -> temp（水平）-> dst（竖直），之后的迭代从 dst 开始
+    const uint32_t* current = src.Pixels();
+    for (int iteration = 0; iteration < _iterations; ++iteration)
+    {
+        pipeline.ForEachBand(height, pixels, [&](int band, int y_begin, int y_end) {
+            uint32_t* padded = pipeline.BandScratch(band, static_cast<size_t>(width) + 2 * radius);
+            for (int y = y_begin; y < y_end; ++y)
+            {
+                PadRow(current + static_cast<size_t>(y) * width, width, radius, 0, padded);
+                BoxRow(padded, radius, inv_window, temp_pixels + static_cast<size_t>(y) * width, width);
+            }
+        });
+
+        // 竖直：每个行带维护一行的列和，向下移动一行时加入新行、移出旧行
+        pipeline.ForEachBand(height, pixels, [&](int band, int y_begin, int y_end) {
+            int32_t* sums = reinterpret_cast<int32_t*>(pipeline.BandScratch(band, static_cast<size_t>(width) * 4));
+            std::fill(sums, sums + static_cast<size_t>(width) * 4, 0);
+            auto row = [&](int y) { return temp_pixels + static_cast<size_t>(std::clamp(y, 0, height - 1)) * width; };
+            for (int k = -radius; k <= radius; ++k)
+            {
+                AccumulateRow(sums, row(y_begin + k), nullptr, width);
+            }
+            for (int y = y_begin; y < y_end; ++y)
+            {
+                DivideRow(sums, inv_window, dst_pixels + static_cast<size_t>(y) * width, width);
+                if (y + 1 < y_end)
+                {
+                    AccumulateRow(sums, row(y + radius + 1), row(y - radius), width);
+                }
+            }
+        });
+        current = dst_pixels;
+    }
+}
+
+BloomPass::BloomPass(uint8_t threshold, float sigma, uint8_t intensity)
+    : _threshold(0), _intensity(intensity), _blur(sigma)
+{
+    SetThreshold(threshold);
+}
+
+void BloomPass::Apply(const PixelsBuffer& src, PixelsBuffer& dst, PostProcessor& pipeline)
+{
+    const int width = src.Width();
+    const int height = src.Height();
+    const size_t pixels = static_cast<size_t>(width) * height;
+    const std::shared_ptr<RenderTarget> bright = pipeline.AcquireScratch(width, height);
+    const std::shared_ptr<RenderTarget> blurred = pipeline.AcquireScratch(width, height);
+    const uint32_t* src_pixels = src.Pixels();
+    uint32_t* bright_pixels = bright->Buffer().Pixels();
+
+    // 亮部提取：亮度（预乘分量的加权和）超过阈值的部分按比例保留
+    const int threshold = _threshold;
+    const int range = 255 - threshold;
+    pipeline.ForEachBand(height, pixels, [&](int, int y_begin, int y_end) {
+        for (size_t i = static_cast<size_t>(y_begin) * width; i < static_cast<size_t>(y_end) * width; ++i)
+        {
+            const Color color(src_pixels[i]);
+            const int luma = (54 * color.R() + 183 * color.G() + 19 * color.B() + 128) >> 8;
+            const int factor = luma > threshold ? std::min(((luma - threshold) * 255 + range / 2) / range, 255) : 0;
+            bright_pixels[i] = factor == 0 ? 0u : Blender::ScalePixel(src_pixels[i], static_cast<uint32_t>(factor));
+        }
+    });
+
+    _blur.Apply(bright->Buffer(), blurred->Buffer(), pipeline);
+
+    // 合成：原图 + 模糊后的亮部 * intensity（饱和加）
+    const uint32_t* blurred_pixels = blurred->Buffer().Pixels();
+    uint32_t* dst_pixels = dst.Pixels();
+    const uint32_t intensity = _intensity;
+    pipeline.ForEachBand(height, pixels, [&](int band, int y_begin, int y_end) {
+        uint32_t* scaled = intensity == 255 ? nullptr : pipeline.BandScratch(band, static_cast<size_t>(width));
+        for (int y = y_begin; y < y_end; ++y)
+        {
+            const size_t offset = static_cast<size_t>(y) * width;
+            std::memcpy(dst_pixels + offset, src_pixels + offset, static_cast<size_t>(width) * sizeof(uint32_t));
+            const uint32_t* glow = blurred_pixels + offset;
+            if (scaled)
+            {
+                Blender::ScaleSpan(scaled, glow, width, intensity);
+                glow = scaled;
+            }
+            Blender::BlendSpan(dst_pixels + offset, glow, width, BlendMode::Additive);
+        }
+    });
+}
+
+ColorLut3D::ColorLut3D(int size) : _size(std::clamp(size, 2, kMaxSize))
+{
+    _entries.resize(static_cast<size_t>(_size) * _size * _size);
+    for (int b = 0; b < _size; ++b)
+    {
+        for (int g = 0; g < _size; ++g)
+        {
+            for (int r = 0; r < _size; ++r)
+            {
+                auto level = [this](int i) { return static_cast<uint8_t>((i * 255 + (_size - 1) / 2) / (_size - 1)); };
+                Set(r, g, b, Color(level(r), level(g), level(b), 255));
+            }
+        }
+    }
+}
+
+Color ColorLut3D::Lookup(const Color& color) const
+{
+    const float scale = static_cast<float>(_size - 1) / 255.0f;
+    int index[3];
+    float fraction[3];
+    const uint8_t channels[3] = {color.R(), color.G(), color.B()};
+    for (int c = 0; c < 3; ++c)
+    {
+        const float position = static_cast<float>(channels[c]) * scale;
+        index[c] = std::min(static_cast<int>(position), _size - 2);
+        fraction[c] = position - static_cast<float>(index[c]);
+    }
+
+    float result[3] = {0.0f, 0.0f, 0.0f};
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        const int dr = corner & 1;
+        const int dg = (corner >> 1) & 1;
+        const int db = (corner >> 2) & 1;
+        const float weight = (dr ? fraction[0] : 1.0f - fraction[0]) * (dg ? fraction[1] : 1.0f - fraction[1]) *
+                             (db ? fraction[2] : 1.0f - fraction[2]);
+        const Color entry = Get(index[0] + dr, index[1] + dg, index[2] + db);
+        result[0] += weight * entry.R();
+        result[1] += weight * entry.G();
+        result[2] += weight * entry.B();
+    }
+    auto to_byte = [](float v) { return static_cast<uint8_t>(std::clamp(std::lround(v), 0L, 255L)); };
+    return Color(to_byte(result[0]), to_byte(result[1]), to_byte(result[2]), color.A());
+}
+
+ColorGradePass::ColorGradePass(ColorLut3D lut) : _lut(std::move(lut))
+{
+    BuildAxisTables();
+}
+
+void ColorGradePass::SetLut(ColorLut3D lut)
+{
+    _lut = std::move(lut);
+    BuildAxisTables();
+}
+
+void ColorGradePass::BuildAxisTables()
+{
+    const int size = _lut.Size();
+    const float scale = static_cast<float>(size - 1) / 255.0f;
+    for (int v = 0; v < 256; ++v)
+    {
+        const float position = static_cast<float>(v) * scale;
+        _index[v] = static_cast<uint8_t>(std::min(static_cast<int>(position), size - 2));
+        _fraction[v] = position - static_cast<float>(_index[v]);
+    }
+}
+
+void ColorGradePass::Apply(const PixelsBuffer& src, PixelsBuffer& dst, PostProcessor& pipeline)
+{
+    const int width = src.Width();
+    const int height = src.Height();
+    const uint32_t* src_pixels = src.Pixels();
+    uint32_t* dst_pixels = dst.Pixels();
+    const uint32_t* entries = _lut.Data();
+    const size_t stride_g = static_cast<size_t>(_lut.Size());
+    const size_t stride_b = stride_g * stride_g;
+
+    pipeline.ForEachBand(height, static_cast<size_t>(width) * height, [&](int, int y_begin, int y_end) {
+#if POST_PROCESS_USE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        // 通道顺序为 (A, B, G, R)，与打包像素在内存中的字节顺序一致
+        auto load = [&](size_t index) { return _mm_cvtepi32_ps(UnpackPixel(entries[index], zero)); };
+        auto lerp = [](__m128 a, __m128 b, __m128 t) { return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t)); };
+        const __m128 alpha_lane = _mm_castsi128_ps(_mm_set_epi32(0, 0, 0, -1));
+#endif
+        for (size_t i = static_cast<size_t>(y_begin) * width; i < static_cast<size_t>(y_end) * width; ++i)
+        {
+            const uint32_t pixel = src_pixels[i];
+            const uint32_t alpha = Blender::AlphaOf(pixel);
+            if (alpha == 0)
+            {
+                dst_pixels[i] = 0;
+                continue;
+            }
+            // 反预乘得到直通分量
+            Color color(pixel);
+            if (alpha != 255)
+            {
+                auto unpremultiply = [alpha](uint8_t c)
+                { return static_cast<uint8_t>(std::min<uint32_t>((c * 255u + alpha / 2) / alpha, 255u)); };
+                color = Color(unpremultiply(color.R()), unpremultiply(color.G()), unpremultiply(color.B()),
+                              static_cast<uint8_t>(alpha));
+            }
+#if POST_PROCESS_USE_SSE2
+            const size_t base = _index[color.R()] + _index[color.G()] * stride_g + _index[color.B()] * stride_b;
+            const __m128 fr = _mm_set1_ps(_fraction[color.R()]);
+            const __m128 fg = _mm_set1_ps(_fraction[color.G()]);
+            const __m128 fb = _mm_set1_ps(_fraction[color.B()]);
+            const __m128 c00 = lerp(load(base), load(base + 1), fr);
+            const __m128 c10 = lerp(load(base + stride_g), load(base + stride_g + 1), fr);
+            const __m128 c01 = lerp(load(base + stride_b), load(base + stride_b + 1), fr);
+            const __m128 c11 = lerp(load(base + stride_b + stride_g), load(base + stride_b + stride_g + 1), fr);
+            __m128 graded = lerp(lerp(c00, c10, fg), lerp(c01, c11, fg), fb);
+            // alpha 通道置为 255，整体乘以 alpha / 255 即完成预乘
+            graded = _mm_or_ps(_mm_andnot_ps(alpha_lane, graded), _mm_and_ps(alpha_lane, _mm_set1_ps(255.0f)));
+            graded = _mm_mul_ps(graded, _mm_set1_ps(static_cast<float>(alpha) / 255.0f));
+            dst_pixels[i] = PackPixel(_mm_cvtps_epi32(graded));
+#else
+            dst_pixels[i] = Blender::Premultiply(_lut.Lookup(color).ToUint32());
+#endif
+        }
+    });
+}
+
+size_t PostProcessor::AddPass(std::unique_ptr<PostProcessPass> pass)
+{
+    _passes.push_back({std::move(pass), true});
+    return _passes.size() - 1;
+}
+
+bool PostProcessor::IsActive() const
+{
+    return std::any_of(_passes.begin(), _passes.end(),
+                       [](const Entry& entry) { return entry.enabled && entry.pass != nullptr; });
+}
+
+void PostProcessor::Clear()
+{
+    _passes.clear();
+    _output.reset();
+    _pool.ReleaseUnused();
+}
+
+const PixelsBuffer& PostProcessor::Apply(const PixelsBuffer& frame)
+{
+    // 上一帧的结果先归还，乒乓目标在稳定状态下总是复用同两块
+    _output.reset();
+    if (!IsActive())
+    {
+        return frame;
+    }
+
+    std::shared_ptr<RenderTarget> targets[2];
+    const PixelsBuffer* current = &frame;
+    int next = 0;
+    for (auto& entry : _passes)
+    {
+        if (!entry.enabled || !entry.pass)
+        {
+            continue;
+        }
+        if (!targets[next])
+        {
+            targets[next] = _pool.Acquire(frame.Width(), frame.Height());
+        }
+        PixelsBuffer& dst = targets[next]->Buffer();
+        entry.pass->Apply(*current, dst, *this);
+        current = &dst;
+        next ^= 1;
+    }
+    _output = std::move(targets[next ^ 1]);
+    return _output->Buffer();
+}
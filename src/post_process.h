@@ -0,0 +1,363 @@
+//
+// Created by admin on 2026/2/22.
+//
+
+#ifndef POST_PROCESS_H
+#define POST_PROCESS_H
+
+#include "color.h"
+#include "parallel.h"
+#include "pixels_buffer.h"
+#include "render_target.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class PostProcessor;
+
+/**
+ * @brief 后处理 pass 接口
+ *
+ * pass 读取 src 整帧，把结果写入 dst（两者尺寸相同且不是同一个缓冲区）。
+ * 需要中间结果时从 pipeline 取暂存目标，按行带并行时通过 pipeline.ForEachBand 分发。
+ */
+class PostProcessPass
+{
+  public:
+    virtual ~PostProcessPass() = default;
+
+    virtual void Apply(const PixelsBuffer& src, PixelsBuffer& dst, PostProcessor& pipeline) = 0;
+};
+
+/**
+ * @brief 可分离高斯模糊：先水平后竖直两次一维卷积
+ *
+ * 权重量化为和为 2^14 的整数，SSE2 下相邻两个抽头的像素交错成 16 位后用 madd 一次完成两次乘加，
+ * 一次输出 4 个像素；水平方向在补齐边缘的行暂存上卷积，竖直方向直接以行指针为抽头。边缘像素重复延伸。
+ */
+class GaussianBlurPass : public PostProcessPass
+{
+  public:
+    static constexpr int kMaxRadius = 64;
+
+    /**
+     * @param sigma 标准差（像素），半径取 ceil(3 * sigma)，不超过 kMaxRadius
+     */
+    explicit GaussianBlurPass(float sigma = 2.0f);
+
+    void SetSigma(float sigma);
+
+    [[nodiscard]] float Sigma() const
+    {
+        return _sigma;
+    }
+
+    [[nodiscard]] int Radius() const
+    {
+        return _radius;
+    }
+
+    void Apply(const PixelsBuffer& src, PixelsBuffer& dst, PostProcessor& pipeline) override;
+
+  private:
+    float _sigma = 0.0f;
+    int _radius = 0;
+    std::vector<int16_t> _weights; // 2 * radius + 2 个，最后一个为 0（凑成偶数个抽头）
+};
+
+/**
+ * @brief 盒式模糊：滑动窗口的累加和在每个像素上只加入一个、移出一个，开销与半径无关
+ *
+ * 水平方向逐行维护 4 个通道的和，竖直方向每个行带维护一行的列和；多次迭代逼近高斯模糊。
+ */
+class BoxBlurPass : public PostProcessPass
+{
+  public:
+    /**
+     * @param radius 半径（窗口宽度 2 * radius + 1）
+     * @param iterations 迭代次数，3 次时接近高斯模糊
+     */
+    explicit BoxBlurPass(int radius = 2, int iterations = 1);
+
+    void SetRadius(int radius)
+    {
+        _radius = radius < 0 ? 0 : radius;
+    }
+
+    [[nodiscard]] int Radius() const
+    {
+        return _radius;
+    }
+
+    void SetIterations(int iterations)
+    {
+        _iterations = iterations < 1 ? 1 : iterations;
+    }
+
+    [[nodiscard]] int Iterations() const
+    {
+        return _iterations;
+    }
+
+    void Apply(const PixelsBuffer& src, PixelsBuffer& dst, PostProcessor& pipeline) override;
+
+  private:
+    int _radius;
+    int _iterations;
+};
+
+/**
+ * @brief 泛光：提取亮部，高斯模糊后按强度叠加（Additive）回原图
+ *
+ * 亮度超过阈值的部分按 (L - threshold) / (255 - threshold) 保留，其余为 0。
+ */
+class BloomPass : public PostProcessPass
+{
+  public:
+    /**
+     * @param threshold 亮度阈值 [0, 255)
+     * @param sigma 模糊的标准差
+     * @param intensity 叠加强度 [0, 255]
+     */
+    BloomPass(uint8_t threshold = 200, float sigma = 4.0f, uint8_t intensity = 255);
+
+    void SetThreshold(uint8_t threshold)
+    {
+        _threshold = threshold == 255 ? 254 : threshold;
+    }
+
+    void SetIntensity(uint8_t intensity)
+    {
+        _intensity = intensity;
+    }
+
+    void SetSigma(float sigma)
+    {
+        _blur.SetSigma(sigma);
+    }
+
+    void Apply(const PixelsBuffer& src, PixelsBuffer& dst, PostProcessor& pipeline) override;
+
+  private:
+    uint8_t _threshold;
+    uint8_t _intensity;
+    GaussianBlurPass _blur;
+};
+
+/**
+ * @brief 3D 颜色查找表（每个轴 size 个格点，保存直通 alpha 的 RGB）
+ */
+class ColorLut3D
+{
+  public:
+    static constexpr int kMaxSize = 65;
+
+    /**
+     * @brief 创建 size x size x size 的恒等查找表（size 截断到 [2, kMaxSize]）
+     */
+    explicit ColorLut3D(int size = 17);
+
+    /**
+     * @brief 由颜色映射函数 fn(Color) -> Color 生成查找表
+     */
+    template <typename Fn> static ColorLut3D FromFunction(int size, Fn&& fn)
+    {
+        ColorLut3D lut(size);
+        for (int b = 0; b < lut._size; ++b)
+        {
+            for (int g = 0; g < lut._size; ++g)
+            {
+                for (int r = 0; r < lut._size; ++r)
+                {
+                    lut.Set(r, g, b, fn(lut.Get(r, g, b)));
+                }
+            }
+        }
+        return lut;
+    }
+
+    [[nodiscard]] int Size() const
+    {
+        return _size;
+    }
+
+    /**
+     * @brief 格点 (r, g, b) 的颜色（alpha 忽略）
+     */
+    void Set(int r, int g, int b, const Color& color)
+    {
+        _entries[Index(r, g, b)] = color.ToUint32() | 0xFFu;
+    }
+
+    [[nodiscard]] Color Get(int r, int g, int b) const
+    {
+        return Color(_entries[Index(r, g, b)]);
+    }
+
+    /**
+     * @brief 三线性插值查找直通 alpha 的颜色（alpha 原样返回）
+     */
+    [[nodiscard]] Color Lookup(const Color& color) const;
+
+    [[nodiscard]] const uint32_t* Data() const
+    {
+        return _entries.data();
+    }
+
+    [[nodiscard]] size_t Index(int r, int g, int b) const
+    {
+        return (static_cast<size_t>(b) * _size + g) * _size + r;
+    }
+
+  private:
+    int _size;
+    std::vector<uint32_t> _entries; // r 变化最快
+};
+
+/**
+ * @brief 3D LUT 调色：像素先反预乘，查表三线性插值后再预乘回去
+ *
+ * 每个 8 位分量对应的格点下标和插值系数预先算成表，逐像素不做除法；插值在 SSE 的 4 个浮点通道中进行。
+ */
+class ColorGradePass : public PostProcessPass
+{
+  public:
+    explicit ColorGradePass(ColorLut3D lut);
+
+    void SetLut(ColorLut3D lut);
+
+    [[nodiscard]] const ColorLut3D& Lut() const
+    {
+        return _lut;
+    }
+
+    void Apply(const PixelsBuffer& src, PixelsBuffer& dst, PostProcessor& pipeline) override;
+
+  private:
+    void BuildAxisTables();
+
+    ColorLut3D _lut;
+    uint8_t _index[256]{};  // 分量值对应的格点下标（不超过 size - 2）
+    float _fraction[256]{}; // 在格点之间的位置 [0, 1]
+};
+
+/**
+ * @brief 后处理管线：位于帧回调与呈现之间，按添加顺序执行启用的 pass
+ *
+ * 各 pass 在两个乒乓目标之间交替读写，输入帧本身不被修改（保留模式的损坏区域重绘依赖它）。
+ * 乒乓目标和 pass 的暂存目标都从内部的渲染目标池取得，行带并行的行暂存只增不减，
+ * 稳定状态下每帧不分配内存。管线只能在一个线程中调用；在 JobSystem 的线程中调用时行带作为作业分发。
+ */
+class PostProcessor
+{
+  public:
+    PostProcessor() = default;
+
+    PostProcessor(const PostProcessor&) = delete;
+    PostProcessor& operator=(const PostProcessor&) = delete;
+
+    /**
+     * @brief 添加 pass（在已有 pass 之后执行），返回编号
+     */
+    size_t AddPass(std::unique_ptr<PostProcessPass> pass);
+
+    PostProcessPass& Pass(size_t index)
+    {
+        return *_passes[index].pass;
+    }
+
+    void SetEnabled(size_t index, bool enabled)
+    {
+        _passes[index].enabled = enabled;
+    }
+
+    [[nodiscard]] bool IsEnabled(size_t index) const
+    {
+        return _passes[index].enabled;
+    }
+
+    [[nodiscard]] size_t PassCount() const
+    {
+        return _passes.size();
+    }
+
+    /**
+     * @brief 是否有启用的 pass（没有时 Apply 直接返回输入帧）
+     */
+    [[nodiscard]] bool IsActive() const;
+
+    /**
+     * @brief 删除全部 pass 并释放暂存目标
+     */
+    void Clear();
+
+    /**
+     * @brief 行带并行的线程数，0 表示使用硬件并发数，1 表示只用调用线程
+     */
+    void SetThreadCount(int count)
+    {
+        _thread_count = count;
+    }
+
+    /**
+     * @brief 依次执行启用的 pass，返回结果（在下一次 Apply 或 Clear 之前有效）
+     */
+    const PixelsBuffer& Apply(const PixelsBuffer& frame);
+
+    /**
+     * @brief 取得一个 width x height 的暂存目标（内容未定义），引用释放后归还池
+     */
+    std::shared_ptr<RenderTarget> AcquireScratch(int width, int height)
+    {
+        return _pool.Acquire(width, height);
+    }
+
+    /**
+     * @brief 第 band 个行带的行暂存，至少 count 个元素（只能在该行带的任务中使用）
+     */
+    uint32_t* BandScratch(int band, size_t count)
+    {
+        std::vector<uint32_t>& scratch = _band_scratch[static_cast<size_t>(band)];
+        if (scratch.size() < count)
+        {
+            scratch.resize(count);
+        }
+        return scratch.data();
+    }
+
+    /**
+     * @brief 把 [0, rows) 分成若干连续行带并行执行 fn(band, y_begin, y_end)，返回时全部完成
+     * @param pixels 每次处理的像素数，用于决定是否值得并行
+     */
+    template <typename Fn> void ForEachBand(int rows, size_t pixels, const Fn& fn)
+    {
+        const int bands =
+            std::min(parallel::ResolveThreadCount(_thread_count, pixels, kParallelThreshold), std::max(rows, 1));
+        if (_band_scratch.size() < static_cast<size_t>(bands))
+        {
+            _band_scratch.resize(static_cast<size_t>(bands));
+        }
+        parallel::RunParallel(bands, [&](int band) {
+            fn(band, rows * band / bands, rows * (band + 1) / bands);
+        });
+    }
+
+  private:
+    // 像素数低于该值时不并行
+    static constexpr size_t kParallelThreshold = size_t{1} << 16;
+
+    struct Entry
+    {
+        std::unique_ptr<PostProcessPass> pass;
+        bool enabled = true;
+    };
+
+    std::vector<Entry> _passes;
+    RenderTargetPool _pool;
+    std::shared_ptr<RenderTarget> _output;
+    std::vector<std::vector<uint32_t>> _band_scratch;
+    int _thread_count = 0;
+};
+
+#endif // POST_PROCESS_H
@@ -0,0 +1,64 @@
+//
+// Created by admin on 2026/2/13.
+//
+
+#include "circle_primitive.h"
+#include "../blender.h"
+#include <algorithm>
+#include <cmath>
+
+namespace pri
+{
+
+void CirclePrimitive::Draw(PixelsBuffer& buffer) const
+{
+    if (_radius < 0.0f)
+    {
+        return;
+    }
+    const uint32_t color = Blender::Premultiply(_color.ToUint32());
+    ShapeRasterizer& rasterizer = ShapeRasterizer::ForCurrentThread();
+    if (_antialiased)
+    {
+        const RoundedShapeF shape{_center.X(), _center.Y(), 0.0f, 0.0f, _radius, _radius};
+        if (_filled)
+        {
+            rasterizer.FillAntialiased(buffer, shape, color);
+        }
+        else
+        {
+            rasterizer.StrokeAntialiased(buffer, shape, _stroke_width, color);
+        }
+        return;
+    }
+
+    const int cx = static_cast<int>(std::lround(_center.X()));
+    const int cy = static_cast<int>(std::lround(_center.Y()));
+    const int radius = static_cast<int>(std::lround(_radius));
+    const RoundedShape shape{cx, cy, cx, cy, radius, radius};
+    if (_filled)
+    {
+        rasterizer.Fill(buffer, shape, color);
+    }
+    else
+    {
+        rasterizer.Stroke(buffer, shape, std::max(static_cast<int>(std::lround(_stroke_width)), 1), color);
+    }
+}
+
+std::unique_ptr<IPrimitive> CirclePrimitive::Clone() const
+{
+    return std::make_unique<CirclePrimitive>(*this);
+}
+
+math::BoundingBox2i CirclePrimitive::Bounds() const
+{
+    if (_radius < 0.0f)
+    {
+        return {};
+    }
+    const float extent = _radius + (_filled ? 0.0f : 0.5f * _stroke_width);
+    return PixelBounds(_center.X() - extent, _center.Y() - extent, _center.X() + extent, _center.Y() + extent, 1.0f);
+}
+
+} // namespace pri
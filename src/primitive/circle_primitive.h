@@ -0,0 +1,105 @@
+//
+// Created by admin on 2026/2/13.
+//
+
+#ifndef CIRCLE_PRIMITIVE_H
+#define CIRCLE_PRIMITIVE_H
+
+#include "../math/point.h"
+#include "primitive.h"
+#include "shape_rasterizer.h"
+
+namespace pri
+{
+
+/**
+ * @brief 圆图元（实心或描边，可选抗锯齿边缘）
+ *
+ * 不抗锯齿时圆心和半径四舍五入到整数，按中点法逐行求出 span，半径为 r 的圆直径为 2r + 1 个像素；
+ * 抗锯齿时保留浮点几何，只对边缘像素计算覆盖率。描边沿圆周向内延伸 stroke width。
+ */
+class CirclePrimitive : public IPrimitive
+{
+  public:
+    CirclePrimitive() = default;
+
+    /**
+     * @param center 圆心
+     * @param radius 半径
+     * @param color 颜色
+     * @param filled 是否填充（否则只描边）
+     * @param antialiased 是否抗锯齿
+     */
+    CirclePrimitive(const math::Point2f& center, float radius, const Color& color, bool filled = true,
+                    bool antialiased = false)
+        : _center(center), _radius(radius), _color(color), _filled(filled), _antialiased(antialiased)
+    {
+    }
+
+    void Draw(PixelsBuffer& buffer) const override;
+    std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
+
+    // 获取/设置属性
+    math::Point2f GetCenter() const
+    {
+        return _center;
+    }
+    void SetCenter(const math::Point2f& center)
+    {
+        _center = center;
+    }
+    float GetRadius() const
+    {
+        return _radius;
+    }
+    void SetRadius(float radius)
+    {
+        _radius = radius;
+    }
+    Color GetColor() const
+    {
+        return _color;
+    }
+    void SetColor(const Color& color)
+    {
+        _color = color;
+    }
+    bool IsFilled() const
+    {
+        return _filled;
+    }
+    void SetFilled(bool filled)
+    {
+        _filled = filled;
+    }
+    // 描边宽度（不抗锯齿时四舍五入，至少 1 像素）
+    float GetStrokeWidth() const
+    {
+        return _stroke_width;
+    }
+    void SetStrokeWidth(float width)
+    {
+        _stroke_width = width;
+    }
+    bool IsAntialiased() const
+    {
+        return _antialiased;
+    }
+    void SetAntialiased(bool antialiased)
+    {
+        _antialiased = antialiased;
+    }
+
+  private:
+    math::Point2f _center;
+    float _radius = 0.0f;
+    Color _color = Color::White();
+    bool _filled = true;
+    float _stroke_width = 1.0f;
+    bool _antialiased = false;
+};
+
+} // namespace pri
+
+#endif // CIRCLE_PRIMITIVE_H
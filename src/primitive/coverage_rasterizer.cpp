@@ -0,0 +1,296 @@
+//
+// Created by admin on 2026/2/8.
+//
+
+#include "coverage_rasterizer.h"
+#include "../format_buffer.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+namespace pri
+{
+
+namespace
+{
+
+// 目标缓冲区的可写行范围 [begin, end)：PixelsBuffer 使用裁剪矩形，其它目标使用整个缓冲区
+template <typename Target> std::pair<int, int> WritableRows(const Target& buffer)
+{
+    if constexpr (std::is_same_v<Target, PixelsBuffer>)
+    {
+        return {buffer.ClipMinY(), buffer.ClipMaxY()};
+    }
+    else
+    {
+        return {0, buffer.Height()};
+    }
+}
+
+// 把一段位于同一扫描线内的线段 (x 从 x_top 到 x_bottom，纵向高度 d) 的面积贡献写入累加缓冲
+// 要求 0 <= x <= width，累加缓冲至少有 width + 2 个元素
+void AccumulateSegment(float* accum, float x_top, float x_bottom, float d, int& lo, int& hi)
+{
+    const float x0 = std::min(x_top, x_bottom);
+    const float x1 = std::max(x_top, x_bottom);
+    const float x0_floor = std::floor(x0);
+    const int x0i = static_cast<int>(x0_floor);
+    const float x1_ceil = std::ceil(x1);
+    const int x1i = static_cast<int>(x1_ceil);
+
+    lo = std::min(lo, x0i);
+    if (x1i <= x0i + 1)
+    {
+        // 线段落在一个像素内：按中点位置分配面积
+        const float xmf = 0.5f * (x_top + x_bottom) - x0_floor;
+        accum[x0i] += d - d * xmf;
+        accum[x0i + 1] += d * xmf;
+        hi = std::max(hi, x0i + 1);
+        return;
+    }
+
+    // 线段跨越多个像素：首尾像素为三角形面积，中间像素均分
+    const float s = 1.0f / (x1 - x0);
+    const float x0f = x0 - x0_floor;
+    const float a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+    const float x1f = x1 - x1_ceil + 1.0f;
+    const float am = 0.5f * s * x1f * x1f;
+    accum[x0i] += d * a0;
+    if (x1i == x0i + 2)
+    {
+        accum[x0i + 1] += d * (1.0f - a0 - am);
+    }
+    else
+    {
+        const float a1 = s * (1.5f - x0f);
+        accum[x0i + 1] += d * (a1 - a0);
+        for (int xi = x0i + 2; xi < x1i - 1; ++xi)
+        {
+            accum[xi] += d * s;
+        }
+        const float a2 = a1 + static_cast<float>(x1i - x0i - 3) * s;
+        accum[x1i - 1] += d * (1.0f - a2 - am);
+    }
+    accum[x1i] += d * am;
+    hi = std::max(hi, x1i);
+}
+
+} // namespace
+
+CoverageRasterizer& CoverageRasterizer::ForCurrentThread()
+{
+    thread_local CoverageRasterizer rasterizer;
+    return rasterizer;
+}
+
+void CoverageRasterizer::Reset()
+{
+    _edges.clear();
+}
+
+void CoverageRasterizer::AddEdge(float x0, float y0, float x1, float y1)
+{
+    if (y0 == y1)
+    {
+        // 水平边没有面积贡献
+        return;
+    }
+    // 整数坐标位于像素中心，光栅化时像素 i 覆盖 [i, i + 1)
+    x0 += 0.5f;
+    y0 += 0.5f;
+    x1 += 0.5f;
+    y1 += 0.5f;
+    if (y0 < y1)
+    {
+        _edges.push_back({x0, y0, x1, y1, 1.0f});
+    }
+    else
+    {
+        _edges.push_back({x1, y1, x0, y0, -1.0f});
+    }
+}
+
+void CoverageRasterizer::AddContour(const math::Point2f* points, size_t count)
+{
+    if (count < 2)
+    {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        const math::Point2f& a = points[i];
+        const math::Point2f& b = points[(i + 1) % count];
+        AddEdge(a.X(), a.Y(), b.X(), b.Y());
+    }
+}
+
+template <typename Target>
+void CoverageRasterizer::Fill(Target& buffer, const Color& color, FillRule rule)
+{
+    if (_edges.empty())
+    {
+        return;
+    }
+
+    const int width = buffer.Width();
+    float min_y = _edges.front().y0;
+    float max_y = _edges.front().y1;
+    for (const auto& edge : _edges)
+    {
+        min_y = std::min(min_y, edge.y0);
+        max_y = std::max(max_y, edge.y1);
+    }
+    // 裁剪矩形之外的行不做扫描转换；列方向由 BlendCoverageSpan 裁剪
+    const auto [clip_begin, clip_end] = WritableRows(buffer);
+    const int row_begin = std::max(static_cast<int>(std::floor(min_y)), clip_begin);
+    const int row_end = std::min(static_cast<int>(std::ceil(max_y)), clip_end);
+    if (row_begin >= row_end)
+    {
+        return;
+    }
+
+    std::sort(_edges.begin(), _edges.end(), [](const Edge& a, const Edge& b) { return a.y0 < b.y0; });
+    _accum.assign(static_cast<size_t>(width) + 2, 0.0f);
+    _coverage.resize(static_cast<size_t>(width));
+    _active.clear();
+
+    const uint32_t premultiplied = Blender::Premultiply(color.ToUint32());
+    size_t next_edge = 0;
+    for (int y = row_begin; y < row_end; ++y)
+    {
+        const float y_top = static_cast<float>(y);
+        const float y_bottom = y_top + 1.0f;
+
+        // 更新活动边表：加入进入本行的边，移除已经结束的边
+        while (next_edge < _edges.size() && _edges[next_edge].y0 < y_bottom)
+        {
+            _active.push_back(&_edges[next_edge]);
+            ++next_edge;
+        }
+        _active.erase(std::remove_if(_active.begin(), _active.end(), [y_top](const Edge* e) { return e->y1 <= y_top; }),
+                      _active.end());
+        if (_active.empty())
+        {
+            continue;
+        }
+
+        _lo = width + 1;
+        _hi = -1;
+        for (const Edge* edge : _active)
+        {
+            AccumulateRow(*edge, std::max(edge->y0, y_top), std::min(edge->y1, y_bottom), static_cast<float>(width));
+        }
+        if (_hi >= _lo)
+        {
+            EmitRow(buffer, y, premultiplied, rule);
+        }
+    }
+}
+
+void CoverageRasterizer::AccumulateRow(const Edge& edge, float y_top, float y_bottom, float width)
+{
+    if (y_bottom <= y_top)
+    {
+        return;
+    }
+    const float dxdy = (edge.x1 - edge.x0) / (edge.y1 - edge.y0);
+    const float xa = edge.x0 + (y_top - edge.y0) * dxdy;
+    const float xb = edge.x0 + (y_bottom - edge.y0) * dxdy;
+
+    // 在 x = 0 与 x = width 处切分线段：左侧之外的部分投影到 x = 0（对右侧所有像素贡献完整面积），
+    // 右侧之外的部分不影响可见像素，直接丢弃
+    float cuts[4] = {0.0f, 1.0f, 1.0f, 1.0f};
+    int cut_count = 1;
+    if (xa != xb)
+    {
+        for (float bound : {0.0f, width})
+        {
+            const float t = (bound - xa) / (xb - xa);
+            if (t > 0.0f && t < 1.0f)
+            {
+                cuts[cut_count++] = t;
+            }
+        }
+    }
+    if (cut_count == 3 && cuts[1] > cuts[2])
+    {
+        std::swap(cuts[1], cuts[2]);
+    }
+    cuts[cut_count++] = 1.0f;
+
+    const float height = y_bottom - y_top;
+    float* accum = _accum.data();
+    for (int i = 0; i + 1 < cut_count; ++i)
+    {
+        const float t0 = cuts[i];
+        const float t1 = cuts[i + 1];
+        if (t1 <= t0)
+        {
+            continue;
+        }
+        const float x_top = xa + (xb - xa) * t0;
+        const float x_bottom = xa + (xb - xa) * t1;
+        const float mid = 0.5f * (x_top + x_bottom);
+        if (mid >= width)
+        {
+            continue;
+        }
+        const float d = edge.dir * height * (t1 - t0);
+        if (mid <= 0.0f)
+        {
+            AccumulateSegment(accum, 0.0f, 0.0f, d, _lo, _hi);
+        }
+        else
+        {
+            AccumulateSegment(accum, std::clamp(x_top, 0.0f, width), std::clamp(x_bottom, 0.0f, width), d, _lo, _hi);
+        }
+    }
+}
+
+template <typename Target>
+void CoverageRasterizer::EmitRow(Target& buffer, int y, uint32_t color, FillRule rule)
+{
+    const int width = buffer.Width();
+    auto to_coverage = [rule](float acc)
+    {
+        float c = std::abs(acc);
+        if (rule == FillRule::EvenOdd)
+        {
+            c = std::fmod(c, 2.0f);
+            c = c > 1.0f ? 2.0f - c : c;
+        }
+        return static_cast<uint8_t>(std::min(c, 1.0f) * 255.0f + 0.5f);
+    };
+
+    // 前缀和得到覆盖率，同时清理被写入的累加区间
+    const int end = std::min(_hi, width - 1);
+    float acc = 0.0f;
+    for (int x = _lo; x <= end; ++x)
+    {
+        acc += _accum[x];
+        _accum[x] = 0.0f;
+        _coverage[x] = to_coverage(acc);
+    }
+    for (int x = end + 1; x <= _hi; ++x)
+    {
+        _accum[x] = 0.0f;
+    }
+
+    // 多边形延伸到右边界之外时，最后一个被写入的像素之后覆盖率保持不变
+    int emit_end = end;
+    const uint8_t tail = to_coverage(acc);
+    if (tail != 0 && end < width - 1)
+    {
+        std::fill(_coverage.begin() + end + 1, _coverage.end(), tail);
+        emit_end = width - 1;
+    }
+
+    buffer.BlendCoverageSpan(_lo, y, color, _coverage.data() + _lo, emit_end - _lo + 1);
+}
+
+// 只有行接口的目标缓冲区：RGBA8888 工作缓冲区和按格式存储的缓冲区
+template void CoverageRasterizer::Fill(PixelsBuffer& buffer, const Color& color, FillRule rule);
+template void CoverageRasterizer::Fill(FormatBuffer& buffer, const Color& color, FillRule rule);
+
+} // namespace pri
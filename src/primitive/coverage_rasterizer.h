@@ -0,0 +1,102 @@
+//
+// Created by admin on 2026/2/8.
+//
+
+#ifndef COVERAGE_RASTERIZER_H
+#define COVERAGE_RASTERIZER_H
+
+#include "../pixels_buffer.h"
+#include "../math/point.h"
+#include <vector>
+
+namespace pri
+{
+
+/**
+ * @brief 多边形填充规则
+ */
+enum class FillRule
+{
+    NonZero, // 非零环绕
+    EvenOdd  // 奇偶
+};
+
+/**
+ * @brief 解析覆盖率光栅化器（字体光栅化器风格）
+ *
+ * 原理：
+ *   每条边对其右侧像素贡献一个带符号的面积，按扫描线把贡献写入累加缓冲区，
+ *   再对一行做前缀和即得到每个像素被多边形覆盖的精确面积比例。
+ *   一次遍历即可得到抗锯齿结果，不需要对每个像素做多次采样。
+ *
+ * 实现：
+ *   - 边按上端点排序，逐行维护活动边表，只为当前扫描线保留一行累加缓冲（稀疏）
+ *   - 每行只清理被写入的区间 [lo, hi]
+ *   - 缓冲区左右两侧之外的边被投影到边界上，保证裁剪后覆盖率仍然正确
+ *
+ * 坐标约定与其它图元一致：整数坐标位于像素中心。
+ * 同一个光栅化器可以反复使用，内部缓冲区会被复用。
+ */
+class CoverageRasterizer
+{
+  public:
+    CoverageRasterizer() = default;
+
+    /**
+     * @brief 当前线程的光栅化器
+     *
+     * 图元在 const Draw 中借用它（先 Reset 再添加边），不在图元内部保存可变的缓冲区，
+     * 因此同一个图元可以在多个线程中同时绘制。借用期间不能再绘制其它借用它的图元。
+     */
+    static CoverageRasterizer& ForCurrentThread();
+
+    /**
+     * @brief 清空所有边（保留缓冲区容量）
+     */
+    void Reset();
+
+    /**
+     * @brief 添加一条有向边
+     */
+    void AddEdge(float x0, float y0, float x1, float y1);
+
+    /**
+     * @brief 添加一个闭合轮廓（最后一个点自动连回第一个点）
+     */
+    void AddContour(const math::Point2f* points, size_t count);
+
+    /**
+     * @brief 把已添加的所有边按填充规则绘制到缓冲区
+     * @param buffer 目标缓冲区：PixelsBuffer，或任意格式的 FormatBuffer（如把字形覆盖率绘制到 A8 遮罩）
+     * @param color 颜色（直通 alpha）
+     * @param rule 填充规则
+     */
+    template <typename Target>
+    void Fill(Target& buffer, const Color& color, FillRule rule);
+
+  private:
+    struct Edge
+    {
+        float x0, y0; // 上端点
+        float x1, y1; // 下端点
+        float dir;    // 原始方向向下为 +1，向上为 -1
+    };
+
+    // 把边在 [y_top, y_bottom] 内的部分累加到当前行
+    void AccumulateRow(const Edge& edge, float y_top, float y_bottom, float width);
+
+    // 前缀和求覆盖率并写入缓冲区
+    template <typename Target>
+    void EmitRow(Target& buffer, int y, uint32_t color, FillRule rule);
+
+    std::vector<Edge> _edges;
+    std::vector<const Edge*> _active;
+    std::vector<float> _accum;     // 当前行的累加缓冲（宽度 + 2）
+    std::vector<uint8_t> _coverage; // 当前行的覆盖率
+    int _lo = 0;                    // 当前行被写入的累加区间
+    int _hi = -1;
+};
+
+} // namespace pri
+
+#endif // COVERAGE_RASTERIZER_H
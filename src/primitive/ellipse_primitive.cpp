@@ -0,0 +1,67 @@
+//
+// Created by admin on 2026/2/13.
+//
+
+#include "ellipse_primitive.h"
+#include "../blender.h"
+#include <algorithm>
+#include <cmath>
+
+namespace pri
+{
+
+void EllipsePrimitive::Draw(PixelsBuffer& buffer) const
+{
+    if (_radius_x < 0.0f || _radius_y < 0.0f)
+    {
+        return;
+    }
+    const uint32_t color = Blender::Premultiply(_color.ToUint32());
+    ShapeRasterizer& rasterizer = ShapeRasterizer::ForCurrentThread();
+    if (_antialiased)
+    {
+        const RoundedShapeF shape{_center.X(), _center.Y(), 0.0f, 0.0f, _radius_x, _radius_y};
+        if (_filled)
+        {
+            rasterizer.FillAntialiased(buffer, shape, color);
+        }
+        else
+        {
+            rasterizer.StrokeAntialiased(buffer, shape, _stroke_width, color);
+        }
+        return;
+    }
+
+    const int cx = static_cast<int>(std::lround(_center.X()));
+    const int cy = static_cast<int>(std::lround(_center.Y()));
+    const RoundedShape shape{cx, cy, cx, cy, static_cast<int>(std::lround(_radius_x)),
+                             static_cast<int>(std::lround(_radius_y))};
+    if (_filled)
+    {
+        rasterizer.Fill(buffer, shape, color);
+    }
+    else
+    {
+        rasterizer.Stroke(buffer, shape, std::max(static_cast<int>(std::lround(_stroke_width)), 1), color);
+    }
+}
+
+std::unique_ptr<IPrimitive> EllipsePrimitive::Clone() const
+{
+    return std::make_unique<EllipsePrimitive>(*this);
+}
+
+math::BoundingBox2i EllipsePrimitive::Bounds() const
+{
+    if (_radius_x < 0.0f || _radius_y < 0.0f)
+    {
+        return {};
+    }
+    const float stroke = _filled ? 0.0f : 0.5f * _stroke_width;
+    const float extent_x = _radius_x + stroke;
+    const float extent_y = _radius_y + stroke;
+    return PixelBounds(_center.X() - extent_x, _center.Y() - extent_y, _center.X() + extent_x,
+                       _center.Y() + extent_y, 1.0f);
+}
+
+} // namespace pri
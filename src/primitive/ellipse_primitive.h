@@ -0,0 +1,113 @@
+//
+// Created by admin on 2026/2/13.
+//
+
+#ifndef ELLIPSE_PRIMITIVE_H
+#define ELLIPSE_PRIMITIVE_H
+
+#include "../math/point.h"
+#include "primitive.h"
+#include "shape_rasterizer.h"
+
+namespace pri
+{
+
+/**
+ * @brief 轴对齐椭圆图元（实心或描边，可选抗锯齿边缘）
+ *
+ * 不抗锯齿时中心和半轴四舍五入到整数，逐行 span 由中点法判别式增量求出；
+ * 抗锯齿时边缘距离用隐式方程的一阶近似，半轴相差悬殊时边缘略有偏差。
+ */
+class EllipsePrimitive : public IPrimitive
+{
+  public:
+    EllipsePrimitive() = default;
+
+    /**
+     * @param center 中心
+     * @param radius_x 水平半轴
+     * @param radius_y 垂直半轴
+     * @param color 颜色
+     * @param filled 是否填充（否则只描边）
+     * @param antialiased 是否抗锯齿
+     */
+    EllipsePrimitive(const math::Point2f& center, float radius_x, float radius_y, const Color& color,
+                     bool filled = true, bool antialiased = false)
+        : _center(center), _radius_x(radius_x), _radius_y(radius_y), _color(color), _filled(filled),
+          _antialiased(antialiased)
+    {
+    }
+
+    void Draw(PixelsBuffer& buffer) const override;
+    std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
+
+    // 获取/设置属性
+    math::Point2f GetCenter() const
+    {
+        return _center;
+    }
+    void SetCenter(const math::Point2f& center)
+    {
+        _center = center;
+    }
+    float GetRadiusX() const
+    {
+        return _radius_x;
+    }
+    float GetRadiusY() const
+    {
+        return _radius_y;
+    }
+    void SetRadii(float radius_x, float radius_y)
+    {
+        _radius_x = radius_x;
+        _radius_y = radius_y;
+    }
+    Color GetColor() const
+    {
+        return _color;
+    }
+    void SetColor(const Color& color)
+    {
+        _color = color;
+    }
+    bool IsFilled() const
+    {
+        return _filled;
+    }
+    void SetFilled(bool filled)
+    {
+        _filled = filled;
+    }
+    // 描边宽度（不抗锯齿时四舍五入，至少 1 像素）
+    float GetStrokeWidth() const
+    {
+        return _stroke_width;
+    }
+    void SetStrokeWidth(float width)
+    {
+        _stroke_width = width;
+    }
+    bool IsAntialiased() const
+    {
+        return _antialiased;
+    }
+    void SetAntialiased(bool antialiased)
+    {
+        _antialiased = antialiased;
+    }
+
+  private:
+    math::Point2f _center;
+    float _radius_x = 0.0f;
+    float _radius_y = 0.0f;
+    Color _color = Color::White();
+    bool _filled = true;
+    float _stroke_width = 1.0f;
+    bool _antialiased = false;
+};
+
+} // namespace pri
+
+#endif // ELLIPSE_PRIMITIVE_H
@@ -0,0 +1,413 @@
+//
+// Created by admin on 2026/2/11.
+//
+
+#include "line_batch.h"
+#include "../frame_arena.h"
+#include "../parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace pri
+{
+
+namespace
+{
+
+// 线段数少于该值时不值得启动线程
+constexpr size_t kParallelThreshold = 4096;
+
+// 把线段裁剪到矩形 [min_x, max_x] x [min_y, max_y]（Liang-Barsky），完全在外时返回 false
+bool ClipSegment(double& x0, double& y0, double& x1, double& y1, double min_x, double min_y, double max_x,
+                 double max_y)
+{
+    const double dx = x1 - x0;
+    const double dy = y1 - y0;
+    double t0 = 0.0;
+    double t1 = 1.0;
+    const double p[4] = {-dx, dx, -dy, dy};
+    const double q[4] = {x0 - min_x, max_x - x0, y0 - min_y, max_y - y0};
+    for (int i = 0; i < 4; ++i)
+    {
+        if (p[i] == 0.0)
+        {
+            if (q[i] < 0.0)
+            {
+                return false;
+            }
+            continue;
+        }
+        const double t = q[i] / p[i];
+        if (p[i] < 0.0)
+        {
+            t0 = std::max(t0, t);
+        }
+        else
+        {
+            t1 = std::min(t1, t);
+        }
+        if (t0 > t1)
+        {
+            return false;
+        }
+    }
+    x1 = x0 + t1 * dx;
+    y1 = y0 + t1 * dy;
+    x0 = x0 + t0 * dx;
+    y0 = y0 + t0 * dy;
+    return true;
+}
+
+// 在裁剪矩形 [clip_x0, clip_x1) x [clip_y0, clip_y1) 内光栅化一条 Bresenham 线段（像素与 LinePrimitive 一致）
+// stencil 非空时只写通过模板测试的像素
+void RasterizeLine(uint32_t* pixels, int width, int clip_x0, int clip_y0, int clip_x1, int clip_y1, int32_t x1,
+                   int32_t y1, int32_t x2, int32_t y2, uint32_t color, BlendMode mode, const StencilBuffer* stencil)
+{
+    const int64_t dx = std::abs(static_cast<int64_t>(x2) - x1);
+    const int64_t dy = std::abs(static_cast<int64_t>(y2) - y1);
+
+    // 统一成主方向 a / 次方向 b 处理
+    const bool x_major = dx >= dy;
+    const int64_t major = x_major ? dx : dy;
+    const int64_t minor = x_major ? dy : dx;
+    const int64_t a1 = x_major ? x1 : y1;
+    const int64_t b1 = x_major ? y1 : x1;
+    const int64_t sa = (x_major ? x2 > x1 : y2 > y1) ? 1 : -1;
+    const int64_t sb = (x_major ? y2 > y1 : x2 > x1) ? 1 : -1;
+    const int64_t a_min = x_major ? clip_x0 : clip_y0;
+    const int64_t a_max = x_major ? clip_x1 : clip_y1;
+    const int64_t b_min = x_major ? clip_y0 : clip_x0;
+    const int64_t b_max = x_major ? clip_y1 : clip_x1;
+
+    if (major == 0)
+    {
+        const int px = static_cast<int>(x_major ? a1 : b1);
+        const int py = static_cast<int>(x_major ? b1 : a1);
+        if (a1 >= a_min && a1 < a_max && b1 >= b_min && b1 < b_max && (stencil == nullptr || stencil->Test(px, py)))
+        {
+            uint32_t& dst = pixels[(x_major ? b1 * width + a1 : a1 * width + b1)];
+            dst = Blender::BlendPixel(dst, color, mode);
+        }
+        return;
+    }
+
+    // 主方向上落在裁剪矩形内的步数区间 [i_begin, i_end)
+    int64_t i_begin = sa > 0 ? a_min - a1 : a1 - (a_max - 1);
+    int64_t i_end = sa > 0 ? a_max - a1 : a1 - a_min + 1;
+    i_begin = std::max<int64_t>(i_begin, 0);
+    i_end = std::min<int64_t>(i_end, major + 1);
+    if (i_begin >= i_end)
+    {
+        return;
+    }
+
+    // 第 i 步的次方向偏移 m = (2 * i * minor + major - 1) / (2 * major)，余数 r 随后增量更新
+    const int64_t two_major = 2 * major;
+    const int64_t two_minor = 2 * minor;
+    const int64_t n = i_begin * two_minor + major - 1;
+    int64_t m = n / two_major;
+    int64_t r = n % two_major;
+
+    // 次方向偏移相同的连续像素构成一个 run，整段混合
+    int64_t i = i_begin;
+    while (i < i_end)
+    {
+        const int64_t run_begin = i;
+        const int64_t run_m = m;
+        do
+        {
+            ++i;
+            r += two_minor;
+            if (r >= two_major)
+            {
+                r -= two_major;
+                ++m;
+            }
+        } while (i < i_end && m == run_m);
+
+        const int64_t b = b1 + sb * run_m;
+        if (b < b_min || b >= b_max)
+        {
+            continue;
+        }
+        const int64_t a_first = sa > 0 ? a1 + run_begin : a1 - (i - 1);
+        const int run = static_cast<int>(i - run_begin);
+        if (stencil != nullptr)
+        {
+            // 横向 run 按模板片段拆分，纵向 run 逐像素测试
+            if (x_major)
+            {
+                stencil->ForEachPassingRun(static_cast<int>(a_first), static_cast<int>(b), run, [&](int x, int length) {
+                    Blender::BlendSolidSpan(pixels + b * width + x, color, length, mode);
+                });
+            }
+            else
+            {
+                for (int64_t a = a_first; a < a_first + run; ++a)
+                {
+                    if (stencil->Test(static_cast<int>(b), static_cast<int>(a)))
+                    {
+                        uint32_t& dst = pixels[a * width + b];
+                        dst = Blender::BlendPixel(dst, color, mode);
+                    }
+                }
+            }
+        }
+        else if (x_major)
+        {
+            Blender::BlendSolidSpan(pixels + b * width + a_first, color, run, mode);
+        }
+        else
+        {
+            Blender::BlendSolidStrided(pixels + a_first * width + b, width, color, run, mode);
+        }
+    }
+}
+
+} // namespace
+
+void LineBatch::Reserve(size_t count)
+{
+    _x1.reserve(count);
+    _y1.reserve(count);
+    _x2.reserve(count);
+    _y2.reserve(count);
+    _colors.reserve(count);
+}
+
+void LineBatch::Add(int x1, int y1, int x2, int y2, const Color& color)
+{
+    _x1.push_back(x1);
+    _y1.push_back(y1);
+    _x2.push_back(x2);
+    _y2.push_back(y2);
+    _colors.push_back(Blender::Premultiply(color.ToUint32()));
+}
+
+void LineBatch::Add(const math::Point2f& start, const math::Point2f& end, const Color& color)
+{
+    Add(static_cast<int>(std::lround(start.X())), static_cast<int>(std::lround(start.Y())),
+        static_cast<int>(std::lround(end.X())), static_cast<int>(std::lround(end.Y())), color);
+}
+
+void LineBatch::Clear()
+{
+    _x1.clear();
+    _y1.clear();
+    _x2.clear();
+    _y2.clear();
+    _colors.clear();
+}
+
+std::unique_ptr<IPrimitive> LineBatch::Clone() const
+{
+    return std::make_unique<LineBatch>(*this);
+}
+
+math::BoundingBox2i LineBatch::Bounds() const
+{
+    math::BoundingBox2i box;
+    for (size_t i = 0; i < _x1.size(); ++i)
+    {
+        box.AddPoint(math::Point2i(std::min(_x1[i], _x2[i]), std::min(_y1[i], _y2[i])));
+        box.AddPoint(math::Point2i(std::max(_x1[i], _x2[i]) + 1, std::max(_y1[i], _y2[i]) + 1));
+    }
+    return box;
+}
+
+void LineBatch::Draw(PixelsBuffer& buffer) const
+{
+    if (_colors.empty() || buffer.ClipMinX() >= buffer.ClipMaxX() || buffer.ClipMinY() >= buffer.ClipMaxY())
+    {
+        return;
+    }
+    // 快速清除的瓦片在分发到各线程之前实体化，各线程只通过这个指针写像素
+    const math::BoundingBox2i bounds = Bounds();
+    uint32_t* pixels = buffer.PixelsForRegion(std::max(bounds.MinX(), buffer.ClipMinX()),
+                                              std::max(bounds.MinY(), buffer.ClipMinY()),
+                                              std::min(bounds.MaxX(), buffer.ClipMaxX()),
+                                              std::min(bounds.MaxY(), buffer.ClipMaxY()));
+    const StencilBuffer* stencil = buffer.StencilTest();
+
+    const int threads = parallel::ResolveThreadCount(_thread_count, _colors.size(), kParallelThreshold);
+    if (threads == 1)
+    {
+        // 单线程时分箱没有收益：直接按添加顺序在缓冲区的裁剪矩形内绘制
+        const BlendMode mode = buffer.GetBlendMode();
+        for (size_t i = 0; i < _colors.size(); ++i)
+        {
+            RasterizeLine(pixels, buffer.Width(), buffer.ClipMinX(), buffer.ClipMinY(), buffer.ClipMaxX(),
+                          buffer.ClipMaxY(), _x1[i], _y1[i], _x2[i], _y2[i], _colors[i], mode, stencil);
+        }
+        return;
+    }
+    // 分箱缓冲属于这一次调用：RunParallel 等待时调用线程可能执行其它作业（包括另一次 LineBatch 绘制），
+    // 不能与它们共享同一份
+    FrameArena::Scope scope(buffer.GetFrameArena());
+    Bins bins;
+    Bin(bins, buffer.GetFrameArena(), buffer.Width(), buffer.Height(), threads);
+
+    // 瓦片按原子计数器动态分配给各线程，瓦片之间像素不重叠，无需同步
+    const int tile_count = bins.tiles_x * bins.tiles_y;
+    std::atomic<int> next_tile{0};
+    auto draw_tiles = [&](int)
+    {
+        for (int tile = next_tile.fetch_add(1); tile < tile_count; tile = next_tile.fetch_add(1))
+        {
+            if (bins.tile_offsets[tile] != bins.tile_offsets[tile + 1])
+            {
+                DrawTile(buffer, pixels, bins, tile);
+            }
+        }
+    };
+    parallel::RunParallel(std::min(threads, tile_count), draw_tiles);
+}
+
+void LineBatch::Bin(Bins& bins, FrameArena* arena, int width, int height, int threads) const
+{
+    bins.tiles_x = (width + kTileSize - 1) / kTileSize;
+    bins.tiles_y = (height + kTileSize - 1) / kTileSize;
+    const int tile_count = bins.tiles_x * bins.tiles_y;
+
+    // 对每条可见线段调用 visit(tile, index)。
+    // Bresenham 的像素不会超出端点的整数包围盒，包围盒只覆盖少数几个瓦片时（短线段的常见情况）直接分到这些瓦片；
+    // 否则线段先裁剪到向外扩展 1 像素的屏幕矩形，再逐个瓦片行求出该行内线段的 x 范围（留 1 像素余量）。
+    // Bresenham 像素与理想直线在次方向上的距离不超过 0.5，因此分箱是保守的：
+    // 多分到的瓦片在光栅化时会被精确裁掉，不会影响结果。
+    const double max_x = static_cast<double>(width);
+    const double max_y = static_cast<double>(height);
+    const double tile_size = static_cast<double>(kTileSize);
+    auto for_each_tile = [&](size_t begin, size_t end, auto&& visit)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            // 批量剔除：包围盒完全在屏幕外
+            const int32_t box_x0 = std::min(_x1[i], _x2[i]);
+            const int32_t box_x1 = std::max(_x1[i], _x2[i]);
+            const int32_t box_y0 = std::min(_y1[i], _y2[i]);
+            const int32_t box_y1 = std::max(_y1[i], _y2[i]);
+            if (box_x1 < 0 || box_x0 >= width || box_y1 < 0 || box_y0 >= height)
+            {
+                continue;
+            }
+            const int box_col0 = std::max(box_x0, 0) >> kTileShift;
+            const int box_col1 = std::min(box_x1, width - 1) >> kTileShift;
+            const int box_row0 = std::max(box_y0, 0) >> kTileShift;
+            const int box_row1 = std::min(box_y1, height - 1) >> kTileShift;
+            if ((box_col1 - box_col0 + 1) * (box_row1 - box_row0 + 1) <= 4)
+            {
+                for (int row = box_row0; row <= box_row1; ++row)
+                {
+                    for (int col = box_col0; col <= box_col1; ++col)
+                    {
+                        visit(row * bins.tiles_x + col, static_cast<uint32_t>(i));
+                    }
+                }
+                continue;
+            }
+            double x0 = _x1[i];
+            double y0 = _y1[i];
+            double x1 = _x2[i];
+            double y1 = _y2[i];
+            if (!ClipSegment(x0, y0, x1, y1, -1.0, -1.0, max_x, max_y))
+            {
+                continue;
+            }
+            if (y0 > y1)
+            {
+                std::swap(x0, x1);
+                std::swap(y0, y1);
+            }
+            const double inv_dy = y1 > y0 ? (x1 - x0) / (y1 - y0) : 0.0;
+            const int row_begin = std::max(static_cast<int>(std::floor((y0 - 1.0) / tile_size)), 0);
+            const int row_end = std::min(static_cast<int>(std::floor((y1 + 1.0) / tile_size)), bins.tiles_y - 1);
+            for (int row = row_begin; row <= row_end; ++row)
+            {
+                double x_min = std::min(x0, x1);
+                double x_max = std::max(x0, x1);
+                if (y1 > y0)
+                {
+                    // 该瓦片行对应的 y 区间（上下各留 1 像素余量）与线段的交
+                    const double ya = std::max(y0, row * tile_size - 1.0);
+                    const double yb = std::min(y1, (row + 1) * tile_size);
+                    const double xa = x0 + (ya - y0) * inv_dy;
+                    const double xb = x0 + (yb - y0) * inv_dy;
+                    x_min = std::min(xa, xb);
+                    x_max = std::max(xa, xb);
+                }
+                const int col_begin = std::max(static_cast<int>(std::floor((x_min - 1.0) / tile_size)), 0);
+                const int col_end = std::min(static_cast<int>(std::floor((x_max + 1.0) / tile_size)), bins.tiles_x - 1);
+                for (int col = col_begin; col <= col_end; ++col)
+                {
+                    visit(row * bins.tiles_x + col, static_cast<uint32_t>(i));
+                }
+            }
+        }
+    };
+
+    // 并行计数排序：线段按顺序切成 threads 段，每个线程统计自己那段在各瓦片中的线段数；
+    // 按（瓦片, 线程）顺序求前缀和得到每个线程在每个瓦片中的写入位置，再各自写入。
+    // 瓦片内的线段仍保持添加顺序，结果与线程数无关。
+    const size_t count = _colors.size();
+    const size_t cursor_count = static_cast<size_t>(threads) * tile_count;
+    bins.cursors = ScratchArray(arena, cursor_count, bins.cursors_fallback);
+    std::fill_n(bins.cursors, cursor_count, 0u);
+    auto chunk_begin = [count, threads](int thread) { return count * thread / threads; };
+    auto count_chunk = [&](int thread)
+    {
+        uint32_t* counts = bins.cursors + static_cast<size_t>(thread) * tile_count;
+        for_each_tile(chunk_begin(thread), chunk_begin(thread + 1), [counts](int tile, uint32_t) { ++counts[tile]; });
+    };
+    parallel::RunParallel(threads, count_chunk);
+
+    bins.tile_offsets = ScratchArray(arena, static_cast<size_t>(tile_count) + 1, bins.offsets_fallback);
+    uint32_t total = 0;
+    for (int tile = 0; tile < tile_count; ++tile)
+    {
+        bins.tile_offsets[tile] = total;
+        for (int thread = 0; thread < threads; ++thread)
+        {
+            uint32_t& cursor = bins.cursors[static_cast<size_t>(thread) * tile_count + tile];
+            const uint32_t tile_thread_count = cursor;
+            cursor = total;
+            total += tile_thread_count;
+        }
+    }
+    bins.tile_offsets[tile_count] = total;
+    bins.tile_lines = ScratchArray(arena, static_cast<size_t>(total), bins.lines_fallback);
+
+    auto scatter_chunk = [&](int thread)
+    {
+        uint32_t* cursors = bins.cursors + static_cast<size_t>(thread) * tile_count;
+        for_each_tile(chunk_begin(thread), chunk_begin(thread + 1),
+                      [this, &bins, cursors](int tile, uint32_t index) {
+                          bins.tile_lines[cursors[tile]++] = {_x1[index], _y1[index], _x2[index], _y2[index],
+                                                              _colors[index]};
+                      });
+    };
+    parallel::RunParallel(threads, scatter_chunk);
+}
+
+void LineBatch::DrawTile(PixelsBuffer& buffer, uint32_t* pixels, const Bins& bins, int tile) const
+{
+    // 瓦片与缓冲区的裁剪矩形求交，完全在裁剪矩形之外的瓦片直接跳过
+    const int tile_x0 = std::max((tile % bins.tiles_x) * kTileSize, buffer.ClipMinX());
+    const int tile_y0 = std::max((tile / bins.tiles_x) * kTileSize, buffer.ClipMinY());
+    const int tile_x1 = std::min((tile % bins.tiles_x) * kTileSize + kTileSize, buffer.ClipMaxX());
+    const int tile_y1 = std::min((tile / bins.tiles_x) * kTileSize + kTileSize, buffer.ClipMaxY());
+    if (tile_x0 >= tile_x1 || tile_y0 >= tile_y1)
+    {
+        return;
+    }
+    const BlendMode mode = buffer.GetBlendMode();
+    const StencilBuffer* stencil = buffer.StencilTest();
+    for (uint32_t k = bins.tile_offsets[tile]; k < bins.tile_offsets[tile + 1]; ++k)
+    {
+        const BinnedLine& line = bins.tile_lines[k];
+        RasterizeLine(pixels, buffer.Width(), tile_x0, tile_y0, tile_x1, tile_y1, line.x1, line.y1, line.x2,
+                      line.y2, line.color, mode, stencil);
+    }
+}
+
+} // namespace pri
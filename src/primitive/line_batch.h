@@ -0,0 +1,129 @@
+//
+// Created by admin on 2026/2/11.
+//
+
+#ifndef LINE_BATCH_H
+#define LINE_BATCH_H
+
+#include "../math/point.h"
+#include "primitive.h"
+#include <cstdint>
+#include <vector>
+
+namespace pri
+{
+
+/**
+ * @brief 批量直线图元（面向百万级线段的线框 / 连接图）
+ *
+ * 与逐条构造 LinePrimitive 相比：
+ *   - 端点和颜色按 SoA（结构数组）存储，添加一条线段只是几次 push_back，没有对象和虚函数开销
+ *   - 绘制时先整批剔除完全在屏幕外的线段，再把裁剪后的线段按覆盖范围分箱到 kTileSize 见方的屏幕瓦片，
+ *     分箱时把线段数据复制到瓦片各自的连续区域，光栅化时顺序读取
+ *   - 分箱按线段区间并行计数排序；各瓦片互不重叠，由多个线程并行光栅化，无需加锁
+ *   - 瓦片内按添加顺序绘制，结果与线程数无关
+ *
+ * 光栅化与 LinePrimitive 的 Bresenham 模式逐像素一致：第 i 步的次方向偏移按闭式
+ * (2 * i * minor + major - 1) / (2 * major) 计算，因此线段可以从任意瓦片边界处开始增量步进，
+ * 跨瓦片的像素既不会遗漏也不会重复混合。
+ */
+class LineBatch : public IPrimitive
+{
+  public:
+    // 瓦片边长（像素）
+    static constexpr int kTileShift = 6;
+    static constexpr int kTileSize = 1 << kTileShift;
+
+    LineBatch() = default;
+
+    void Draw(PixelsBuffer& buffer) const override;
+    std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
+
+    /**
+     * @brief 预留线段容量
+     */
+    void Reserve(size_t count);
+
+    /**
+     * @brief 添加一条线段（整数端点位于像素中心）
+     */
+    void Add(int x1, int y1, int x2, int y2, const Color& color);
+
+    /**
+     * @brief 添加一条线段（浮点端点四舍五入到像素中心）
+     */
+    void Add(const math::Point2f& start, const math::Point2f& end, const Color& color);
+
+    /**
+     * @brief 清空所有线段（保留容量，便于每帧重建）
+     */
+    void Clear();
+
+    size_t Size() const
+    {
+        return _colors.size();
+    }
+
+    bool Empty() const
+    {
+        return _colors.empty();
+    }
+
+    /**
+     * @brief 设置光栅化线程数，0 表示使用硬件并发数（默认）
+     */
+    void SetThreadCount(int count)
+    {
+        _thread_count = count;
+    }
+    int GetThreadCount() const
+    {
+        return _thread_count;
+    }
+
+  private:
+    // 分箱后的线段（紧凑 AoS，同一瓦片的线段连续存放）
+    struct BinnedLine
+    {
+        int32_t x1;
+        int32_t y1;
+        int32_t x2;
+        int32_t y2;
+        uint32_t color;
+    };
+
+    // 一次绘制的分箱结果：每次 Draw 调用一份，在调用线程上从缓冲区的帧内分配器借用（没有分配器时使用后备 vector），
+    // 不保存在图元中，也不跨调用共享，因此嵌套或并发的绘制互不干扰
+    struct Bins
+    {
+        int tiles_x = 0;
+        int tiles_y = 0;
+        uint32_t* tile_offsets = nullptr;
+        BinnedLine* tile_lines = nullptr;
+        uint32_t* cursors = nullptr; // 每个线程在每个瓦片中的计数 / 写入位置
+        std::vector<uint32_t> offsets_fallback;
+        std::vector<BinnedLine> lines_fallback;
+        std::vector<uint32_t> cursors_fallback;
+    };
+
+    // 剔除并把线段分箱到瓦片（计数排序：tile_offsets 为每个瓦片在 tile_lines 中的起始位置）
+    // 所有缓冲都在调用线程上分配，工作线程只读写已分配好的内存
+    void Bin(Bins& bins, FrameArena* arena, int width, int height, int threads) const;
+
+    // 光栅化单个瓦片内的所有线段（pixels 为已实体化的像素数据）
+    void DrawTile(PixelsBuffer& buffer, uint32_t* pixels, const Bins& bins, int tile) const;
+
+    // SoA 存储
+    std::vector<int32_t> _x1;
+    std::vector<int32_t> _y1;
+    std::vector<int32_t> _x2;
+    std::vector<int32_t> _y2;
+    std::vector<uint32_t> _colors; // 预乘颜色
+
+    int _thread_count = 0;
+};
+
+} // namespace pri
+
+#endif // LINE_BATCH_H
@@ -4,10 +4,67 @@
 
 #include "line_primitive.h"
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 namespace pri
 {
 
+namespace
+{
+
+// 渐变颜色的定点步进器
+// 在预乘空间按 8.16 定点数逐通道插值（不依赖通道的字节顺序），每个像素只需 4 次整数加法；
+// 每条直线只在初始化时做一次除法。
+class ColorStepper
+{
+  public:
+    /**
+     * @param start 起点颜色（预乘）
+     * @param end 终点颜色（预乘）
+     * @param steps 从起点到终点的步数，为 0 时始终取起点颜色
+     */
+    ColorStepper(uint32_t start, uint32_t end, int steps)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            const int32_t from = static_cast<int32_t>((start >> (8 * i)) & 0xFFu);
+            const int32_t to = static_cast<int32_t>((end >> (8 * i)) & 0xFFu);
+            _value[i] = (from << 16) + 0x8000; // 预加 0.5，取高位时即为四舍五入
+            _delta[i] = steps > 0 ? ((to - from) << 16) / steps : 0;
+        }
+    }
+
+    uint32_t Pixel() const
+    {
+        return (static_cast<uint32_t>(_value[0] >> 16)) | (static_cast<uint32_t>(_value[1] >> 16) << 8) |
+               (static_cast<uint32_t>(_value[2] >> 16) << 16) | (static_cast<uint32_t>(_value[3] >> 16) << 24);
+    }
+
+    void Step()
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            _value[i] += _delta[i];
+        }
+    }
+
+    // 一次前进 count 步（用于跳过被裁剪掉的像素）
+    void Advance(int count)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            _value[i] += _delta[i] * count;
+        }
+    }
+
+  private:
+    int32_t _value[4];
+    int32_t _delta[4];
+};
+
+} // namespace
+
 // LinePrimitive 实现
 void LinePrimitive::Draw(PixelsBuffer& buffer) const
 {
@@ -21,59 +78,149 @@ void LinePrimitive::Draw(PixelsBuffer& buffer) const
     }
 }
 
-// Bresenham 直线算法
+// Bresenham 直线算法（按 run 输出）
+//
+// 逐像素版本的状态转移为：
+//   e2 = 2 * err;  if (e2 > -dy) { err -= dy; x += sx; }  if (e2 < dx) { err += dx; y += sy; }
+// 当 dx >= dy 时 x 每一步都前进，同一行上连续的像素构成一个水平 run；
+// 设 run 的第一个像素处 err = e，则 run 长度为满足 2 * (e - (k - 1) * dy) < dx 的最小 k，
+// 可以直接算出，无需逐像素判断。dy > dx 时 x 与 y 的角色互换（err 取反），得到竖直 run。
+// 输出与逐像素版本完全一致。
+// 两个端点颜色不同时，run 内按前进方向逐像素混合，颜色每个像素步进一次。
 void LinePrimitive::DrawBresenham(PixelsBuffer& buffer) const
 {
-    int dx = std::abs(_x2 - _x1);
-    int dy = std::abs(_y2 - _y1);
-    int sx = (_x1 < _x2) ? 1 : -1;
-    int sy = (_y1 < _y2) ? 1 : -1;
-    int err = dx - dy; // x方向的路程比 y 多多少
-
-    int x = _x1;
-    int y = _y1;
-
-    //     err 小                    err 大
-    //   ←                         →
-    // ├───────────────────┼───────────────────┤
-    // -dy                  0                  dx
-    // "欠 x 方向"                      "欠 y 方向"
-
-    //     ←─────────────────────────────→
-    // -dy        -dy/2   0   dx/2        dx
-    // ├───────────┼─────┼─────┼───────────┤
-    // │   只走y   │  两者都走   │   只走x    │
-
-    while (true)
+    // Bresenham 只处理整数端点
+    const int x1 = X1();
+    const int y1 = Y1();
+    const int dx = std::abs(X2() - x1);
+    const int dy = std::abs(Y2() - y1);
+    const int sx = (x1 < X2()) ? 1 : -1;
+    const int sy = (y1 < Y2()) ? 1 : -1;
+
+    const int width = buffer.Width();
+    // run 在计算出来时就裁剪到缓冲区的裁剪矩形
+    const int clip_x0 = buffer.ClipMinX();
+    const int clip_y0 = buffer.ClipMinY();
+    const int clip_x1 = buffer.ClipMaxX();
+    const int clip_y1 = buffer.ClipMaxY();
+    const StencilBuffer* stencil = buffer.StencilTest();
+    const uint32_t color = Blender::Premultiply(_color.ToUint32());
+    const BlendMode mode = buffer.GetBlendMode();
+    const math::BoundingBox2i region = Bounds();
+    uint32_t* pixels = buffer.PixelsForRegion(region.MinX(), region.MinY(), region.MaxX(), region.MaxY());
+    const bool gradient = IsGradient();
+
+    // 主方向上的步数为 major，次方向为 minor；run 长度只取决于 err
+    const bool x_major = dx >= dy;
+    const int major = x_major ? dx : dy;
+    const int minor = x_major ? dy : dx;
+    int err = major - minor;
+    int x = x1;
+    int y = y1;
+    int remaining = major + 1;
+    ColorStepper stepper(color, Blender::Premultiply(_end_color.ToUint32()), major);
+
+    while (remaining > 0)
     {
-        buffer.SetPixel(x, y, _color);
-        if (x == _x2 && y == _y2)
-            break;
-        int e2 = 2 * err; // 避免除2产生浮点数, 等价于 err > -dy / 2, err < dx / 2
-        if (e2 > -dy)     // err > -dy/2
+        int run = remaining;
+        if (minor != 0)
         {
-            err -= dy;
-            x += sx;
+            run = std::min(2 * err >= major ? (2 * err - major) / (2 * minor) + 2 : 1, remaining);
+        }
+
+        if (gradient)
+        {
+            // 渐变：沿前进方向逐像素混合，裁剪掉的像素也要步进颜色
+            const int step_x = x_major ? sx : 0;
+            const int step_y = x_major ? 0 : sy;
+            int px = x;
+            int py = y;
+            for (int i = 0; i < run; ++i, px += step_x, py += step_y, stepper.Step())
+            {
+                if (buffer.IsWritable(px, py))
+                {
+                    uint32_t& dst = pixels[static_cast<size_t>(py) * width + px];
+                    dst = Blender::BlendPixel(dst, stepper.Pixel(), mode);
+                }
+            }
+            if (x_major)
+            {
+                x += sx * run;
+                y += sy;
+            }
+            else
+            {
+                y += sy * run;
+                x += sx;
+            }
         }
-        if (e2 < dx) // err < dx/2
+        else if (x_major)
         {
-            err += dx;
+            // 水平 run：[x, x + sx * (run - 1)]，裁剪后整段填充
+            if (y >= clip_y0 && y < clip_y1)
+            {
+                const int x_first = sx > 0 ? x : x - run + 1;
+                const int x_begin = std::max(x_first, clip_x0);
+                const int x_end = std::min(x_first + run, clip_x1);
+                uint32_t* row = pixels + static_cast<size_t>(y) * width;
+                buffer.ForEachWritableRun(y, x_begin, x_end, [&](int begin, int end) {
+                    Blender::BlendSolidSpan(row + begin, color, end - begin, mode);
+                });
+            }
+            x += sx * run;
             y += sy;
         }
+        else
+        {
+            // 竖直 run：行指针每次前进一个 pitch
+            if (x >= clip_x0 && x < clip_x1)
+            {
+                const int y_first = sy > 0 ? y : y - run + 1;
+                const int y_begin = std::max(y_first, clip_y0);
+                const int y_end = std::min(y_first + run, clip_y1);
+                if (stencil != nullptr)
+                {
+                    // 竖直 run 的模板值不连续，逐像素测试
+                    for (int py = y_begin; py < y_end; ++py)
+                    {
+                        if (stencil->Test(x, py))
+                        {
+                            uint32_t& dst = pixels[static_cast<size_t>(py) * width + x];
+                            dst = Blender::BlendPixel(dst, color, mode);
+                        }
+                    }
+                }
+                else if (y_begin < y_end)
+                {
+                    Blender::BlendSolidStrided(pixels + static_cast<size_t>(y_begin) * width + x, width, color,
+                                               y_end - y_begin, mode);
+                }
+            }
+            y += sy * run;
+            x += sx;
+        }
+        err += major - run * minor;
+        remaining -= run;
     }
 }
 
 // Wu 氏抗锯齿直线算法
+//
+// 端点为浮点坐标，两个端点像素按浮点计算覆盖率；中间像素沿主方向每步前进一个像素，
+// 次方向交点用 16.16 定点数累加，覆盖率直接取小数部分的高 8 位，循环内没有浮点运算。
+// 每一步的两个像素按覆盖率与帧缓冲中的实际像素混合（BlendPixelPair 一次完成）。
+// 渐变颜色沿主方向从起点像素到终点像素按定点数逐像素步进。
 void LinePrimitive::DrawAntialiased(PixelsBuffer& buffer) const
 {
-    float x0 = static_cast<float>(_x1);
-    float y0 = static_cast<float>(_y1);
-    float x1 = static_cast<float>(_x2);
-    float y1 = static_cast<float>(_y2);
+    float x0 = _x1;
+    float y0 = _y1;
+    float x1 = _x2;
+    float y1 = _y2;
+    uint32_t color0 = Blender::Premultiply(_color.ToUint32());
+    uint32_t color1 = Blender::Premultiply(_end_color.ToUint32());
 
     // 判断是否需要交换xy (斜率是否 > 1)
-    bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
-
+    const bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
     if (steep)
     {
         std::swap(x0, y0);
@@ -85,72 +232,109 @@ void LinePrimitive::DrawAntialiased(PixelsBuffer& buffer) const
     {
         std::swap(x0, x1);
         std::swap(y0, y1);
+        std::swap(color0, color1);
     }
 
-    float dx = x1 - x0;
-    float dy = y1 - y0;
-    float gradient = (dx == 0) ? 1.0f : dy / dx; // 斜率
+    const float dx = x1 - x0;
+    const float dy = y1 - y0;
+    const float gradient = (dx == 0.0f) ? 1.0f : dy / dx; // 斜率
 
-    // 处理起点
-    float xend = std::round(x0);
-    float yend = y0 + gradient * (xend - x0);
-    float xgap = rfpart(x0 + 0.5f);
-    int xpxl1 = static_cast<int>(xend);
-    int ypxl1 = static_cast<int>(yend);
+    const int width = buffer.Width();
+    // 主方向 / 次方向上裁剪矩形的范围
+    const int major_min = steep ? buffer.ClipMinY() : buffer.ClipMinX();
+    const int major_max = steep ? buffer.ClipMaxY() : buffer.ClipMaxX();
+    const int minor_min = steep ? buffer.ClipMinX() : buffer.ClipMinY();
+    const int minor_max = steep ? buffer.ClipMaxX() : buffer.ClipMaxY();
+    const StencilBuffer* stencil = buffer.StencilTest();
+    const BlendMode mode = buffer.GetBlendMode();
+    const math::BoundingBox2i region = Bounds();
+    uint32_t* pixels = buffer.PixelsForRegion(region.MinX(), region.MinY(), region.MaxX(), region.MaxY());
+    // 次方向上相邻两个像素在内存中的距离
+    const ptrdiff_t minor_step = steep ? 1 : width;
 
-    if (steep)
+    // 在主方向 major、次方向 minor 和 minor + 1 处各画一个像素
+    auto plot_pair = [&](int major, int minor, uint32_t color, uint8_t coverage0, uint8_t coverage1)
     {
-        buffer.SetPixel(ypxl1, xpxl1, BlendColor(_color, rfpart(yend) * xgap));
-        buffer.SetPixel(ypxl1 + 1, xpxl1, BlendColor(_color, fpart(yend) * xgap));
-    }
-    else
+        if (major < major_min || major >= major_max || minor < minor_min - 1 || minor >= minor_max)
+        {
+            return;
+        }
+        auto passes = [&](int m)
+        {
+            return stencil == nullptr || (steep ? stencil->Test(m, major) : stencil->Test(major, m));
+        };
+        const bool first = minor >= minor_min && passes(minor);
+        const bool second = minor + 1 < minor_max && passes(minor + 1);
+        uint32_t* p0 = steep ? pixels + static_cast<ptrdiff_t>(major) * width + minor
+                             : pixels + static_cast<ptrdiff_t>(minor) * width + major;
+        if (first && second)
+        {
+            Blender::BlendPixelPair(p0, p0 + minor_step, color, coverage0, coverage1, mode);
+        }
+        else if (first)
+        {
+            *p0 = Blender::BlendPixel(*p0, color, coverage0, mode);
+        }
+        else if (second)
+        {
+            p0 += minor_step;
+            *p0 = Blender::BlendPixel(*p0, color, coverage1, mode);
+        }
+    };
+
+    // 两个端点落在同一个主方向像素内：只画一次，覆盖率为线段在这一像素内的长度（两端覆盖率之和减 1）
+    if (std::round(x0) == std::round(x1))
     {
-        buffer.SetPixel(xpxl1, ypxl1, BlendColor(_color, rfpart(yend) * xgap));
-        buffer.SetPixel(xpxl1, ypxl1 + 1, BlendColor(_color, fpart(yend) * xgap));
+        const float ymid = 0.5f * (y0 + y1);
+        const float xgap = x1 - x0;
+        plot_pair(static_cast<int>(std::round(x0)), static_cast<int>(std::floor(ymid)), color0,
+                  Coverage(rfpart(ymid) * xgap), Coverage(fpart(ymid) * xgap));
+        return;
     }
 
-    float intery = yend + gradient; // 第一个y交点
+    // 处理起点
+    float xend = std::round(x0);
+    float yend = y0 + gradient * (xend - x0);
+    float xgap = rfpart(x0 + 0.5f);
+    const int xpxl1 = static_cast<int>(xend);
+    plot_pair(xpxl1, static_cast<int>(std::floor(yend)), color0, Coverage(rfpart(yend) * xgap),
+              Coverage(fpart(yend) * xgap));
+    const float intery = yend + gradient; // 第一个y交点
 
     // 处理终点
     xend = std::round(x1);
     yend = y1 + gradient * (xend - x1);
     xgap = fpart(x1 + 0.5f);
-    int xpxl2 = static_cast<int>(xend);
-    int ypxl2 = static_cast<int>(yend);
+    const int xpxl2 = static_cast<int>(xend);
+    plot_pair(xpxl2, static_cast<int>(std::floor(yend)), color1, Coverage(rfpart(yend) * xgap),
+              Coverage(fpart(yend) * xgap));
 
-    if (steep)
+    // 主循环: 绘制中间的所有点（主方向先裁剪到裁剪矩形内）
+    const int x_begin = std::max(xpxl1 + 1, major_min);
+    const int x_end = std::min(xpxl2, major_max);
+    if (x_begin >= x_end)
     {
-        buffer.SetPixel(ypxl2, xpxl2, BlendColor(_color, rfpart(yend) * xgap));
-        buffer.SetPixel(ypxl2 + 1, xpxl2, BlendColor(_color, fpart(yend) * xgap));
+        return;
     }
-    else
+    constexpr float kFixedOne = 65536.0f;
+    int64_t y_fixed = std::llround((intery + gradient * static_cast<float>(x_begin - xpxl1 - 1)) * kFixedOne);
+    const int64_t step_fixed = std::llround(gradient * kFixedOne);
+    if (color0 == color1)
     {
-        buffer.SetPixel(xpxl2, ypxl2, BlendColor(_color, rfpart(yend) * xgap));
-        buffer.SetPixel(xpxl2, ypxl2 + 1, BlendColor(_color, fpart(yend) * xgap));
-    }
-
-    // 主循环: 绘制中间的所有点
-    if (steep)
-    {
-        for (int x = xpxl1 + 1; x < xpxl2; x++)
+        for (int x = x_begin; x < x_end; ++x, y_fixed += step_fixed)
         {
-            int y = static_cast<int>(intery);
-            // 绘制两个相邻像素，透明度根据距离
-            buffer.SetPixel(y, x, BlendColor(_color, rfpart(intery)));
-            buffer.SetPixel(y + 1, x, BlendColor(_color, fpart(intery)));
-            intery += gradient;
+            // 小数部分的高 8 位即为下方像素的覆盖率
+            const uint8_t frac = static_cast<uint8_t>((y_fixed >> 8) & 0xFF);
+            plot_pair(x, static_cast<int>(y_fixed >> 16), color0, static_cast<uint8_t>(255 - frac), frac);
         }
+        return;
     }
-    else
+    ColorStepper stepper(color0, color1, xpxl2 - xpxl1);
+    stepper.Advance(x_begin - xpxl1);
+    for (int x = x_begin; x < x_end; ++x, y_fixed += step_fixed, stepper.Step())
     {
-        for (int x = xpxl1 + 1; x < xpxl2; x++)
-        {
-            int y = static_cast<int>(intery);
-            // 绘制两个相邻像素，透明度根据距离
-            buffer.SetPixel(x, y, BlendColor(_color, rfpart(intery)));
-            buffer.SetPixel(x, y + 1, BlendColor(_color, fpart(intery)));
-            intery += gradient;
-        }
+        const uint8_t frac = static_cast<uint8_t>((y_fixed >> 8) & 0xFF);
+        plot_pair(x, static_cast<int>(y_fixed >> 16), stepper.Pixel(), static_cast<uint8_t>(255 - frac), frac);
     }
 }
 
@@ -159,4 +343,10 @@ std::unique_ptr<IPrimitive> LinePrimitive::Clone() const
     return std::make_unique<LinePrimitive>(*this);
 }
 
+math::BoundingBox2i LinePrimitive::Bounds() const
+{
+    // Wu 算法在端点所在像素的两侧各写一个像素
+    return PixelBounds(std::min(_x1, _x2), std::min(_y1, _y2), std::max(_x1, _x2), std::max(_y1, _y2), 1.0f);
+}
+
 } // namespace pri
\ No newline at end of file
@@ -8,22 +8,52 @@
 #include "../math/line.h"
 #include "point_primitive.h"
 #include "primitive.h"
+#include <algorithm>
 #include <cmath>
 
 namespace pri
 {
 
-// 线图元（支持抗锯齿）
+// 线图元（支持抗锯齿，两个端点可以指定不同颜色形成渐变）
 class LinePrimitive : public IPrimitive
 {
   public:
     LinePrimitive(int x1, int y1, int x2, int y2, const Color& color, bool antialiased = false)
-        : _x1(x1), _y1(y1), _x2(x2), _y2(y2), _color(color), _antialiased(antialiased)
+        : _x1(static_cast<float>(x1)), _y1(static_cast<float>(y1)), _x2(static_cast<float>(x2)),
+          _y2(static_cast<float>(y2)), _color(color), _end_color(color), _antialiased(antialiased)
     {
     }
 
+    /**
+     * @brief 从两个点图元构造，颜色从起点颜色渐变到终点颜色
+     */
     LinePrimitive(PointPrimitive start, PointPrimitive end, bool antialiased = false)
-        : _x1(start.X()), _y1(start.Y()), _x2(end.X()), _y2(end.Y()), _color(start.GetColor()),
+        : _x1(static_cast<float>(start.X())), _y1(static_cast<float>(start.Y())), _x2(static_cast<float>(end.X())),
+          _y2(static_cast<float>(end.Y())), _color(start.GetColor()), _end_color(end.GetColor()),
+          _antialiased(antialiased)
+    {
+    }
+
+    /**
+     * @brief 从浮点端点构造（保留亚像素精度，抗锯齿模式下生效）
+     * @param start 起点
+     * @param end 终点
+     * @param color 颜色
+     * @param antialiased 是否开启抗锯齿
+     */
+    LinePrimitive(const math::Point2f& start, const math::Point2f& end, const Color& color, bool antialiased = false)
+        : LinePrimitive(start, end, color, color, antialiased)
+    {
+    }
+
+    /**
+     * @brief 从浮点端点和两个端点颜色构造（渐变直线）
+     * @param start_color 起点颜色
+     * @param end_color 终点颜色
+     */
+    LinePrimitive(const math::Point2f& start, const math::Point2f& end, const Color& start_color,
+                  const Color& end_color, bool antialiased = false)
+        : _x1(start.X()), _y1(start.Y()), _x2(end.X()), _y2(end.Y()), _color(start_color), _end_color(end_color),
           _antialiased(antialiased)
     {
     }
@@ -35,48 +65,66 @@ class LinePrimitive : public IPrimitive
      * @param antialiased 是否开启抗锯齿
      */
     LinePrimitive(const math::Line2i& line, const Color& color, bool antialiased = false)
-        : _x1(line.Start().X()), _y1(line.Start().Y()), _x2(line.End().X()), _y2(line.End().Y()), _color(color),
-          _antialiased(antialiased)
+        : LinePrimitive(line.Start().X(), line.Start().Y(), line.End().X(), line.End().Y(), color, antialiased)
     {
     }
 
     /**
-     * @brief 从 math::Line2f 构造（四舍五入）
+     * @brief 从 math::Line2f 构造（保留亚像素精度，Bresenham 模式下端点四舍五入）
      * @param line 二维浮点线段
      * @param color 颜色
      * @param antialiased 是否开启抗锯齿
      */
     LinePrimitive(const math::Line2f& line, const Color& color, bool antialiased = false)
-        : _x1(static_cast<int>(std::round(line.Start().X()))), _y1(static_cast<int>(std::round(line.Start().Y()))),
-          _x2(static_cast<int>(std::round(line.End().X()))), _y2(static_cast<int>(std::round(line.End().Y()))),
-          _color(color), _antialiased(antialiased)
+        : LinePrimitive(line.Start(), line.End(), color, antialiased)
     {
     }
 
     void Draw(PixelsBuffer& buffer) const override;
     std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
 
-    // 获取属性
+    // 获取属性（整数坐标为四舍五入后的端点）
     int X1() const
     {
-        return _x1;
+        return static_cast<int>(std::lround(_x1));
     }
     int Y1() const
     {
-        return _y1;
+        return static_cast<int>(std::lround(_y1));
     }
     int X2() const
     {
-        return _x2;
+        return static_cast<int>(std::lround(_x2));
     }
     int Y2() const
     {
-        return _y2;
+        return static_cast<int>(std::lround(_y2));
+    }
+    math::Point2f Start() const
+    {
+        return math::Point2f(_x1, _y1);
+    }
+    math::Point2f End() const
+    {
+        return math::Point2f(_x2, _y2);
     }
     Color GetColor() const
     {
         return _color;
     }
+    Color GetStartColor() const
+    {
+        return _color;
+    }
+    Color GetEndColor() const
+    {
+        return _end_color;
+    }
+    bool IsGradient() const
+    {
+        return _color != _end_color;
+    }
     bool IsAntialiased() const
     {
         return _antialiased;
@@ -85,19 +133,39 @@ class LinePrimitive : public IPrimitive
     // 设置属性
     void SetStart(int x, int y)
     {
-        _x1 = x;
-        _y1 = y;
+        _x1 = static_cast<float>(x);
+        _y1 = static_cast<float>(y);
     }
 
     void SetEnd(int x, int y)
     {
-        _x2 = x;
-        _y2 = y;
+        _x2 = static_cast<float>(x);
+        _y2 = static_cast<float>(y);
     }
 
+    void SetStart(const math::Point2f& start)
+    {
+        _x1 = start.X();
+        _y1 = start.Y();
+    }
+
+    void SetEnd(const math::Point2f& end)
+    {
+        _x2 = end.X();
+        _y2 = end.Y();
+    }
+
+    // 设置单一颜色（两个端点相同）
     void SetColor(const Color& color)
     {
         _color = color;
+        _end_color = color;
+    }
+
+    void SetColors(const Color& start_color, const Color& end_color)
+    {
+        _color = start_color;
+        _end_color = end_color;
     }
 
     /**
@@ -115,7 +183,7 @@ class LinePrimitive : public IPrimitive
      */
     math::Line2i ToLine2i() const
     {
-        return math::Line2i(math::Point2i(_x1, _y1), math::Point2i(_x2, _y2));
+        return math::Line2i(math::Point2i(X1(), Y1()), math::Point2i(X2(), Y2()));
     }
 
     /**
@@ -124,22 +192,22 @@ class LinePrimitive : public IPrimitive
      */
     math::Line2f ToLine2f() const
     {
-        return math::Line2f(math::Point2f(static_cast<float>(_x1), static_cast<float>(_y1)),
-                            math::Point2f(static_cast<float>(_x2), static_cast<float>(_y2)));
+        return math::Line2f(math::Point2f(_x1, _y1), math::Point2f(_x2, _y2));
     }
 
   private:
-    int _x1;
-    int _y1;
-    int _x2;
-    int _y2;
-    Color _color;
+    float _x1; // 端点（浮点，整数坐标位于像素中心）
+    float _y1;
+    float _x2;
+    float _y2;
+    Color _color;     // 起点颜色
+    Color _end_color; // 终点颜色
     bool _antialiased = false; // 是否启用抗锯齿
 
     // Bresenham 直线绘制
     void DrawBresenham(PixelsBuffer& buffer) const;
 
-    // Wu 氏抗锯齿直线绘制
+    // Wu 氏抗锯齿直线绘制（浮点端点，16.16 定点步进）
     void DrawAntialiased(PixelsBuffer& buffer) const;
 
     // 辅助函数: 返回小数部分
@@ -154,14 +222,10 @@ class LinePrimitive : public IPrimitive
         return 1.0f - fpart(x);
     }
 
-    // 辅助函数: 混合颜色与背景
-    static Color BlendColor(const Color& fg, float alpha, const Color& bg = Color::Black())
+    // 辅助函数: 将 [0, 1] 的覆盖率转换为 [0, 255]，与帧缓冲中的实际像素混合
+    static uint8_t Coverage(float alpha)
     {
-        // Alpha混合
-        uint8_t r = static_cast<uint8_t>(fg.R() * alpha + bg.R() * (1.0f - alpha));
-        uint8_t g = static_cast<uint8_t>(fg.G() * alpha + bg.G() * (1.0f - alpha));
-        uint8_t b = static_cast<uint8_t>(fg.B() * alpha + bg.B() * (1.0f - alpha));
-        return Color(r, g, b);
+        return static_cast<uint8_t>(std::clamp(alpha, 0.0f, 1.0f) * 255.0f + 0.5f);
     }
 };
 
@@ -0,0 +1,119 @@
+//
+// Created by admin on 2026/2/23.
+//
+
+#include "nine_slice_primitive.h"
+#include "../frame_arena.h"
+#include <algorithm>
+#include <vector>
+
+namespace pri
+{
+
+namespace
+{
+
+// 把长度 length 分成 [head, length - head - tail, tail] 三段，两端之和超过 length 时按比例缩小
+void SplitAxis(int length, int head, int tail, int& out_head, int& out_tail)
+{
+    if (head + tail > length)
+    {
+        out_head = head + tail > 0 ? static_cast<int>(static_cast<int64_t>(length) * head / (head + tail)) : 0;
+        out_tail = length - out_head;
+        return;
+    }
+    out_head = head;
+    out_tail = tail;
+}
+
+} // namespace
+
+void NineSlicePrimitive::Draw(PixelsBuffer& buffer) const
+{
+    const texture::Texture* texture = _texture.get();
+    const uint32_t* pixels = texture ? texture->Pixels() : nullptr;
+    if (pixels == nullptr || !_rect.IsValid() || _rect.Width() <= 0 || _rect.Height() <= 0)
+    {
+        return;
+    }
+    const int stride = texture->Width();
+
+    // 源矩形裁剪到纹理内
+    math::BoundingBox2i source(0, 0, texture->Width(), texture->Height());
+    if (_source_rect.IsValid())
+    {
+        source = math::BoundingBox2i(std::max(_source_rect.MinX(), 0), std::max(_source_rect.MinY(), 0),
+                                     std::min(_source_rect.MaxX(), texture->Width()),
+                                     std::min(_source_rect.MaxY(), texture->Height()));
+    }
+    if (source.Width() <= 0 || source.Height() <= 0)
+    {
+        return;
+    }
+
+    // 源和目标各自的 4 条分割线
+    const int left = std::clamp(_left, 0, source.Width());
+    const int right = std::clamp(_right, 0, source.Width() - left);
+    const int top = std::clamp(_top, 0, source.Height());
+    const int bottom = std::clamp(_bottom, 0, source.Height() - top);
+    int dst_left = 0;
+    int dst_right = 0;
+    int dst_top = 0;
+    int dst_bottom = 0;
+    SplitAxis(_rect.Width(), left, right, dst_left, dst_right);
+    SplitAxis(_rect.Height(), top, bottom, dst_top, dst_bottom);
+    const int src_x[4] = {source.MinX(), source.MinX() + left, source.MaxX() - right, source.MaxX()};
+    const int src_y[4] = {source.MinY(), source.MinY() + top, source.MaxY() - bottom, source.MaxY()};
+    const int dst_x[4] = {_rect.MinX(), _rect.MinX() + dst_left, _rect.MaxX() - dst_right, _rect.MaxX()};
+    const int dst_y[4] = {_rect.MinY(), _rect.MinY() + dst_top, _rect.MaxY() - dst_bottom, _rect.MaxY()};
+
+    // 行暂存覆盖目标矩形与裁剪矩形相交的列
+    const int scratch_width = std::min(_rect.MaxX(), buffer.ClipMaxX()) - std::max(_rect.MinX(), buffer.ClipMinX());
+    if (scratch_width <= 0)
+    {
+        return;
+    }
+    FrameArena::Scope scope(buffer.GetFrameArena());
+    std::vector<uint32_t> fallback;
+    uint32_t* scratch = ScratchArray(buffer.GetFrameArena(), static_cast<size_t>(scratch_width), fallback);
+
+    for (int row = 0; row < 3; ++row)
+    {
+        const int src_height = src_y[row + 1] - src_y[row];
+        const int dst_height = dst_y[row + 1] - dst_y[row];
+        if (src_height <= 0 || dst_height <= 0)
+        {
+            continue;
+        }
+        for (int col = 0; col < 3; ++col)
+        {
+            const int src_width = src_x[col + 1] - src_x[col];
+            const int dst_width = dst_x[col + 1] - dst_x[col];
+            if (src_width <= 0 || dst_width <= 0)
+            {
+                continue;
+            }
+            const ImageBlitter::Source cell{pixels + static_cast<size_t>(src_y[row]) * stride + src_x[col], src_width,
+                                            src_height, stride, true};
+            // 源格 -> 目标格：尺寸相同时是整数平移，直接混合纹理的行
+            const math::Affine2f transform =
+                math::Affine2f::Translation(static_cast<float>(dst_x[col]), static_cast<float>(dst_y[row])) *
+                math::Affine2f::Scale(static_cast<float>(dst_width) / static_cast<float>(src_width),
+                                      static_cast<float>(dst_height) / static_cast<float>(src_height));
+            ImageBlitter::Blit(buffer, cell, transform, _filter,
+                               math::BoundingBox2i(dst_x[col], dst_y[row], dst_x[col + 1], dst_y[row + 1]), scratch);
+        }
+    }
+}
+
+std::unique_ptr<IPrimitive> NineSlicePrimitive::Clone() const
+{
+    return std::make_unique<NineSlicePrimitive>(*this);
+}
+
+math::BoundingBox2i NineSlicePrimitive::Bounds() const
+{
+    return _rect;
+}
+
+} // namespace pri
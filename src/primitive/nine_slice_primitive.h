@@ -0,0 +1,96 @@
+//
+// Created by admin on 2026/2/23.
+//
+
+#ifndef NINE_SLICE_PRIMITIVE_H
+#define NINE_SLICE_PRIMITIVE_H
+
+#include "../image_blitter.h"
+#include "../math/bounding_box.h"
+#include "primitive.h"
+
+namespace pri
+{
+
+/**
+ * @brief 九宫格图元：四个角保持原尺寸，四条边沿一个方向拉伸，中心沿两个方向拉伸
+ *
+ * 源矩形（默认整张纹理）按 left / top / right / bottom 边距切成 3 x 3 格，分别映射到目标矩形的对应格。
+ * 每格是一次轴对齐的行 blit（见 ImageBlitter）：角按整数平移直接混合纹理的行，边和中心按定点增量采样，
+ * 不经过纹理的 UV 换算。目标矩形比两侧边距之和还小时，边距按比例缩小。
+ * 纹理像素须为预乘 alpha（由 Image 创建的纹理在构造时已转换）。
+ */
+class NineSlicePrimitive : public IPrimitive
+{
+  public:
+    NineSlicePrimitive() = default;
+
+    /**
+     * @param texture 纹理
+     * @param rect 目标矩形（半开区间）
+     * @param left 左边距（源像素）
+     * @param top 上边距
+     * @param right 右边距
+     * @param bottom 下边距
+     */
+    NineSlicePrimitive(std::shared_ptr<texture::Texture> texture, const math::BoundingBox2i& rect, int left, int top,
+                       int right, int bottom)
+        : _rect(rect), _left(left), _top(top), _right(right), _bottom(bottom)
+    {
+        _texture = std::move(texture);
+    }
+
+    void Draw(PixelsBuffer& buffer) const override;
+    std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
+
+    // 获取/设置属性
+    const math::BoundingBox2i& GetRect() const
+    {
+        return _rect;
+    }
+    void SetRect(const math::BoundingBox2i& rect)
+    {
+        _rect = rect;
+    }
+    /**
+     * @brief 源矩形（纹理坐标，半开区间），无效矩形表示整张纹理；用于从图集中取一块
+     */
+    const math::BoundingBox2i& GetSourceRect() const
+    {
+        return _source_rect;
+    }
+    void SetSourceRect(const math::BoundingBox2i& rect)
+    {
+        _source_rect = rect;
+    }
+    void SetInsets(int left, int top, int right, int bottom)
+    {
+        _left = left;
+        _top = top;
+        _right = right;
+        _bottom = bottom;
+    }
+    ImageFilter GetFilter() const
+    {
+        return _filter;
+    }
+    // 边和中心拉伸时的采样方式（默认最近邻）
+    void SetFilter(ImageFilter filter)
+    {
+        _filter = filter;
+    }
+
+  private:
+    math::BoundingBox2i _rect{};
+    math::BoundingBox2i _source_rect{};
+    int _left = 0;
+    int _top = 0;
+    int _right = 0;
+    int _bottom = 0;
+    ImageFilter _filter = ImageFilter::Nearest;
+};
+
+} // namespace pri
+
+#endif // NINE_SLICE_PRIMITIVE_H
@@ -0,0 +1,360 @@
+//
+// Created by admin on 2026/2/9.
+//
+
+#include "path_primitive.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+namespace pri
+{
+
+namespace
+{
+
+// 单条曲线的最大细分段数（防止退化的巨大控制点导致无限细分）
+constexpr int kMaxCurveSegments = 1024;
+
+// 重建细分缓存时持有（只在路径或变换改变后的第一次绘制时使用，不影响已缓存路径的并行绘制）
+std::mutex g_flatten_mutex;
+
+float Length(float x, float y)
+{
+    return std::sqrt(x * x + y * y);
+}
+
+// 以统一的环绕方向添加凸多边形，使描边的各部分在非零规则下求并集而不是相互抵消
+void AddConvex(CoverageRasterizer& rasterizer, const math::Point2f* points, int count)
+{
+    float area = 0.0f;
+    for (int i = 0; i < count; ++i)
+    {
+        const math::Point2f& a = points[i];
+        const math::Point2f& b = points[(i + 1) % count];
+        area += a.X() * b.Y() - b.X() * a.Y();
+    }
+    if (area == 0.0f)
+    {
+        return;
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        const math::Point2f& a = points[area > 0.0f ? i : count - 1 - i];
+        const math::Point2f& b = points[area > 0.0f ? (i + 1) % count : (2 * count - 2 - i) % count];
+        rasterizer.AddEdge(a.X(), a.Y(), b.X(), b.Y());
+    }
+}
+
+} // namespace
+
+PathPrimitive& PathPrimitive::MoveTo(float x, float y)
+{
+    _verbs.push_back(PathVerb::MoveTo);
+    _subpath_start = _points.size();
+    _points.emplace_back(x, y);
+    _subpath_open = true;
+    _flatten_dirty = true;
+    return *this;
+}
+
+PathPrimitive& PathPrimitive::LineTo(float x, float y)
+{
+    EnsureMoveTo();
+    _verbs.push_back(PathVerb::LineTo);
+    _points.emplace_back(x, y);
+    _flatten_dirty = true;
+    return *this;
+}
+
+PathPrimitive& PathPrimitive::QuadTo(float cx, float cy, float x, float y)
+{
+    EnsureMoveTo();
+    _verbs.push_back(PathVerb::QuadTo);
+    _points.emplace_back(cx, cy);
+    _points.emplace_back(x, y);
+    _flatten_dirty = true;
+    return *this;
+}
+
+PathPrimitive& PathPrimitive::CubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y)
+{
+    EnsureMoveTo();
+    _verbs.push_back(PathVerb::CubicTo);
+    _points.emplace_back(c1x, c1y);
+    _points.emplace_back(c2x, c2y);
+    _points.emplace_back(x, y);
+    _flatten_dirty = true;
+    return *this;
+}
+
+PathPrimitive& PathPrimitive::Close()
+{
+    if (_subpath_open)
+    {
+        _verbs.push_back(PathVerb::Close);
+        _subpath_open = false;
+        _flatten_dirty = true;
+    }
+    return *this;
+}
+
+void PathPrimitive::Reset()
+{
+    _verbs.clear();
+    _points.clear();
+    _subpath_start = 0;
+    _subpath_open = false;
+    _flatten_dirty = true;
+}
+
+math::Point2f PathPrimitive::CurrentPoint() const
+{
+    if (_points.empty())
+    {
+        return math::Point2f(0.0f, 0.0f);
+    }
+    return _subpath_open ? _points.back() : _points[_subpath_start];
+}
+
+void PathPrimitive::EnsureMoveTo()
+{
+    if (!_subpath_open)
+    {
+        const math::Point2f current = CurrentPoint();
+        MoveTo(current.X(), current.Y());
+    }
+}
+
+void PathPrimitive::Flatten() const
+{
+    // 多个线程同时绘制同一路径时，由第一个线程在锁内重建缓存，其它线程等它完成后直接读取
+    if (!std::atomic_ref<bool>(_flatten_dirty).load(std::memory_order_acquire))
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_flatten_mutex);
+    if (!std::atomic_ref<bool>(_flatten_dirty).load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    _flat_points.clear();
+    _contours.clear();
+    _contour_first = 0;
+
+    size_t index = 0;
+    for (PathVerb verb : _verbs)
+    {
+        switch (verb)
+        {
+        case PathVerb::MoveTo:
+            EndContour(false);
+            _flat_points.push_back(_transform.Apply(_points[index++]));
+            break;
+        case PathVerb::LineTo:
+            _flat_points.push_back(_transform.Apply(_points[index++]));
+            break;
+        case PathVerb::QuadTo:
+        {
+            // 起点先拷贝出来：细分过程中 _flat_points 可能重新分配
+            const math::Point2f start = _flat_points.back();
+            FlattenQuad(start, _transform.Apply(_points[index]), _transform.Apply(_points[index + 1]));
+            index += 2;
+            break;
+        }
+        case PathVerb::CubicTo:
+        {
+            const math::Point2f start = _flat_points.back();
+            FlattenCubic(start, _transform.Apply(_points[index]), _transform.Apply(_points[index + 1]),
+                         _transform.Apply(_points[index + 2]));
+            index += 3;
+            break;
+        }
+        case PathVerb::Close:
+            EndContour(true);
+            break;
+        }
+    }
+    EndContour(false);
+    std::atomic_ref<bool>(_flatten_dirty).store(false, std::memory_order_release);
+}
+
+void PathPrimitive::FlattenQuad(const math::Point2f& p0, const math::Point2f& p1, const math::Point2f& p2) const
+{
+    // 均匀细分为 n 段时弦与曲线的最大距离为 |p0 - 2p1 + p2| / (4n²)
+    const float dd = Length(p0.X() - 2.0f * p1.X() + p2.X(), p0.Y() - 2.0f * p1.Y() + p2.Y());
+    const int n = std::clamp(static_cast<int>(std::ceil(std::sqrt(dd / (4.0f * _tolerance)))), 1, kMaxCurveSegments);
+    const float step = 1.0f / static_cast<float>(n);
+    for (int i = 1; i < n; ++i)
+    {
+        const float t = static_cast<float>(i) * step;
+        const float mt = 1.0f - t;
+        const float w0 = mt * mt;
+        const float w1 = 2.0f * mt * t;
+        const float w2 = t * t;
+        _flat_points.emplace_back(w0 * p0.X() + w1 * p1.X() + w2 * p2.X(), w0 * p0.Y() + w1 * p1.Y() + w2 * p2.Y());
+    }
+    _flat_points.push_back(p2);
+}
+
+void PathPrimitive::FlattenCubic(const math::Point2f& p0, const math::Point2f& p1, const math::Point2f& p2,
+                                 const math::Point2f& p3) const
+{
+    // 二阶导数的上界为 6 * max(|p0 - 2p1 + p2|, |p1 - 2p2 + p3|)，弦误差不超过其 1/(8n²)
+    const float dd = std::max(Length(p0.X() - 2.0f * p1.X() + p2.X(), p0.Y() - 2.0f * p1.Y() + p2.Y()),
+                              Length(p1.X() - 2.0f * p2.X() + p3.X(), p1.Y() - 2.0f * p2.Y() + p3.Y()));
+    const int n = std::clamp(static_cast<int>(std::ceil(std::sqrt(0.75f * dd / _tolerance))), 1, kMaxCurveSegments);
+    const float step = 1.0f / static_cast<float>(n);
+    for (int i = 1; i < n; ++i)
+    {
+        const float t = static_cast<float>(i) * step;
+        const float mt = 1.0f - t;
+        const float w0 = mt * mt * mt;
+        const float w1 = 3.0f * mt * mt * t;
+        const float w2 = 3.0f * mt * t * t;
+        const float w3 = t * t * t;
+        _flat_points.emplace_back(w0 * p0.X() + w1 * p1.X() + w2 * p2.X() + w3 * p3.X(),
+                                  w0 * p0.Y() + w1 * p1.Y() + w2 * p2.Y() + w3 * p3.Y());
+    }
+    _flat_points.push_back(p3);
+}
+
+void PathPrimitive::EndContour(bool closed) const
+{
+    size_t count = _flat_points.size() - _contour_first;
+    if (closed && count > 1 && _flat_points.back() == _flat_points[_contour_first])
+    {
+        // 闭合时终点与起点重合，去掉重复点
+        _flat_points.pop_back();
+        --count;
+    }
+    if (count >= 2)
+    {
+        _contours.push_back({_contour_first, count, closed});
+    }
+    else
+    {
+        _flat_points.resize(_contour_first);
+    }
+    _contour_first = _flat_points.size();
+}
+
+void PathPrimitive::Draw(PixelsBuffer& buffer) const
+{
+    Flatten();
+    if (_contours.empty())
+    {
+        return;
+    }
+
+    CoverageRasterizer& rasterizer = CoverageRasterizer::ForCurrentThread();
+    if (_filled)
+    {
+        // 填充时所有子路径都视为闭合
+        rasterizer.Reset();
+        for (const auto& contour : _contours)
+        {
+            rasterizer.AddContour(&_flat_points[contour.first], contour.count);
+        }
+        rasterizer.Fill(buffer, _fill_color, _fill_rule);
+    }
+
+    if (_stroke_width > 0.0f)
+    {
+        Stroke(buffer, rasterizer);
+    }
+}
+
+void PathPrimitive::Stroke(PixelsBuffer& buffer, CoverageRasterizer& rasterizer) const
+{
+    const float half_width = 0.5f * _stroke_width * std::sqrt(std::abs(_transform.Determinant()));
+    if (half_width <= 0.0f)
+    {
+        return;
+    }
+
+    rasterizer.Reset();
+    for (const auto& contour : _contours)
+    {
+        const math::Point2f* points = &_flat_points[contour.first];
+        const size_t segments = contour.closed ? contour.count : contour.count - 1;
+
+        // 每段生成一个矩形，相邻两段之间在两侧各补一个三角形形成斜角连接
+        bool has_previous = false;
+        float first_nx = 0.0f, first_ny = 0.0f;
+        float prev_nx = 0.0f, prev_ny = 0.0f;
+        for (size_t i = 0; i < segments; ++i)
+        {
+            const math::Point2f& a = points[i];
+            const math::Point2f& b = points[(i + 1) % contour.count];
+            const float dx = b.X() - a.X();
+            const float dy = b.Y() - a.Y();
+            const float len = Length(dx, dy);
+            if (len == 0.0f)
+            {
+                continue;
+            }
+            const float nx = -dy / len * half_width;
+            const float ny = dx / len * half_width;
+
+            const math::Point2f quad[4] = {{a.X() + nx, a.Y() + ny},
+                                           {b.X() + nx, b.Y() + ny},
+                                           {b.X() - nx, b.Y() - ny},
+                                           {a.X() - nx, a.Y() - ny}};
+            AddConvex(rasterizer, quad, 4);
+
+            if (has_previous)
+            {
+                const math::Point2f outer[3] = {a, {a.X() + prev_nx, a.Y() + prev_ny}, {a.X() + nx, a.Y() + ny}};
+                const math::Point2f inner[3] = {a, {a.X() - prev_nx, a.Y() - prev_ny}, {a.X() - nx, a.Y() - ny}};
+                AddConvex(rasterizer, outer, 3);
+                AddConvex(rasterizer, inner, 3);
+            }
+            else
+            {
+                first_nx = nx;
+                first_ny = ny;
+                has_previous = true;
+            }
+            prev_nx = nx;
+            prev_ny = ny;
+        }
+
+        if (contour.closed && has_previous)
+        {
+            const math::Point2f& a = points[0];
+            const math::Point2f outer[3] = {
+                a, {a.X() + prev_nx, a.Y() + prev_ny}, {a.X() + first_nx, a.Y() + first_ny}};
+            const math::Point2f inner[3] = {
+                a, {a.X() - prev_nx, a.Y() - prev_ny}, {a.X() - first_nx, a.Y() - first_ny}};
+            AddConvex(rasterizer, outer, 3);
+            AddConvex(rasterizer, inner, 3);
+        }
+    }
+    rasterizer.Fill(buffer, _stroke_color, FillRule::NonZero);
+}
+
+std::unique_ptr<IPrimitive> PathPrimitive::Clone() const
+{
+    return std::make_unique<PathPrimitive>(*this);
+}
+
+math::BoundingBox2i PathPrimitive::Bounds() const
+{
+    if (_points.empty())
+    {
+        return {};
+    }
+    // 贝塞尔曲线位于控制点的凸包内，变换后的控制点包围盒即可覆盖细分结果；描边的斜角连接不超出半宽
+    math::BoundingBox2f box;
+    for (const auto& point : _points)
+    {
+        box.AddPoint(_transform.Apply(point));
+    }
+    const float half_width =
+        _stroke_width > 0.0f ? 0.5f * _stroke_width * std::sqrt(std::abs(_transform.Determinant())) : 0.0f;
+    return PixelBounds(box.MinX(), box.MinY(), box.MaxX(), box.MaxY(), half_width + 1.0f);
+}
+
+} // namespace pri
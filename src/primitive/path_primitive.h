@@ -0,0 +1,200 @@
+//
+// Created by admin on 2026/2/9.
+//
+
+#ifndef PATH_PRIMITIVE_H
+#define PATH_PRIMITIVE_H
+
+#include "../math/affine.h"
+#include "../math/point.h"
+#include "coverage_rasterizer.h"
+#include "primitive.h"
+#include <cstdint>
+#include <vector>
+
+namespace pri
+{
+
+/**
+ * @brief 路径命令
+ */
+enum class PathVerb : uint8_t
+{
+    MoveTo,  // 开始新的子路径，使用 1 个点
+    LineTo,  // 直线，使用 1 个点
+    QuadTo,  // 二次贝塞尔曲线，使用 2 个点（控制点、终点）
+    CubicTo, // 三次贝塞尔曲线，使用 3 个点（两个控制点、终点）
+    Close    // 闭合当前子路径，不使用点
+};
+
+/**
+ * @brief 矢量路径图元（直线 + 二次 / 三次贝塞尔曲线，填充和 / 或描边）
+ *
+ * 绘制流程：
+ *   1. 把控制点变换到屏幕空间后再细分曲线（仿射变换下贝塞尔曲线仍是贝塞尔曲线），
+ *      因此容差直接以屏幕像素为单位，缩放后细分程度自动随之变化
+ *   2. 细分段数由曲线二阶差分的上界一次算出（自适应，无需递归）
+ *   3. 细分结果被缓存，只有路径或变换改变时才重新计算（重建时加锁，同一路径可以在多个线程中同时绘制）
+ *   4. 填充和描边都交给 CoverageRasterizer，直接以抗锯齿 span 写入 PixelsBuffer
+ *
+ * 描边使用斜角（bevel）连接和平头（butt）端点，宽度按变换的面积缩放换算到屏幕空间。
+ */
+class PathPrimitive : public IPrimitive
+{
+  public:
+    PathPrimitive() = default;
+
+    explicit PathPrimitive(const Color& fill_color) : _fill_color(fill_color) {}
+
+    // 路径构建（返回自身以便链式调用）
+    PathPrimitive& MoveTo(float x, float y);
+    PathPrimitive& LineTo(float x, float y);
+    PathPrimitive& QuadTo(float cx, float cy, float x, float y);
+    PathPrimitive& CubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y);
+    PathPrimitive& Close();
+
+    /**
+     * @brief 清空路径
+     */
+    void Reset();
+
+    bool Empty() const
+    {
+        return _verbs.empty();
+    }
+
+    void Draw(PixelsBuffer& buffer) const override;
+    std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
+
+    /**
+     * @brief 设置局部坐标到屏幕坐标的变换（改变时才使细分缓存失效）
+     */
+    void SetTransform(const math::Affine2f& transform)
+    {
+        if (transform != _transform)
+        {
+            _transform = transform;
+            _flatten_dirty = true;
+        }
+    }
+    const math::Affine2f& GetTransform() const
+    {
+        return _transform;
+    }
+
+    /**
+     * @brief 设置曲线细分容差（屏幕像素，默认 0.2）
+     */
+    void SetTolerance(float pixels)
+    {
+        if (pixels > 0.0f && pixels != _tolerance)
+        {
+            _tolerance = pixels;
+            _flatten_dirty = true;
+        }
+    }
+    float GetTolerance() const
+    {
+        return _tolerance;
+    }
+
+    // 填充属性
+    void SetFilled(bool filled)
+    {
+        _filled = filled;
+    }
+    bool IsFilled() const
+    {
+        return _filled;
+    }
+    void SetFillColor(const Color& color)
+    {
+        _fill_color = color;
+    }
+    Color GetFillColor() const
+    {
+        return _fill_color;
+    }
+    void SetFillRule(FillRule rule)
+    {
+        _fill_rule = rule;
+    }
+    FillRule GetFillRule() const
+    {
+        return _fill_rule;
+    }
+
+    // 描边属性（宽度为 0 时不描边）
+    void SetStroke(const Color& color, float width)
+    {
+        _stroke_color = color;
+        _stroke_width = width;
+    }
+    Color GetStrokeColor() const
+    {
+        return _stroke_color;
+    }
+    float GetStrokeWidth() const
+    {
+        return _stroke_width;
+    }
+
+    /**
+     * @brief 细分后屏幕空间的顶点数（主要用于调试和统计）
+     */
+    size_t FlattenedPointCount() const
+    {
+        Flatten();
+        return _flat_points.size();
+    }
+
+  private:
+    // 一个细分后的子路径：_flat_points 中 [first, first + count)
+    struct Contour
+    {
+        size_t first;
+        size_t count;
+        bool closed;
+    };
+
+    // 当前点（路径为空或刚闭合时为子路径起点）
+    math::Point2f CurrentPoint() const;
+
+    // 确保 LineTo / QuadTo / CubicTo 之前存在 MoveTo
+    void EnsureMoveTo();
+
+    // 在需要时重新细分路径
+    void Flatten() const;
+
+    void FlattenQuad(const math::Point2f& p0, const math::Point2f& p1, const math::Point2f& p2) const;
+    void FlattenCubic(const math::Point2f& p0, const math::Point2f& p1, const math::Point2f& p2,
+                      const math::Point2f& p3) const;
+    void EndContour(bool closed) const;
+
+    void Stroke(PixelsBuffer& buffer, CoverageRasterizer& rasterizer) const;
+
+    std::vector<PathVerb> _verbs;
+    std::vector<math::Point2f> _points; // 局部坐标
+    size_t _subpath_start = 0;          // 当前子路径起点在 _points 中的索引
+    bool _subpath_open = false;
+
+    math::Affine2f _transform;
+    float _tolerance = 0.2f;
+
+    bool _filled = true;
+    Color _fill_color = Color::Green();
+    FillRule _fill_rule = FillRule::NonZero;
+    Color _stroke_color = Color::White();
+    float _stroke_width = 0.0f;
+
+    // 细分缓存（屏幕坐标），由 Flatten 在锁内重建
+    mutable bool _flatten_dirty = true;
+    mutable std::vector<math::Point2f> _flat_points;
+    mutable std::vector<Contour> _contours;
+    mutable size_t _contour_first = 0;
+};
+
+} // namespace pri
+
+#endif // PATH_PRIMITIVE_H
@@ -0,0 +1,350 @@
+//
+// Created by admin on 2026/2/12.
+//
+
+#include "point_cloud_primitive.h"
+#include "../frame_arena.h"
+#include "../parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+namespace pri
+{
+
+namespace
+{
+
+// 点数少于该值时不值得启动线程
+constexpr size_t kParallelThreshold = 1 << 16;
+
+// 像素坐标的范围限制（避免屏幕外的巨大坐标在取整时溢出）
+constexpr double kCoordLimit = 1 << 28;
+constexpr double kRoundBias = 1 << 30;
+
+// 四舍五入到最近的像素：加偏置后坐标恒为正，截断即为向下取整（避免 floor 在没有 SSE4.1 时的函数调用）
+inline int32_t RoundCoord(float v)
+{
+    const double biased = std::clamp(static_cast<double>(v), -kCoordLimit, kCoordLimit) + (kRoundBias + 0.5);
+    return static_cast<int32_t>(static_cast<int64_t>(biased) - static_cast<int64_t>(kRoundBias));
+}
+
+} // namespace
+
+void PointCloudPrimitive::SetSplatSize(int size)
+{
+    _splat_size = std::clamp(size, 1, kMaxSplatSize);
+}
+
+std::unique_ptr<IPrimitive> PointCloudPrimitive::Clone() const
+{
+    return std::make_unique<PointCloudPrimitive>(*this);
+}
+
+math::BoundingBox2i PointCloudPrimitive::Bounds() const
+{
+    if (_positions.empty())
+    {
+        return {};
+    }
+    const math::BoundingBox2f box = math::BoundingBox2f::FromPoints(_positions);
+    return PixelBounds(box.MinX(), box.MinY(), box.MaxX(), box.MaxY(), static_cast<float>(_splat_size));
+}
+
+PointCloudPrimitive::BinnedPoint PointCloudPrimitive::PointAt(size_t i) const
+{
+    const uint32_t color =
+        _colors.empty() ? Blender::Premultiply(_color.ToUint32()) : Blender::Premultiply(_colors[i].ToUint32());
+    const float depth = UseDepth() ? _depths[i] : 0.0f;
+    return {RoundCoord(_positions[i].X()), RoundCoord(_positions[i].Y()), color, depth};
+}
+
+int PointCloudPrimitive::BuildSplat(SplatRow* rows) const
+{
+    int count = 0;
+    const int size = _splat_size;
+    // 覆盖相对偏移 [lo, lo + size - 1]，奇数尺寸以点所在像素为中心
+    const int lo = -(size - 1) / 2;
+    if (_splat_shape == SplatShape::Square || size <= 2)
+    {
+        for (int dy = lo; dy < lo + size; ++dy)
+        {
+            rows[count++] = {dy, lo, size};
+        }
+        return count;
+    }
+    // 圆形：保留中心到 splat 中心距离不超过半径的像素
+    const float center = static_cast<float>(lo) + 0.5f * static_cast<float>(size - 1);
+    const float radius = 0.5f * static_cast<float>(size);
+    for (int dy = lo; dy < lo + size; ++dy)
+    {
+        const float oy = static_cast<float>(dy) - center;
+        const float half = std::sqrt(std::max(radius * radius - oy * oy, 0.0f));
+        const int x0 = std::max(static_cast<int>(std::ceil(center - half)), lo);
+        const int x1 = std::min(static_cast<int>(std::floor(center + half)), lo + size - 1);
+        if (x0 <= x1)
+        {
+            rows[count++] = {dy, x0, x1 - x0 + 1};
+        }
+    }
+    return count;
+}
+
+template <typename GetPoint>
+void PointCloudPrimitive::Splat(PixelsBuffer& buffer, uint32_t* pixels, const SplatRow* splat_rows,
+                                int splat_row_count, size_t count, const GetPoint& get, int clip_x0, int clip_y0,
+                                int clip_x1, int clip_y1, float* depth, uint32_t* resolved) const
+{
+    const int width = buffer.Width();
+    const BlendMode mode = buffer.GetBlendMode();
+    const bool single = _splat_size == 1;
+    const StencilBuffer* stencil = buffer.StencilTest();
+
+    if (depth == nullptr)
+    {
+        // 直接按点的顺序混合到帧缓冲
+        for (size_t i = 0; i < count; ++i)
+        {
+            const BinnedPoint p = get(i);
+            if (single)
+            {
+                if (p.x >= clip_x0 && p.x < clip_x1 && p.y >= clip_y0 && p.y < clip_y1 &&
+                    (stencil == nullptr || stencil->Test(p.x, p.y)))
+                {
+                    uint32_t& dst = pixels[static_cast<size_t>(p.y) * width + p.x];
+                    dst = Blender::BlendPixel(dst, p.color, mode);
+                }
+                continue;
+            }
+            for (int r = 0; r < splat_row_count; ++r)
+            {
+                const SplatRow& row = splat_rows[r];
+                const int y = p.y + row.dy;
+                const int x_begin = std::max(p.x + row.dx, clip_x0);
+                const int x_end = std::min(p.x + row.dx + row.length, clip_x1);
+                if (y >= clip_y0 && y < clip_y1)
+                {
+                    uint32_t* dst = pixels + static_cast<size_t>(y) * width;
+                    buffer.ForEachWritableRun(y, x_begin, x_end, [&](int begin, int end) {
+                        Blender::BlendSolidSpan(dst + begin, p.color, end - begin, mode);
+                    });
+                }
+            }
+        }
+        return;
+    }
+
+    // 深度测试：先在局部缓冲中为每个像素找出最近的点，再整体混合到帧缓冲
+    const int local_width = clip_x1 - clip_x0;
+    const size_t local_size = static_cast<size_t>(local_width) * (clip_y1 - clip_y0);
+    std::fill(depth, depth + local_size, std::numeric_limits<float>::infinity());
+    auto test = [&](int x, int y, const BinnedPoint& p)
+    {
+        const size_t index = static_cast<size_t>(y - clip_y0) * local_width + (x - clip_x0);
+        if (p.depth < depth[index])
+        {
+            depth[index] = p.depth;
+            resolved[index] = p.color;
+        }
+    };
+    for (size_t i = 0; i < count; ++i)
+    {
+        const BinnedPoint p = get(i);
+        if (single)
+        {
+            if (p.x >= clip_x0 && p.x < clip_x1 && p.y >= clip_y0 && p.y < clip_y1)
+            {
+                test(p.x, p.y, p);
+            }
+            continue;
+        }
+        for (int r = 0; r < splat_row_count; ++r)
+        {
+            const SplatRow& row = splat_rows[r];
+            const int y = p.y + row.dy;
+            if (y < clip_y0 || y >= clip_y1)
+            {
+                continue;
+            }
+            const int x_end = std::min(p.x + row.dx + row.length, clip_x1);
+            for (int x = std::max(p.x + row.dx, clip_x0); x < x_end; ++x)
+            {
+                test(x, y, p);
+            }
+        }
+    }
+    for (int y = clip_y0; y < clip_y1; ++y)
+    {
+        const float* depth_row = depth + static_cast<size_t>(y - clip_y0) * local_width;
+        const uint32_t* color_row = resolved + static_cast<size_t>(y - clip_y0) * local_width;
+        uint32_t* dst = pixels + static_cast<size_t>(y) * width + clip_x0;
+        for (int x = 0; x < local_width; ++x)
+        {
+            if (depth_row[x] != std::numeric_limits<float>::infinity() &&
+                (stencil == nullptr || stencil->Test(clip_x0 + x, y)))
+            {
+                dst[x] = Blender::BlendPixel(dst[x], color_row[x], mode);
+            }
+        }
+    }
+}
+
+void PointCloudPrimitive::Draw(PixelsBuffer& buffer) const
+{
+    const int width = buffer.Width();
+    const int height = buffer.Height();
+    const math::BoundingBox2i clip = buffer.ClipRect();
+    if (_positions.empty() || clip.Width() <= 0 || clip.Height() <= 0)
+    {
+        return;
+    }
+    if (!_colors.empty() && _colors.size() != _positions.size())
+    {
+        return;
+    }
+    // 临时数据属于这一次调用：RunParallel 等待时调用线程可能执行其它作业（包括另一次点云绘制），不能与它们共享
+    FrameArena* arena = buffer.GetFrameArena();
+    FrameArena::Scope scope(arena);
+    Scratch scratch;
+    scratch.splat_row_count = BuildSplat(scratch.splat_rows);
+    // 快速清除的瓦片在分发到各线程之前实体化，各线程只通过这个指针写像素
+    const math::BoundingBox2i bounds = Bounds();
+    uint32_t* pixels = buffer.PixelsForRegion(bounds.MinX(), bounds.MinY(), bounds.MaxX(), bounds.MaxY());
+
+    const bool use_depth = UseDepth();
+    const int threads = parallel::ResolveThreadCount(_thread_count, _positions.size(), kParallelThreshold);
+    if (threads == 1)
+    {
+        // 单线程时分箱没有收益：直接在缓冲区的裁剪矩形内绘制
+        float* depth = nullptr;
+        uint32_t* resolved = nullptr;
+        if (use_depth)
+        {
+            const size_t area = static_cast<size_t>(clip.Width()) * clip.Height();
+            depth = ScratchArray(arena, area, scratch.depth_fallback);
+            resolved = ScratchArray(arena, area, scratch.colors_fallback);
+        }
+        Splat(buffer, pixels, scratch.splat_rows, scratch.splat_row_count, _positions.size(),
+              [this](size_t i) { return PointAt(i); }, clip.MinX(), clip.MinY(), clip.MaxX(), clip.MaxY(), depth,
+              resolved);
+        return;
+    }
+
+    Bin(scratch, arena, width, height, threads);
+
+    const int tile_count = scratch.tiles_x * scratch.tiles_y;
+    const int workers = std::min(threads, tile_count);
+    constexpr size_t kTileArea = static_cast<size_t>(kTileSize) * kTileSize;
+    if (use_depth)
+    {
+        scratch.depth = ScratchArray(arena, kTileArea * workers, scratch.depth_fallback);
+        scratch.colors = ScratchArray(arena, kTileArea * workers, scratch.colors_fallback);
+    }
+
+    // 瓦片按原子计数器动态分配给各线程；每个线程只写自己瓦片内的像素
+    std::atomic<int> next_tile{0};
+    auto draw_tiles = [&](int worker)
+    {
+        float* depth = use_depth ? scratch.depth + kTileArea * worker : nullptr;
+        uint32_t* resolved = use_depth ? scratch.colors + kTileArea * worker : nullptr;
+        for (int tile = next_tile.fetch_add(1); tile < tile_count; tile = next_tile.fetch_add(1))
+        {
+            const uint32_t begin = scratch.tile_offsets[tile];
+            const uint32_t end = scratch.tile_offsets[tile + 1];
+            if (begin == end)
+            {
+                continue;
+            }
+            // 瓦片与裁剪矩形求交，完全在裁剪矩形之外的瓦片直接跳过
+            const int x0 = (tile % scratch.tiles_x) * kTileSize;
+            const int y0 = (tile / scratch.tiles_x) * kTileSize;
+            const int clip_x0 = std::max(x0, clip.MinX());
+            const int clip_y0 = std::max(y0, clip.MinY());
+            const int clip_x1 = std::min(x0 + kTileSize, clip.MaxX());
+            const int clip_y1 = std::min(y0 + kTileSize, clip.MaxY());
+            if (clip_x0 >= clip_x1 || clip_y0 >= clip_y1)
+            {
+                continue;
+            }
+            const BinnedPoint* points = scratch.tile_points + begin;
+            Splat(buffer, pixels, scratch.splat_rows, scratch.splat_row_count, end - begin,
+                  [points](size_t i) { return points[i]; }, clip_x0, clip_y0, clip_x1, clip_y1, depth, resolved);
+        }
+    };
+    parallel::RunParallel(workers, draw_tiles);
+}
+
+void PointCloudPrimitive::Bin(Scratch& scratch, FrameArena* arena, int width, int height, int threads) const
+{
+    scratch.tiles_x = (width + kTileSize - 1) / kTileSize;
+    scratch.tiles_y = (height + kTileSize - 1) / kTileSize;
+    const int tile_count = scratch.tiles_x * scratch.tiles_y;
+
+    // 按 splat 包围盒分箱：kMaxSplatSize 不超过瓦片边长，每个点最多落入 2 x 2 个瓦片
+    const int lo = -(_splat_size - 1) / 2;
+    const int hi = lo + _splat_size - 1;
+    auto for_each_tile = [&](size_t begin, size_t end, auto&& visit)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const int32_t x = RoundCoord(_positions[i].X());
+            const int32_t y = RoundCoord(_positions[i].Y());
+            if (x + hi < 0 || x + lo >= width || y + hi < 0 || y + lo >= height)
+            {
+                continue;
+            }
+            const int col0 = std::max(x + lo, 0) >> kTileShift;
+            const int col1 = std::min(x + hi, width - 1) >> kTileShift;
+            const int row0 = std::max(y + lo, 0) >> kTileShift;
+            const int row1 = std::min(y + hi, height - 1) >> kTileShift;
+            for (int row = row0; row <= row1; ++row)
+            {
+                for (int col = col0; col <= col1; ++col)
+                {
+                    visit(row * scratch.tiles_x + col, i);
+                }
+            }
+        }
+    };
+
+    // 并行计数排序：与 LineBatch 相同，点按顺序切成 threads 段，瓦片内保持点的原始顺序
+    const size_t count = _positions.size();
+    const size_t cursor_count = static_cast<size_t>(threads) * tile_count;
+    scratch.cursors = ScratchArray(arena, cursor_count, scratch.cursors_fallback);
+    std::fill_n(scratch.cursors, cursor_count, 0u);
+    auto chunk_begin = [count, threads](int thread) { return count * thread / threads; };
+    auto count_chunk = [&](int thread)
+    {
+        uint32_t* counts = scratch.cursors + static_cast<size_t>(thread) * tile_count;
+        for_each_tile(chunk_begin(thread), chunk_begin(thread + 1), [counts](int tile, size_t) { ++counts[tile]; });
+    };
+    parallel::RunParallel(threads, count_chunk);
+
+    scratch.tile_offsets = ScratchArray(arena, static_cast<size_t>(tile_count) + 1, scratch.offsets_fallback);
+    uint32_t total = 0;
+    for (int tile = 0; tile < tile_count; ++tile)
+    {
+        scratch.tile_offsets[tile] = total;
+        for (int thread = 0; thread < threads; ++thread)
+        {
+            uint32_t& cursor = scratch.cursors[static_cast<size_t>(thread) * tile_count + tile];
+            const uint32_t tile_thread_count = cursor;
+            cursor = total;
+            total += tile_thread_count;
+        }
+    }
+    scratch.tile_offsets[tile_count] = total;
+    scratch.tile_points = ScratchArray(arena, static_cast<size_t>(total), scratch.points_fallback);
+
+    auto scatter_chunk = [&](int thread)
+    {
+        uint32_t* cursors = scratch.cursors + static_cast<size_t>(thread) * tile_count;
+        for_each_tile(chunk_begin(thread), chunk_begin(thread + 1),
+                      [this, &scratch, cursors](int tile, size_t index)
+                      { scratch.tile_points[cursors[tile]++] = PointAt(index); });
+    };
+    parallel::RunParallel(threads, scatter_chunk);
+}
+
+} // namespace pri
@@ -0,0 +1,231 @@
+//
+// Created by admin on 2026/2/12.
+//
+
+#ifndef POINT_CLOUD_PRIMITIVE_H
+#define POINT_CLOUD_PRIMITIVE_H
+
+#include "../math/point.h"
+#include "primitive.h"
+#include <cstdint>
+#include <vector>
+
+namespace pri
+{
+
+/**
+ * @brief 点云 splat 形状（splat 尺寸为 1 时两者都是单个像素）
+ */
+enum class SplatShape
+{
+    Square, // N x N 方块
+    Round   // 直径为 N 的圆
+};
+
+/**
+ * @brief 点云图元（面向百万级点）
+ *
+ * 位置、颜色、深度都保存在连续数组中，一次 Draw 画完整个点云，没有逐点的对象和虚函数调用：
+ *   - 颜色数组为空时所有点使用统一颜色
+ *   - 设置了深度数组并开启深度测试时，同一像素只保留深度最小（最近）的点，再与帧缓冲混合
+ *   - 混合方式沿用帧缓冲的混合模式（如 BlendMode::Additive 做加法累积）
+ *
+ * 点数较多时先按 splat 包围盒把点分箱到 kTileSize 见方的屏幕瓦片（并行计数排序，保持点的顺序），
+ * 再由多个线程各自处理整块瓦片：每个线程只写自己瓦片内的像素和瓦片局部的深度缓冲，
+ * 帧缓冲上没有任何原子操作或锁，结果与线程数无关。
+ */
+class PointCloudPrimitive : public IPrimitive
+{
+  public:
+    static constexpr int kTileShift = 6;
+    static constexpr int kTileSize = 1 << kTileShift;
+    // splat 的最大尺寸（像素）
+    static constexpr int kMaxSplatSize = kTileSize;
+
+    PointCloudPrimitive() = default;
+
+    /**
+     * @brief 所有点使用同一颜色
+     */
+    PointCloudPrimitive(std::vector<math::Point2f> positions, const Color& color)
+        : _positions(std::move(positions)), _color(color)
+    {
+    }
+
+    /**
+     * @brief 每个点单独指定颜色（colors 与 positions 一一对应）
+     */
+    PointCloudPrimitive(std::vector<math::Point2f> positions, std::vector<Color> colors)
+        : _positions(std::move(positions)), _colors(std::move(colors))
+    {
+    }
+
+    void Draw(PixelsBuffer& buffer) const override;
+    std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
+
+    // 点数据（整数坐标位于像素中心，浮点坐标四舍五入到最近的像素）
+    void SetPositions(std::vector<math::Point2f> positions)
+    {
+        _positions = std::move(positions);
+    }
+    const std::vector<math::Point2f>& Positions() const
+    {
+        return _positions;
+    }
+    size_t Size() const
+    {
+        return _positions.size();
+    }
+
+    /**
+     * @brief 设置逐点颜色，传入空数组时改用统一颜色
+     */
+    void SetColors(std::vector<Color> colors)
+    {
+        _colors = std::move(colors);
+    }
+    const std::vector<Color>& Colors() const
+    {
+        return _colors;
+    }
+
+    // 统一颜色（没有逐点颜色时使用）
+    Color GetColor() const
+    {
+        return _color;
+    }
+    void SetColor(const Color& color)
+    {
+        _color = color;
+    }
+
+    /**
+     * @brief 设置逐点深度（越小越近），与 positions 一一对应
+     */
+    void SetDepths(std::vector<float> depths)
+    {
+        _depths = std::move(depths);
+    }
+    const std::vector<float>& Depths() const
+    {
+        return _depths;
+    }
+
+    /**
+     * @brief 开启 / 关闭深度测试（需要同时设置深度数组）
+     */
+    void SetDepthTest(bool enabled)
+    {
+        _depth_test = enabled;
+    }
+    bool IsDepthTest() const
+    {
+        return _depth_test;
+    }
+
+    // splat 尺寸（像素，限制在 [1, kMaxSplatSize]）与形状
+    int GetSplatSize() const
+    {
+        return _splat_size;
+    }
+    void SetSplatSize(int size);
+    SplatShape GetSplatShape() const
+    {
+        return _splat_shape;
+    }
+    void SetSplatShape(SplatShape shape)
+    {
+        _splat_shape = shape;
+    }
+
+    /**
+     * @brief 设置线程数，0 表示使用硬件并发数（默认）
+     */
+    void SetThreadCount(int count)
+    {
+        _thread_count = count;
+    }
+    int GetThreadCount() const
+    {
+        return _thread_count;
+    }
+
+  private:
+    // 分箱后的点（紧凑 AoS，同一瓦片的点连续存放）
+    struct BinnedPoint
+    {
+        int32_t x;
+        int32_t y;
+        uint32_t color; // 预乘颜色
+        float depth;
+    };
+
+    // splat 的一行：相对点中心的行偏移、起始列偏移和长度
+    struct SplatRow
+    {
+        int dy;
+        int dx;
+        int length;
+    };
+
+    // 是否实际启用深度测试
+    bool UseDepth() const
+    {
+        return _depth_test && _depths.size() == _positions.size();
+    }
+
+    // 第 i 个点的打包数据
+    BinnedPoint PointAt(size_t i) const;
+
+    // 绘制时的临时数据：与 LineBatch::Bins 相同，每次 Draw 调用一份，缓冲在调用线程上从帧内分配器借用
+    // （没有分配器时使用后备 vector），工作线程只读写已分配好的内存
+    struct Scratch
+    {
+        SplatRow splat_rows[kMaxSplatSize];
+        int splat_row_count = 0;
+        int tiles_x = 0;
+        int tiles_y = 0;
+        uint32_t* tile_offsets = nullptr;
+        BinnedPoint* tile_points = nullptr;
+        uint32_t* cursors = nullptr; // 每个线程在每个瓦片中的计数 / 写入位置
+        float* depth = nullptr;      // 深度测试用的局部深度缓冲（每线程一块）
+        uint32_t* colors = nullptr;
+        std::vector<uint32_t> offsets_fallback;
+        std::vector<BinnedPoint> points_fallback;
+        std::vector<uint32_t> cursors_fallback;
+        std::vector<float> depth_fallback;
+        std::vector<uint32_t> colors_fallback;
+    };
+
+    // 按当前尺寸和形状生成 splat 的行表，返回行数
+    int BuildSplat(SplatRow* rows) const;
+
+    // 分箱（并行计数排序：tile_offsets 为每个瓦片在 tile_points 中的起始位置）
+    void Bin(Scratch& scratch, FrameArena* arena, int width, int height, int threads) const;
+
+    /**
+     * @brief 把 count 个点（get(i) 返回第 i 个 BinnedPoint）画到裁剪矩形 [clip_x0, clip_x1) x [clip_y0, clip_y1) 内
+     * @param pixels 像素数据（已实体化点云包围盒内的瓦片）
+     * @param splat_rows splat 的行表（splat_row_count 行）
+     * @param depth 深度测试用的局部深度缓冲（裁剪矩形大小），为空表示不做深度测试
+     * @param resolved 深度测试时记录每个像素最近点的颜色（与 depth 同尺寸）
+     */
+    template <typename GetPoint>
+    void Splat(PixelsBuffer& buffer, uint32_t* pixels, const SplatRow* splat_rows, int splat_row_count, size_t count,
+               const GetPoint& get, int clip_x0, int clip_y0, int clip_x1, int clip_y1, float* depth,
+               uint32_t* resolved) const;
+
+    std::vector<math::Point2f> _positions;
+    std::vector<Color> _colors;
+    std::vector<float> _depths;
+    Color _color = Color::White();
+    bool _depth_test = false;
+    int _splat_size = 1;
+    SplatShape _splat_shape = SplatShape::Square;
+    int _thread_count = 0;
+};
+
+} // namespace pri
+
+#endif // POINT_CLOUD_PRIMITIVE_H
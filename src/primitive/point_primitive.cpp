@@ -11,7 +11,7 @@ namespace pri
 // PointPrimitive 实现
 void PointPrimitive::Draw(PixelsBuffer& buffer) const
 {
-    buffer.SetPixel(_x, _y, _color);
+    buffer.BlendPixel(_x, _y, _color);
 }
 
 std::unique_ptr<IPrimitive> PointPrimitive::Clone() const
@@ -19,4 +19,9 @@ std::unique_ptr<IPrimitive> PointPrimitive::Clone() const
     return std::make_unique<PointPrimitive>(*this);
 }
 
+math::BoundingBox2i PointPrimitive::Bounds() const
+{
+    return math::BoundingBox2i(_x, _y, _x + 1, _y + 1);
+}
+
 } // namespace pri
@@ -41,6 +41,7 @@ class PointPrimitive : public IPrimitive
 
     void Draw(PixelsBuffer& buffer) const override;
     std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
 
     void Swap(PointPrimitive& other)
     {
@@ -0,0 +1,37 @@
+//
+// Created by admin on 2026/2/8.
+//
+
+#include "polygon_primitive.h"
+
+namespace pri
+{
+
+void PolygonPrimitive::Draw(PixelsBuffer& buffer) const
+{
+    if (_vertices.size() < 3)
+    {
+        return;
+    }
+    CoverageRasterizer& rasterizer = CoverageRasterizer::ForCurrentThread();
+    rasterizer.Reset();
+    rasterizer.AddContour(_vertices.data(), _vertices.size());
+    rasterizer.Fill(buffer, _color, _fill_rule);
+}
+
+std::unique_ptr<IPrimitive> PolygonPrimitive::Clone() const
+{
+    return std::make_unique<PolygonPrimitive>(*this);
+}
+
+math::BoundingBox2i PolygonPrimitive::Bounds() const
+{
+    if (_vertices.empty())
+    {
+        return {};
+    }
+    const math::BoundingBox2f box = math::BoundingBox2f::FromPoints(_vertices);
+    return PixelBounds(box.MinX(), box.MinY(), box.MaxX(), box.MaxY(), 1.0f);
+}
+
+} // namespace pri
@@ -0,0 +1,81 @@
+//
+// Created by admin on 2026/2/8.
+//
+
+#ifndef POLYGON_PRIMITIVE_H
+#define POLYGON_PRIMITIVE_H
+
+#include "../math/point.h"
+#include "coverage_rasterizer.h"
+#include "primitive.h"
+#include <vector>
+
+namespace pri
+{
+
+/**
+ * @brief 多边形图元(填充，解析覆盖率抗锯齿)
+ *
+ * 支持任意顶点数的简单 / 自相交 / 凹多边形，按填充规则（非零环绕或奇偶）决定内部区域。
+ * 边缘像素的覆盖率由 CoverageRasterizer 一次遍历精确求出，不需要超采样。
+ */
+class PolygonPrimitive : public IPrimitive
+{
+  public:
+    PolygonPrimitive() = default;
+
+    /**
+     * @param vertices 顶点（按顺序连接，最后一个点自动连回第一个点）
+     * @param color 颜色
+     * @param rule 填充规则
+     */
+    PolygonPrimitive(std::vector<math::Point2f> vertices, const Color& color, FillRule rule = FillRule::NonZero)
+        : _vertices(std::move(vertices)), _color(color), _fill_rule(rule)
+    {
+    }
+
+    void Draw(PixelsBuffer& buffer) const override;
+    std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
+
+    // 顶点
+    void AddVertex(const math::Point2f& vertex)
+    {
+        _vertices.push_back(vertex);
+    }
+    void SetVertices(std::vector<math::Point2f> vertices)
+    {
+        _vertices = std::move(vertices);
+    }
+    const std::vector<math::Point2f>& Vertices() const
+    {
+        return _vertices;
+    }
+
+    // 获取/设置属性
+    Color GetColor() const
+    {
+        return _color;
+    }
+    void SetColor(const Color& color)
+    {
+        _color = color;
+    }
+    FillRule GetFillRule() const
+    {
+        return _fill_rule;
+    }
+    void SetFillRule(FillRule rule)
+    {
+        _fill_rule = rule;
+    }
+
+  private:
+    std::vector<math::Point2f> _vertices;
+    Color _color = Color::Green();
+    FillRule _fill_rule = FillRule::NonZero;
+};
+
+} // namespace pri
+
+#endif // POLYGON_PRIMITIVE_H
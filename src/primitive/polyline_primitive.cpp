@@ -0,0 +1,247 @@
+//
+// Created by admin on 2026/2/10.
+//
+
+#include "polyline_primitive.h"
+#include "triangle_rasterizer.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+namespace pri
+{
+
+namespace
+{
+
+constexpr float kPi = 3.14159265358979f;
+
+// 单个圆弧的最大细分步数
+constexpr int kMaxArcSteps = 64;
+
+// 重建三角形带时持有（只在修改后的第一次绘制时使用）
+std::mutex g_tessellate_mutex;
+
+} // namespace
+
+void PolylinePrimitive::Draw(PixelsBuffer& buffer) const
+{
+    Tessellate();
+    TriangleRasterizer::FillStrip(buffer, _strip.data(), _strip.size(), Blender::Premultiply(_color.ToUint32()));
+}
+
+std::unique_ptr<IPrimitive> PolylinePrimitive::Clone() const
+{
+    return std::make_unique<PolylinePrimitive>(*this);
+}
+
+math::BoundingBox2i PolylinePrimitive::Bounds() const
+{
+    if (_points.empty())
+    {
+        return {};
+    }
+    // 尖角连接最多伸出 miter_limit 倍半宽，方形端点最多伸出 sqrt(2) 倍半宽
+    const math::BoundingBox2f box = math::BoundingBox2f::FromPoints(_points);
+    const float extent = 0.5f * _width * std::max(_miter_limit, 1.5f);
+    return PixelBounds(box.MinX(), box.MinY(), box.MaxX(), box.MaxY(), extent + 1.0f);
+}
+
+void PolylinePrimitive::Tessellate() const
+{
+    // 多个线程同时绘制同一折线时，由第一个线程在锁内重建三角形带，其它线程等它完成后直接读取
+    if (!std::atomic_ref<bool>(_dirty).load(std::memory_order_acquire))
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_tessellate_mutex);
+    if (!std::atomic_ref<bool>(_dirty).load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    _strip.clear();
+    TessellateStrip();
+    std::atomic_ref<bool>(_dirty).store(false, std::memory_order_release);
+}
+
+void PolylinePrimitive::TessellateStrip() const
+{
+    const size_t count = _points.size();
+    if (count < 2 || !(_width > 0.0f))
+    {
+        return;
+    }
+    // 直线段和尖角每个顶点产生一对顶点，预留后只有圆角 / 圆头才可能触发扩容
+    _strip.reserve(count * 2 + 4);
+
+    // 跳过重合的相邻点，返回 from 之后第一个与其不同的点
+    auto next_distinct = [this, count](size_t from)
+    {
+        size_t next = from + 1;
+        while (next < count && _points[next] == _points[from])
+        {
+            ++next;
+        }
+        return next;
+    };
+    // 单位方向，返回线段长度
+    auto direction = [this](size_t from, size_t to, float& dx, float& dy)
+    {
+        dx = _points[to].X() - _points[from].X();
+        dy = _points[to].Y() - _points[from].Y();
+        const float len = std::sqrt(dx * dx + dy * dy);
+        dx /= len;
+        dy /= len;
+        return len;
+    };
+
+    size_t current = next_distinct(0);
+    if (current >= count)
+    {
+        return;
+    }
+    float dx0, dy0;
+    float len0 = direction(0, current, dx0, dy0);
+    AddCap(_points[0], dx0, dy0, true);
+
+    for (size_t next = next_distinct(current); next < count; next = next_distinct(current))
+    {
+        float dx1, dy1;
+        const float len1 = direction(current, next, dx1, dy1);
+        // 线段两端的连接各自最多占用一半长度
+        AddJoin(_points[current], dx0, dy0, dx1, dy1, 0.5f * std::min(len0, len1));
+        dx0 = dx1;
+        dy0 = dy1;
+        len0 = len1;
+        current = next;
+    }
+    AddCap(_points[current], dx0, dy0, false);
+}
+
+int PolylinePrimitive::ArcSteps(float angle) const
+{
+    const float radius = 0.5f * _width;
+    if (radius <= 0.25f)
+    {
+        return 1;
+    }
+    const float step = 2.0f * std::acos(1.0f - 0.25f / radius);
+    return std::clamp(static_cast<int>(std::ceil(angle / step)), 1, kMaxArcSteps);
+}
+
+void PolylinePrimitive::AddCap(const math::Point2f& p, float dx, float dy, bool start) const
+{
+    const float hw = 0.5f * _width;
+    const float nx = -dy * hw;
+    const float ny = dx * hw;
+    // 起点端帽向线段反方向延伸，终点端帽向线段方向延伸
+    const float ex = (start ? -dx : dx) * hw;
+    const float ey = (start ? -dy : dy) * hw;
+
+    switch (_cap)
+    {
+    case LineCap::Butt:
+        Emit(p.X() + nx, p.Y() + ny, p.X() - nx, p.Y() - ny);
+        break;
+    case LineCap::Square:
+        Emit(p.X() + ex + nx, p.Y() + ey + ny, p.X() + ex - nx, p.Y() + ey - ny);
+        break;
+    case LineCap::Round:
+    {
+        // 半圆按左右对称的顶点对展开：起点从尖端向两侧张开，终点反之
+        const int steps = ArcSteps(0.5f * kPi);
+        for (int i = 0; i <= steps; ++i)
+        {
+            const int k = start ? i : steps - i;
+            const float theta = 0.5f * kPi * static_cast<float>(k) / static_cast<float>(steps);
+            const float c = std::cos(theta);
+            const float s = std::sin(theta);
+            const float bx = p.X() + ex * c;
+            const float by = p.Y() + ey * c;
+            Emit(bx + nx * s, by + ny * s, bx - nx * s, by - ny * s);
+        }
+        break;
+    }
+    }
+}
+
+void PolylinePrimitive::AddJoin(const math::Point2f& p, float dx0, float dy0, float dx1, float dy1,
+                                float inner_limit) const
+{
+    const float hw = 0.5f * _width;
+    const float n0x = -dy0 * hw;
+    const float n0y = dx0 * hw;
+    const float n1x = -dy1 * hw;
+    const float n1y = dx1 * hw;
+    const float cross = dx0 * dy1 - dy0 * dx1;
+    const float dot = dx0 * dx1 + dy0 * dy1;
+
+    // 几乎共线：只需一对顶点
+    if (std::abs(cross) < 1e-6f && dot > 0.0f)
+    {
+        Emit(p.X() + n0x, p.Y() + n0y, p.X() - n0x, p.Y() - n0y);
+        return;
+    }
+
+    if (_join == LineJoin::Miter)
+    {
+        // 尖角方向为两条法线之和，长度为 hw / cos(θ/2)
+        const float mx = (n0x + n1x) / hw;
+        const float my = (n0y + n1y) / hw;
+        const float len2 = mx * mx + my * my;
+        if (len2 > 0.0f && 4.0f <= _miter_limit * _miter_limit * len2)
+        {
+            const float scale = 2.0f * hw / len2;
+            Emit(p.X() + mx * scale, p.Y() + my * scale, p.X() - mx * scale, p.Y() - my * scale);
+            return;
+        }
+    }
+
+    // 斜角 / 圆角：外侧是从上一段法线转到下一段法线的圆弧（斜角只取两端），向 +n 一侧转弯时外侧是 -n 一侧
+    const float side = cross > 0.0f ? -1.0f : 1.0f;
+    const float angle = std::atan2(cross, dot);
+    const int steps = _join == LineJoin::Round ? ArcSteps(std::abs(angle)) : 1;
+    // 按 (+n 侧, -n 侧) 的顺序输出外侧点 (ox, oy) 和内侧点 (ix, iy)
+    auto emit_pair = [this, side](float ox, float oy, float ix, float iy)
+    {
+        if (side < 0.0f)
+        {
+            Emit(ix, iy, ox, oy);
+        }
+        else
+        {
+            Emit(ox, oy, ix, iy);
+        }
+    };
+    auto emit_arc = [&](float ix, float iy)
+    {
+        for (int i = 0; i <= steps; ++i)
+        {
+            const float t = angle * static_cast<float>(i) / static_cast<float>(steps);
+            const float c = std::cos(t);
+            const float s = std::sin(t);
+            emit_pair(p.X() + side * (n0x * c - n0y * s), p.Y() + side * (n0x * s + n0y * c), ix, iy);
+        }
+    };
+
+    // 内侧两条偏移线的交点沿线段回退 hw * tan(θ/2)。交点可用时两段在内侧直接相接，
+    // 外侧扇形以交点为中心，与两段的四边形互不重叠，半透明颜色在转角处只混合一次
+    const float back = hw * std::abs(cross) / (1.0f + dot);
+    if (1.0f + dot > 1e-6f && back <= inner_limit)
+    {
+        const float mx = n0x + n1x;
+        const float my = n0y + n1y;
+        const float scale = 2.0f * hw * hw / (mx * mx + my * my);
+        emit_arc(p.X() - side * mx * scale, p.Y() - side * my * scale);
+        return;
+    }
+
+    // 急转弯且线段较短：交点会越过线段，扇形改以连接点为中心（其余三角形都是退化的），
+    // 此时转角内侧的两段四边形相互重叠
+    Emit(p.X() + n0x, p.Y() + n0y, p.X() - n0x, p.Y() - n0y);
+    emit_arc(p.X(), p.Y());
+    Emit(p.X() + n1x, p.Y() + n1y, p.X() - n1x, p.Y() - n1y);
+}
+
+} // namespace pri
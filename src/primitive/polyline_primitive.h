@@ -0,0 +1,170 @@
+//
+// Created by admin on 2026/2/10.
+//
+
+#ifndef POLYLINE_PRIMITIVE_H
+#define POLYLINE_PRIMITIVE_H
+
+#include "../math/point.h"
+#include "primitive.h"
+#include <vector>
+
+namespace pri
+{
+
+/**
+ * @brief 折线连接方式
+ */
+enum class LineJoin
+{
+    Miter, // 尖角（超过斜接限制时退化为斜角）
+    Round, // 圆角
+    Bevel  // 斜角
+};
+
+/**
+ * @brief 折线端点样式
+ */
+enum class LineCap
+{
+    Butt,  // 平头（在端点处截断）
+    Round, // 圆头
+    Square // 方头（向外延伸半个线宽）
+};
+
+/**
+ * @brief 宽折线图元
+ *
+ * 一次遍历顶点把整条折线（含连接和端点）展开为一条三角形带：
+ *   - 直线段在两侧各生成一个顶点
+ *   - 尖角连接只需额外一对顶点；斜角和圆角在内侧交点处相接，外侧以退化三角形的方式插入以交点为中心的扇形顶点，
+ *     扇形与相邻两段互不重叠；圆头同样以扇形顶点展开
+ *   - 三角形带缓存在图元内部并复用容量，重复绘制和修改顶点时都不会逐段分配内存
+ * 最后整条带一次性交给 TriangleRasterizer 光栅化（左上规则，相邻三角形不重复混合）。
+ *
+ * 注意：急转弯且相邻线段短于内侧交点的回退距离（hw * tan(θ/2)）的两倍时，内侧两段改为在连接点处相接并相互重叠，
+ * 半透明颜色在那里会被混合两次。
+ */
+class PolylinePrimitive : public IPrimitive
+{
+  public:
+    PolylinePrimitive() = default;
+
+    PolylinePrimitive(std::vector<math::Point2f> points, float width, const Color& color = Color::Green())
+        : _points(std::move(points)), _width(width), _color(color)
+    {
+    }
+
+    void Draw(PixelsBuffer& buffer) const override;
+    std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
+
+    // 顶点
+    void AddPoint(const math::Point2f& point)
+    {
+        _points.push_back(point);
+        _dirty = true;
+    }
+    void SetPoints(std::vector<math::Point2f> points)
+    {
+        _points = std::move(points);
+        _dirty = true;
+    }
+    const std::vector<math::Point2f>& Points() const
+    {
+        return _points;
+    }
+
+    // 获取/设置属性
+    float GetWidth() const
+    {
+        return _width;
+    }
+    void SetWidth(float width)
+    {
+        _width = width;
+        _dirty = true;
+    }
+    Color GetColor() const
+    {
+        return _color;
+    }
+    void SetColor(const Color& color)
+    {
+        _color = color;
+    }
+    LineJoin GetJoin() const
+    {
+        return _join;
+    }
+    void SetJoin(LineJoin join)
+    {
+        _join = join;
+        _dirty = true;
+    }
+    LineCap GetCap() const
+    {
+        return _cap;
+    }
+    void SetCap(LineCap cap)
+    {
+        _cap = cap;
+        _dirty = true;
+    }
+
+    /**
+     * @brief 斜接限制：尖角长度与半线宽之比超过该值时改用斜角连接（默认 4）
+     */
+    float GetMiterLimit() const
+    {
+        return _miter_limit;
+    }
+    void SetMiterLimit(float limit)
+    {
+        _miter_limit = limit;
+        _dirty = true;
+    }
+
+    /**
+     * @brief 展开后的三角形带顶点（主要用于调试和统计）
+     */
+    const std::vector<math::Point2f>& Strip() const
+    {
+        Tessellate();
+        return _strip;
+    }
+
+  private:
+    // 在需要时重新展开三角形带（加锁，同一折线可以在多个线程中同时绘制）
+    void Tessellate() const;
+
+    // 把整条折线展开追加到 _strip
+    void TessellateStrip() const;
+
+    // 圆弧细分步数（弦误差不超过 1/4 像素）
+    int ArcSteps(float angle) const;
+
+    void AddCap(const math::Point2f& p, float dx, float dy, bool start) const;
+    // inner_limit：内侧交点沿线段回退的最大距离
+    void AddJoin(const math::Point2f& p, float dx0, float dy0, float dx1, float dy1, float inner_limit) const;
+
+    void Emit(float lx, float ly, float rx, float ry) const
+    {
+        _strip.emplace_back(lx, ly);
+        _strip.emplace_back(rx, ry);
+    }
+
+    std::vector<math::Point2f> _points;
+    float _width = 1.0f;
+    Color _color = Color::Green();
+    LineJoin _join = LineJoin::Miter;
+    LineCap _cap = LineCap::Butt;
+    float _miter_limit = 4.0f;
+
+    mutable bool _dirty = true;
+    mutable std::vector<math::Point2f> _strip; // 三角形带（每次成对追加左右两侧顶点）
+};
+
+} // namespace pri
+
+#endif // POLYLINE_PRIMITIVE_H
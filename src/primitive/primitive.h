@@ -5,8 +5,13 @@
 #ifndef PRIMITIVE_H
 #define PRIMITIVE_H
 
+#include "../math/bounding_box.h"
 #include "../pixels_buffer.h"
 #include "texture/texture.h"
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
 #include <memory>
 #include <vector>
 
@@ -16,17 +21,24 @@ namespace pri
 /**
  * @brief 重心坐标（Barycentric Coordinate）
  * 用于表示点在凸多边形内部的权重系数
- * 支持三角形、四边形等任意凸多边形
+ * 支持三角形、四边形等任意凸多边形（最多 kMaxVertices 个顶点）
+ * 权重存放在对象内部，逐像素构造时不分配堆内存
  */
 struct BarycentricCoord
 {
-    std::vector<float> weights; // 各顶点的权重
+    static constexpr size_t kMaxVertices = 8;
+
+    std::array<float, kMaxVertices> weights{}; // 各顶点的权重
+    size_t count = 0;                          // 顶点数量
 
     BarycentricCoord() = default;
 
-    explicit BarycentricCoord(size_t vertex_count) : weights(vertex_count, 0.0f) {}
+    explicit BarycentricCoord(size_t vertex_count) : count(std::min(vertex_count, kMaxVertices)) {}
 
-    BarycentricCoord(std::initializer_list<float> init) : weights(init) {}
+    BarycentricCoord(std::initializer_list<float> init) : count(std::min(init.size(), kMaxVertices))
+    {
+        std::copy_n(init.begin(), count, weights.begin());
+    }
 
     /**
      * @brief 检查重心坐标是否有效（权重之和应该约等于1）
@@ -34,9 +46,9 @@ struct BarycentricCoord
     [[nodiscard]] bool IsValid() const
     {
         float sum = 0.0f;
-        for (float w : weights)
+        for (size_t i = 0; i < count; ++i)
         {
-            sum += w;
+            sum += weights[i];
         }
         return sum > 0.99f && sum < 1.01f;
     }
@@ -46,7 +58,7 @@ struct BarycentricCoord
      */
     [[nodiscard]] size_t Size() const
     {
-        return weights.size();
+        return count;
     }
 
     /**
@@ -72,6 +84,9 @@ class IPrimitive
 
     /**
      * @brief 绘制图元到指定的像素缓冲区
+     *
+     * 同一个图元可以在多个线程中同时绘制到不同的缓冲区：临时缓冲借用线程局部的光栅化器或帧内分配器，
+     * 不写图元成员；按需重建的缓存（如路径细分）在锁内更新。不能与修改图元的调用并发。
      * @param buffer 像素缓冲区
      */
     virtual void Draw(PixelsBuffer& buffer) const = 0;
@@ -82,6 +97,24 @@ class IPrimitive
      */
     virtual std::unique_ptr<IPrimitive> Clone() const = 0;
 
+    /**
+     * @brief 像素包围盒 [min, max)：绘制时写入的像素都在其中（保守估计，用于损坏区域跟踪和合批）
+     *
+     * 默认返回无限大的包围盒，表示范围未知。
+     */
+    [[nodiscard]] virtual math::BoundingBox2i Bounds() const
+    {
+        return Unbounded();
+    }
+
+    /**
+     * @brief 无限大的包围盒
+     */
+    static math::BoundingBox2i Unbounded()
+    {
+        return math::BoundingBox2i(INT_MIN, INT_MIN, INT_MAX, INT_MAX);
+    }
+
     /**
      * @brief 设置纹理（基类提供默认实现）
      * @param texture 纹理对象
@@ -100,6 +133,17 @@ class IPrimitive
     }
 
   protected:
+    /**
+     * @brief 浮点范围 [min, max]（整数坐标位于像素中心）向外扩展 margin 像素后覆盖的像素包围盒
+     */
+    static math::BoundingBox2i PixelBounds(float min_x, float min_y, float max_x, float max_y, float margin)
+    {
+        return math::BoundingBox2i(static_cast<int>(std::floor(min_x - margin)),
+                                   static_cast<int>(std::floor(min_y - margin)),
+                                   static_cast<int>(std::ceil(max_x + margin)) + 1,
+                                   static_cast<int>(std::ceil(max_y + margin)) + 1);
+    }
+
     std::shared_ptr<texture::Texture> _texture; // 纹理（所有图元共享）
 };
 
@@ -0,0 +1,637 @@
+//
+// Created by admin on 2026/2/14.
+//
+
+#ifndef PRIMITIVE_STORE_H
+#define PRIMITIVE_STORE_H
+
+#include "../damage_tracker.h"
+#include "circle_primitive.h"
+#include "ellipse_primitive.h"
+#include "line_batch.h"
+#include "line_primitive.h"
+#include "nine_slice_primitive.h"
+#include "path_primitive.h"
+#include "point_cloud_primitive.h"
+#include "point_primitive.h"
+#include "polygon_primitive.h"
+#include "polyline_primitive.h"
+#include "primitive.h"
+#include "rounded_rect_primitive.h"
+#include "tiled_image_primitive.h"
+#include "triangle_primitive.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pri
+{
+
+/**
+ * @brief 保留模式图元的句柄
+ *
+ * 图元被删除后句柄失效：槽位会被复用，但代数（generation）随之递增，旧句柄不会误指向新图元。
+ */
+struct PrimitiveHandle
+{
+    static constexpr uint32_t kInvalidType = 0xFFFFFFFF;
+
+    uint32_t type = kInvalidType; // 图元类型在存储中的序号
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool IsValid() const
+    {
+        return type != kInvalidType;
+    }
+};
+
+/**
+ * @brief 按类型分开存放的保留模式图元存储
+ *
+ * 每种图元类型各自存放在一个连续数组中（值语义，添加时不做单独的堆分配），
+ * 绘制时按排序键合并成若干段同类型的连续区间，每段用该类型的非虚调用循环绘制，
+ * 虚函数分派从每个图元一次降到每段一次。
+ *
+ * 绘制顺序：按 (排序键, 添加顺序) 升序，排序键默认为 0，即与添加顺序一致。
+ * 只有添加、删除、修改排序键会使顺序失效，下一次 Draw 时才重新排序；
+ * 通过 Get 原地修改图元属性不影响顺序，不需要重排。
+ *
+ * 不在类型列表中的图元（自定义的 IPrimitive 子类）存放在 std::unique_ptr<IPrimitive> 数组中，按虚函数绘制。
+ *
+ * 损坏区域：每个图元记录上次绘制时的包围盒。CollectDamage 比较当前包围盒，位置或属性变化的图元
+ * 把旧位置和新位置都计入损坏区域；DrawDamaged 只重绘与损坏区域相交的图元。
+ * 通过 Get 取得的图元视为已修改，std::unique_ptr<IPrimitive> 中的图元修改后需调用 MarkDirty。
+ */
+template <typename... Types>
+class BasicPrimitiveStore
+{
+  public:
+    // 类型 T 在类型列表中的序号（不在列表中时为 sizeof...(Types)）
+    template <typename T>
+    static constexpr uint32_t TypeIndex()
+    {
+        constexpr std::array<bool, sizeof...(Types)> matches{std::is_same_v<T, Types>...};
+        for (uint32_t i = 0; i < matches.size(); ++i)
+        {
+            if (matches[i])
+            {
+                return i;
+            }
+        }
+        return sizeof...(Types);
+    }
+
+    template <typename T>
+    static constexpr bool Contains()
+    {
+        return TypeIndex<T>() < sizeof...(Types);
+    }
+
+    /**
+     * @brief 添加一个图元（按值移入对应类型的数组）
+     * @param primitive 图元；不在类型列表中的 IPrimitive 子类会被包装进 std::unique_ptr<IPrimitive>
+     * @param sort_key 排序键，越小越先绘制，相同时按添加顺序
+     */
+    template <typename T>
+    PrimitiveHandle Add(T primitive, uint64_t sort_key = 0)
+    {
+        if constexpr (Contains<T>())
+        {
+            return Insert<T>(std::move(primitive), sort_key);
+        }
+        else
+        {
+            static_assert(std::is_base_of_v<IPrimitive, T>, "primitive must derive from pri::IPrimitive");
+            return Insert<std::unique_ptr<IPrimitive>>(std::make_unique<T>(std::move(primitive)), sort_key);
+        }
+    }
+
+    /**
+     * @brief 删除图元，句柄失效时返回 false
+     * @param damage 不为空时，把图元上次绘制的区域计入损坏区域
+     */
+    bool Remove(PrimitiveHandle handle, DamageTracker* damage = nullptr)
+    {
+        return VisitPool(handle.type,
+                         [&](auto& pool)
+                         {
+                             const uint32_t dense = pool.Find(handle);
+                             if (dense == kNoIndex)
+                             {
+                                 return false;
+                             }
+                             if (damage)
+                             {
+                                 damage->Add(pool.slots[handle.slot].drawn);
+                             }
+                             pool.Erase(dense);
+                             _order_dirty = true;
+                             --_size;
+                             return true;
+                         });
+    }
+
+    /**
+     * @brief 获取图元用于原地修改（图元被标记为已修改），句柄失效或类型不符时返回 nullptr
+     */
+    template <typename T>
+    T* Get(PrimitiveHandle handle)
+    {
+        static_assert(Contains<T>(), "type is not stored separately; use std::unique_ptr<IPrimitive>");
+        if (handle.type != TypeIndex<T>())
+        {
+            return nullptr;
+        }
+        auto& pool = std::get<TypeIndex<T>()>(_pools);
+        const uint32_t dense = pool.Find(handle);
+        if (dense == kNoIndex)
+        {
+            return nullptr;
+        }
+        pool.slots[handle.slot].dirty = true;
+        return &pool.items[dense];
+    }
+
+    /**
+     * @brief 标记图元已修改，下一次 CollectDamage 时重绘它所在的区域；句柄失效时返回 false
+     */
+    bool MarkDirty(PrimitiveHandle handle)
+    {
+        return VisitPool(handle.type,
+                         [&](auto& pool)
+                         {
+                             if (pool.Find(handle) == kNoIndex)
+                             {
+                                 return false;
+                             }
+                             pool.slots[handle.slot].dirty = true;
+                             return true;
+                         });
+    }
+
+    /**
+     * @brief 修改排序键，句柄失效时返回 false
+     *
+     * 排序键改变后图元与其它图元的叠放顺序随之改变，图元被标记为已修改，下一次 CollectDamage 时重绘它所在的区域
+     */
+    bool SetSortKey(PrimitiveHandle handle, uint64_t sort_key)
+    {
+        return VisitPool(handle.type,
+                         [&](auto& pool)
+                         {
+                             const uint32_t dense = pool.Find(handle);
+                             if (dense == kNoIndex)
+                             {
+                                 return false;
+                             }
+                             if (pool.order[dense].key != sort_key)
+                             {
+                                 pool.order[dense].key = sort_key;
+                                 pool.slots[handle.slot].dirty = true;
+                                 _order_dirty = true;
+                             }
+                             return true;
+                         });
+    }
+
+    /**
+     * @brief 清空所有图元（保留各数组容量）
+     */
+    void Clear()
+    {
+        std::apply([](auto&... pools) { (pools.Clear(), ...); }, _pools);
+        _runs.clear();
+        _order_dirty = false;
+        _size = 0;
+        _sequence = 0;
+    }
+
+    [[nodiscard]] size_t Size() const
+    {
+        return _size;
+    }
+
+    [[nodiscard]] bool Empty() const
+    {
+        return _size == 0;
+    }
+
+    /**
+     * @brief 按排序键顺序绘制所有图元
+     */
+    void Draw(PixelsBuffer& buffer)
+    {
+        if (_order_dirty)
+        {
+            Rebuild();
+        }
+        for (const Run& run : _runs)
+        {
+            kDrawRange[run.type](*this, buffer, run.begin, run.end, nullptr);
+        }
+    }
+
+    /**
+     * @brief 收集损坏区域：包围盒变化或被标记为已修改的图元，把上次绘制的区域和当前区域都加入 damage，
+     * 并把当前包围盒记为已绘制
+     */
+    void CollectDamage(DamageTracker& damage)
+    {
+        std::apply(
+            [&damage](auto&... pools)
+            {
+                (
+                    [&damage](auto& pool)
+                    {
+                        for (uint32_t i = 0; i < pool.items.size(); ++i)
+                        {
+                            Slot& slot = pool.slots[pool.owners[i]];
+                            const math::BoundingBox2i bounds = pool.Bounds(i);
+                            if (slot.dirty || bounds != slot.drawn)
+                            {
+                                damage.Add(slot.drawn);
+                                damage.Add(bounds);
+                                slot.drawn = bounds;
+                                slot.dirty = false;
+                            }
+                        }
+                    }(pools),
+                    ...);
+            },
+            _pools);
+    }
+
+    /**
+     * @brief 扩展损坏区域，直到每个与之相交的图元都被某一个损坏矩形完整包含
+     *
+     * DrawDamaged 不裁剪，与损坏区域相交的图元整个重绘；扩展后这些图元覆盖的像素都已被清除，
+     * 损坏区域之外的像素不会被重复混合。
+     */
+    void ExpandDamage(DamageTracker& damage)
+    {
+        bool changed = true;
+        while (changed && !damage.IsFull())
+        {
+            changed = false;
+            std::apply(
+                [&](auto&... pools)
+                {
+                    (
+                        [&](auto& pool)
+                        {
+                            for (uint32_t slot : pool.owners)
+                            {
+                                const math::BoundingBox2i& drawn = pool.slots[slot].drawn;
+                                if (damage.Intersects(drawn) && !damage.Covers(drawn))
+                                {
+                                    damage.Add(drawn);
+                                    changed = true;
+                                }
+                            }
+                        }(pools),
+                        ...);
+                },
+                _pools);
+        }
+    }
+
+    /**
+     * @brief 按排序键顺序只绘制与损坏区域相交的图元（应先调用 CollectDamage 和 ExpandDamage）
+     */
+    void DrawDamaged(PixelsBuffer& buffer, const DamageTracker& damage)
+    {
+        if (_order_dirty)
+        {
+            Rebuild();
+        }
+        for (const Run& run : _runs)
+        {
+            kDrawRange[run.type](*this, buffer, run.begin, run.end, &damage);
+        }
+    }
+
+  private:
+    static constexpr uint32_t kNoIndex = 0xFFFFFFFF;
+
+    // 绘制顺序：先比较排序键，再比较添加序号
+    struct Order
+    {
+        uint64_t key;
+        uint64_t sequence;
+
+        bool operator<(const Order& other) const
+        {
+            return key != other.key ? key < other.key : sequence < other.sequence;
+        }
+    };
+
+    // 槽位：句柄 -> 数组下标，以及损坏区域跟踪所需的上次绘制的包围盒
+    struct Slot
+    {
+        uint32_t dense;
+        uint32_t generation;
+        math::BoundingBox2i drawn{}; // 无效包围盒表示尚未绘制
+        bool dirty = true;
+    };
+
+    /**
+     * @brief 单一类型的图元数组
+     *
+     * items / order / owners 三个数组按下标一一对应且保持紧凑；删除时把最后一个元素移到空位。
+     */
+    template <typename T>
+    struct Pool
+    {
+        std::vector<T> items;
+        std::vector<Order> order;
+        std::vector<uint32_t> owners; // 每个元素所属的槽位
+        std::vector<Slot> slots;
+        std::vector<uint32_t> free_slots;
+
+        uint32_t Find(PrimitiveHandle handle) const
+        {
+            if (handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation)
+            {
+                return kNoIndex;
+            }
+            return slots[handle.slot].dense;
+        }
+
+        math::BoundingBox2i Bounds(uint32_t dense) const
+        {
+            if constexpr (std::is_same_v<T, std::unique_ptr<IPrimitive>>)
+            {
+                return items[dense]->Bounds();
+            }
+            else
+            {
+                return items[dense].T::Bounds();
+            }
+        }
+
+        void Erase(uint32_t dense)
+        {
+            const uint32_t last = static_cast<uint32_t>(items.size()) - 1;
+            const uint32_t slot = owners[dense];
+            if (dense != last)
+            {
+                items[dense] = std::move(items[last]);
+                order[dense] = order[last];
+                owners[dense] = owners[last];
+                slots[owners[dense]].dense = dense;
+            }
+            items.pop_back();
+            order.pop_back();
+            owners.pop_back();
+            slots[slot].dense = kNoIndex;
+            ++slots[slot].generation;
+            free_slots.push_back(slot);
+        }
+
+        void Clear()
+        {
+            for (uint32_t slot : owners)
+            {
+                slots[slot].dense = kNoIndex;
+                ++slots[slot].generation;
+                free_slots.push_back(slot);
+            }
+            items.clear();
+            order.clear();
+            owners.clear();
+        }
+
+        // 按绘制顺序原地重排（permutation[i] 为新位置 i 上的旧下标）
+        void Sort(std::vector<uint32_t>& permutation)
+        {
+            const uint32_t count = static_cast<uint32_t>(items.size());
+            if (std::is_sorted(order.begin(), order.end()))
+            {
+                return;
+            }
+            permutation.resize(count);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                permutation[i] = i;
+            }
+            std::sort(permutation.begin(), permutation.end(),
+                      [this](uint32_t a, uint32_t b) { return order[a] < order[b]; });
+            // 按置换环逐个移动，处理过的位置标记为 kNoIndex
+            for (uint32_t start = 0; start < count; ++start)
+            {
+                if (permutation[start] == kNoIndex || permutation[start] == start)
+                {
+                    continue;
+                }
+                T item = std::move(items[start]);
+                const Order item_order = order[start];
+                const uint32_t owner = owners[start];
+                uint32_t current = start;
+                while (permutation[current] != start)
+                {
+                    const uint32_t next = permutation[current];
+                    items[current] = std::move(items[next]);
+                    order[current] = order[next];
+                    owners[current] = owners[next];
+                    permutation[current] = kNoIndex;
+                    current = next;
+                }
+                items[current] = std::move(item);
+                order[current] = item_order;
+                owners[current] = owner;
+                permutation[current] = kNoIndex;
+            }
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                slots[owners[i]].dense = i;
+            }
+        }
+    };
+
+    // 绘制列表中的一段：同一类型数组中的连续区间 [begin, end)
+    struct Run
+    {
+        uint32_t type;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    // 合并时的一个元素
+    struct Entry
+    {
+        Order order;
+        uint32_t type;
+        uint32_t index;
+    };
+
+    using DrawRangeFn = void (*)(BasicPrimitiveStore&, PixelsBuffer&, uint32_t, uint32_t, const DamageTracker*);
+
+    template <typename T>
+    PrimitiveHandle Insert(T primitive, uint64_t sort_key)
+    {
+        constexpr uint32_t type = TypeIndex<T>();
+        auto& pool = std::get<type>(_pools);
+        uint32_t slot;
+        if (pool.free_slots.empty())
+        {
+            slot = static_cast<uint32_t>(pool.slots.size());
+            pool.slots.push_back({kNoIndex, 0});
+        }
+        else
+        {
+            slot = pool.free_slots.back();
+            pool.free_slots.pop_back();
+            pool.slots[slot].drawn = {};
+            pool.slots[slot].dirty = true;
+        }
+        pool.slots[slot].dense = static_cast<uint32_t>(pool.items.size());
+        pool.items.push_back(std::move(primitive));
+        pool.order.push_back({sort_key, _sequence++});
+        pool.owners.push_back(slot);
+        ++_size;
+
+        // 未失效时各数组有序且全部在绘制列表中；新图元排在最后时它就在数组末尾，直接延长绘制列表即可
+        if (!_order_dirty)
+        {
+            const uint32_t index = pool.slots[slot].dense;
+            if (!_runs.empty() && pool.order[index] < LastOrder())
+            {
+                _order_dirty = true;
+            }
+            else if (!_runs.empty() && _runs.back().type == type)
+            {
+                ++_runs.back().end;
+            }
+            else
+            {
+                _runs.push_back({type, index, index + 1});
+            }
+        }
+        return {type, slot, pool.slots[slot].generation};
+    }
+
+    // 当前绘制列表中最后一个元素的顺序
+    Order LastOrder()
+    {
+        const Run& run = _runs.back();
+        Order last{};
+        VisitPool(run.type,
+                  [&](auto& pool)
+                  {
+                      last = pool.order[run.end - 1];
+                      return true;
+                  });
+        return last;
+    }
+
+    // 重排各类型数组并重建绘制列表
+    void Rebuild()
+    {
+        std::apply([this](auto&... pools) { (pools.Sort(_permutation), ...); }, _pools);
+
+        _entries.clear();
+        _entries.reserve(_size);
+        AppendEntries(std::index_sequence_for<Types...>{});
+        std::sort(_entries.begin(), _entries.end(),
+                  [](const Entry& a, const Entry& b) { return a.order < b.order; });
+
+        // 各数组已按顺序排好，相邻的同类型元素下标必然连续
+        _runs.clear();
+        for (const Entry& entry : _entries)
+        {
+            if (!_runs.empty() && _runs.back().type == entry.type)
+            {
+                ++_runs.back().end;
+            }
+            else
+            {
+                _runs.push_back({entry.type, entry.index, entry.index + 1});
+            }
+        }
+        _order_dirty = false;
+    }
+
+    template <size_t... I>
+    void AppendEntries(std::index_sequence<I...>)
+    {
+        (
+            [this]
+            {
+                const auto& pool = std::get<I>(_pools);
+                for (uint32_t i = 0; i < pool.order.size(); ++i)
+                {
+                    _entries.push_back({pool.order[i], static_cast<uint32_t>(I), i});
+                }
+            }(),
+            ...);
+    }
+
+    // 按运行时类型序号访问对应数组，f 返回 bool
+    template <typename F>
+    bool VisitPool(uint32_t type, F&& f)
+    {
+        return VisitPool(type, f, std::index_sequence_for<Types...>{});
+    }
+
+    template <typename F, size_t... I>
+    bool VisitPool(uint32_t type, F& f, std::index_sequence<I...>)
+    {
+        bool result = false;
+        ((type == I ? (result = f(std::get<I>(_pools)), true) : false) || ...);
+        return result;
+    }
+
+    // 类型 T 的区间绘制：限定名调用 T::Draw，编译期确定目标，不经过虚函数表；damage 不为空时跳过不相交的图元
+    template <typename T>
+    static void DrawRange(BasicPrimitiveStore& store, PixelsBuffer& buffer, uint32_t begin, uint32_t end,
+                          const DamageTracker* damage)
+    {
+        const auto& pool = std::get<TypeIndex<T>()>(store._pools);
+        const auto& items = pool.items;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            if (damage && !damage->Intersects(pool.slots[pool.owners[i]].drawn))
+            {
+                continue;
+            }
+            if constexpr (std::is_same_v<T, std::unique_ptr<IPrimitive>>)
+            {
+                items[i]->Draw(buffer);
+            }
+            else
+            {
+                items[i].T::Draw(buffer);
+            }
+        }
+    }
+
+    static constexpr std::array<DrawRangeFn, sizeof...(Types)> kDrawRange{&DrawRange<Types>...};
+
+    std::tuple<Pool<Types>...> _pools;
+    std::vector<Run> _runs;
+    bool _order_dirty = false;
+    size_t _size = 0;
+    uint64_t _sequence = 0;
+
+    // 重排时的临时数据（复用容量）
+    std::vector<uint32_t> _permutation;
+    std::vector<Entry> _entries;
+};
+
+/**
+ * @brief 渲染器使用的图元存储：内置图元各占一个数组，其余 IPrimitive 子类按指针存放
+ */
+using PrimitiveStore =
+    BasicPrimitiveStore<PointPrimitive, LinePrimitive, TrianglePrimitive, PolygonPrimitive, PathPrimitive,
+                        PolylinePrimitive, CirclePrimitive, EllipsePrimitive, RoundedRectPrimitive, LineBatch,
+                        PointCloudPrimitive, NineSlicePrimitive, TiledImagePrimitive, std::unique_ptr<IPrimitive>>;
+
+} // namespace pri
+
+#endif // PRIMITIVE_STORE_H
@@ -0,0 +1,75 @@
+//
+// Created by admin on 2026/2/13.
+//
+
+#include "rounded_rect_primitive.h"
+#include "../blender.h"
+#include <algorithm>
+#include <cmath>
+
+namespace pri
+{
+
+void RoundedRectPrimitive::Draw(PixelsBuffer& buffer) const
+{
+    if (_width <= 0.0f || _height <= 0.0f)
+    {
+        return;
+    }
+    const uint32_t color = Blender::Premultiply(_color.ToUint32());
+    ShapeRasterizer& rasterizer = ShapeRasterizer::ForCurrentThread();
+    if (_antialiased)
+    {
+        const float half_width = 0.5f * _width;
+        const float half_height = 0.5f * _height;
+        const float radius = std::clamp(_radius, 0.0f, std::min(half_width, half_height));
+        const RoundedShapeF shape{_position.X() + half_width, _position.Y() + half_height, half_width - radius,
+                                  half_height - radius, radius, radius};
+        if (_filled)
+        {
+            rasterizer.FillAntialiased(buffer, shape, color);
+        }
+        else
+        {
+            rasterizer.StrokeAntialiased(buffer, shape, _stroke_width, color);
+        }
+        return;
+    }
+
+    // 覆盖中心落在 [x, x + width) x [y, y + height) 内的像素
+    const int x0 = static_cast<int>(std::ceil(_position.X()));
+    const int y0 = static_cast<int>(std::ceil(_position.Y()));
+    const int x1 = static_cast<int>(std::ceil(_position.X() + _width)) - 1;
+    const int y1 = static_cast<int>(std::ceil(_position.Y() + _height)) - 1;
+    if (x0 > x1 || y0 > y1)
+    {
+        return;
+    }
+    const int radius = std::clamp(static_cast<int>(std::lround(_radius)), 0, std::min(x1 - x0, y1 - y0) / 2);
+    const RoundedShape shape{x0 + radius, y0 + radius, x1 - radius, y1 - radius, radius, radius};
+    if (_filled)
+    {
+        rasterizer.Fill(buffer, shape, color);
+    }
+    else
+    {
+        rasterizer.Stroke(buffer, shape, std::max(static_cast<int>(std::lround(_stroke_width)), 1), color);
+    }
+}
+
+std::unique_ptr<IPrimitive> RoundedRectPrimitive::Clone() const
+{
+    return std::make_unique<RoundedRectPrimitive>(*this);
+}
+
+math::BoundingBox2i RoundedRectPrimitive::Bounds() const
+{
+    if (_width < 0.0f || _height < 0.0f)
+    {
+        return {};
+    }
+    const float stroke = _filled ? 0.0f : 0.5f * _stroke_width;
+    return PixelBounds(_position.X(), _position.Y(), _position.X() + _width, _position.Y() + _height, stroke + 1.0f);
+}
+
+} // namespace pri
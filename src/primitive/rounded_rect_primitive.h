@@ -0,0 +1,124 @@
+//
+// Created by admin on 2026/2/13.
+//
+
+#ifndef ROUNDED_RECT_PRIMITIVE_H
+#define ROUNDED_RECT_PRIMITIVE_H
+
+#include "../math/point.h"
+#include "primitive.h"
+#include "shape_rasterizer.h"
+
+namespace pri
+{
+
+/**
+ * @brief 圆角矩形图元（实心或描边，可选抗锯齿边缘）
+ *
+ * 矩形范围为 [x, x + width) x [y, y + height)，不抗锯齿时覆盖中心落在该范围内的像素；
+ * 圆角半径被限制在宽高较小者的一半以内，半径为 0 即普通矩形。
+ * 中间的直边行直接整行填充，只有圆角所在的行需要查半宽表（或计算边缘覆盖率）。
+ */
+class RoundedRectPrimitive : public IPrimitive
+{
+  public:
+    RoundedRectPrimitive() = default;
+
+    /**
+     * @param position 左上角
+     * @param width 宽度
+     * @param height 高度
+     * @param radius 圆角半径
+     * @param color 颜色
+     * @param filled 是否填充（否则只描边）
+     * @param antialiased 是否抗锯齿
+     */
+    RoundedRectPrimitive(const math::Point2f& position, float width, float height, float radius, const Color& color,
+                         bool filled = true, bool antialiased = false)
+        : _position(position), _width(width), _height(height), _radius(radius), _color(color), _filled(filled),
+          _antialiased(antialiased)
+    {
+    }
+
+    void Draw(PixelsBuffer& buffer) const override;
+    std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
+
+    // 获取/设置属性
+    math::Point2f GetPosition() const
+    {
+        return _position;
+    }
+    void SetPosition(const math::Point2f& position)
+    {
+        _position = position;
+    }
+    float GetWidth() const
+    {
+        return _width;
+    }
+    float GetHeight() const
+    {
+        return _height;
+    }
+    void SetSize(float width, float height)
+    {
+        _width = width;
+        _height = height;
+    }
+    float GetRadius() const
+    {
+        return _radius;
+    }
+    void SetRadius(float radius)
+    {
+        _radius = radius;
+    }
+    Color GetColor() const
+    {
+        return _color;
+    }
+    void SetColor(const Color& color)
+    {
+        _color = color;
+    }
+    bool IsFilled() const
+    {
+        return _filled;
+    }
+    void SetFilled(bool filled)
+    {
+        _filled = filled;
+    }
+    // 描边宽度（不抗锯齿时四舍五入，至少 1 像素）
+    float GetStrokeWidth() const
+    {
+        return _stroke_width;
+    }
+    void SetStrokeWidth(float width)
+    {
+        _stroke_width = width;
+    }
+    bool IsAntialiased() const
+    {
+        return _antialiased;
+    }
+    void SetAntialiased(bool antialiased)
+    {
+        _antialiased = antialiased;
+    }
+
+  private:
+    math::Point2f _position;
+    float _width = 0.0f;
+    float _height = 0.0f;
+    float _radius = 0.0f;
+    Color _color = Color::White();
+    bool _filled = true;
+    float _stroke_width = 1.0f;
+    bool _antialiased = false;
+};
+
+} // namespace pri
+
+#endif // ROUNDED_RECT_PRIMITIVE_H
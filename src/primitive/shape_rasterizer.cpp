@@ -0,0 +1,324 @@
+//
+// Created by admin on 2026/2/13.
+//
+
+#include "shape_rasterizer.h"
+#include "../blender.h"
+#include <algorithm>
+#include <cmath>
+
+namespace pri
+{
+
+namespace
+{
+
+// 椭圆有向距离的求解精度（像素）
+constexpr float kDistanceTolerance = 1.0f / 512.0f;
+// 二分次数上限（坐标很大时 float 精度达不到 kDistanceTolerance）
+constexpr int kMaxBisections = 32;
+
+/**
+ * @brief 按中点法的整数判别式求出四分之一椭圆每行的半宽
+ *
+ * 判别式 f = (2x)^2 (2ry + 1)^2 + (2y)^2 (2rx + 1)^2 - (2rx + 1)^2 (2ry + 1)^2，
+ * f <= 0 表示像素中心 (x, y) 在半轴为 rx + 0.5、ry + 0.5 的椭圆内（与中点画圆法的 r^2 + r 判据一致）。
+ * 行号增加时半宽单调不增，x 和 y 的每一步都只需一次乘加更新 f。
+ */
+void BuildHalfWidths(int rx, int ry, std::vector<int>& widths)
+{
+    widths.resize(ry + 1);
+    const int64_t a2 = (2LL * rx + 1) * (2LL * rx + 1);
+    const int64_t b2 = (2LL * ry + 1) * (2LL * ry + 1);
+    int x = rx;
+    int64_t f = 4LL * rx * rx * b2 - a2 * b2;
+    for (int y = 0; y <= ry; ++y)
+    {
+        while (x > 0 && f > 0)
+        {
+            f -= b2 * (8LL * x - 4); // (2x)^2 - (2x - 2)^2
+            --x;
+        }
+        widths[y] = x;
+        f += a2 * (8LL * y + 4); // (2y + 2)^2 - (2y)^2
+    }
+}
+
+// 行 y 到圆心矩形 [top, bottom] 的纵向距离
+inline int RowOffset(int y, int top, int bottom)
+{
+    return y < top ? top - y : (y > bottom ? y - bottom : 0);
+}
+
+// 把第 y 行的闭区间 [x0, x1] 裁剪到裁剪矩形后作为纯色 span 混合（跳过模板测试不通过的像素）
+inline void SolidSpan(const PixelsBuffer& buffer, uint32_t* row, int y, int x0, int x1, uint32_t color,
+                      BlendMode mode)
+{
+    x0 = std::max(x0, buffer.ClipMinX());
+    x1 = std::min(x1, buffer.ClipMaxX() - 1);
+    buffer.ForEachWritableRun(y, x0, x1 + 1, [&](int begin, int end) {
+        Blender::BlendSolidSpan(row + begin, color, end - begin, mode);
+    });
+}
+
+// 截断到 [lo, hi] 后转为整数（避免屏幕外的巨大坐标溢出）
+inline int ClampToInt(float v, int lo, int hi)
+{
+    return static_cast<int>(std::clamp(v, static_cast<float>(lo), static_cast<float>(hi)));
+}
+
+/**
+ * @brief 形状边界向外平移 margin（负数为向内）后与 |y - cy| == dy 的扫描线相交的半宽，不相交返回 -1
+ *
+ * 圆角为圆时结果精确；圆角为椭圆时以半轴同时加 margin 近似等距线。
+ * 圆角半径平移后为负时，区域退化为圆心矩形向内收缩后的直角矩形。
+ */
+float HalfExtent(const RoundedShapeF& s, float dy, float margin)
+{
+    const float ax = s.rx + margin;
+    const float ay = s.ry + margin;
+    if (ax < 0.0f || ay < 0.0f)
+    {
+        const float ex = s.hx + std::min(ax, 0.0f);
+        const float ey = s.hy + std::min(ay, 0.0f);
+        return ex >= 0.0f && dy <= ey ? ex : -1.0f;
+    }
+    const float uy = dy - s.hy;
+    if (uy <= 0.0f)
+    {
+        return s.hx + ax;
+    }
+    if (uy > ay)
+    {
+        return -1.0f;
+    }
+    const float t = uy / ay;
+    return s.hx + ax * std::sqrt(std::max(1.0f - t * t, 0.0f));
+}
+
+/**
+ * @brief 像素中心到形状边界的有向距离（内部为负）
+ *
+ * 圆角为圆时是圆角矩形的精确距离场；圆角为椭圆时取使像素中心恰好落在半轴为 (rx + d, ry + d) 的椭圆上的 d，
+ * 与 HalfExtent 的等距近似一致，边缘像素与整段填充的区间之间不会出现接缝。
+ * 方程左端关于 d 单调递减，根夹在 |q| - max(rx, ry) 与 |q| - min(rx, ry) 之间，二分到 8 位覆盖率所需的精度即可
+ * （牛顿迭代在半轴接近 0 的一侧收敛很慢，不如二分稳定）。
+ */
+float SignedDistance(const RoundedShapeF& s, float px, float py)
+{
+    const float ux = std::abs(px - s.cx) - s.hx;
+    const float uy = std::abs(py - s.cy) - s.hy;
+    const float qx = std::max(ux, 0.0f);
+    const float qy = std::max(uy, 0.0f);
+    const float min_radius = std::min(s.rx, s.ry);
+    if (qx == 0.0f && qy == 0.0f)
+    {
+        return std::max(ux, uy) - min_radius;
+    }
+    const float length = std::sqrt(qx * qx + qy * qy);
+    if (s.rx == s.ry || min_radius <= 0.0f)
+    {
+        return length - min_radius;
+    }
+
+    // 半轴不能缩到 0 以下：更深的内部统一视为 -min_radius
+    float lo = std::max(length - std::max(s.rx, s.ry), -min_radius);
+    float hi = length - min_radius;
+    for (int i = 0; i < kMaxBisections && hi - lo > kDistanceTolerance; ++i)
+    {
+        const float d = 0.5f * (lo + hi);
+        const float ax = s.rx + d;
+        const float ay = s.ry + d;
+        (qx * qx * ay * ay + qy * qy * ax * ax > ax * ax * ay * ay ? lo : hi) = d;
+    }
+    return 0.5f * (lo + hi);
+}
+
+} // namespace
+
+ShapeRasterizer& ShapeRasterizer::ForCurrentThread()
+{
+    thread_local ShapeRasterizer rasterizer;
+    return rasterizer;
+}
+
+void ShapeRasterizer::Fill(PixelsBuffer& buffer, const RoundedShape& shape, uint32_t premultiplied)
+{
+    if (shape.left > shape.right || shape.top > shape.bottom || shape.rx < 0 || shape.ry < 0)
+    {
+        return;
+    }
+    const int rx = std::min(shape.rx, kMaxRadius);
+    const int ry = std::min(shape.ry, kMaxRadius);
+    BuildHalfWidths(rx, ry, _outer_widths);
+
+    const int width = buffer.Width();
+    const BlendMode mode = buffer.GetBlendMode();
+    const int y_begin = std::max(shape.top - ry, buffer.ClipMinY());
+    const int y_end = std::min(shape.bottom + ry, buffer.ClipMaxY() - 1);
+    uint32_t* pixels = buffer.PixelsForRegion(shape.left - rx, y_begin, shape.right + rx + 1, y_end + 1);
+    for (int y = y_begin; y <= y_end; ++y)
+    {
+        const int half = _outer_widths[RowOffset(y, shape.top, shape.bottom)];
+        SolidSpan(buffer, pixels + static_cast<size_t>(y) * width, y, shape.left - half, shape.right + half,
+                  premultiplied, mode);
+    }
+}
+
+void ShapeRasterizer::Stroke(PixelsBuffer& buffer, const RoundedShape& shape, int thickness, uint32_t premultiplied)
+{
+    if (thickness <= 0 || shape.left > shape.right || shape.top > shape.bottom || shape.rx < 0 || shape.ry < 0)
+    {
+        return;
+    }
+    RoundedShape outer = shape;
+    outer.rx = std::min(shape.rx, kMaxRadius);
+    outer.ry = std::min(shape.ry, kMaxRadius);
+
+    // 内形状：圆角半径减去线宽；半径不足时圆心矩形向内收缩，圆角变为直角
+    RoundedShape inner = outer;
+    inner.rx -= thickness;
+    inner.ry -= thickness;
+    if (inner.rx < 0)
+    {
+        inner.left -= inner.rx;
+        inner.right += inner.rx;
+        inner.rx = 0;
+    }
+    if (inner.ry < 0)
+    {
+        inner.top -= inner.ry;
+        inner.bottom += inner.ry;
+        inner.ry = 0;
+    }
+    const bool has_hole = inner.left <= inner.right && inner.top <= inner.bottom;
+
+    BuildHalfWidths(outer.rx, outer.ry, _outer_widths);
+    if (has_hole)
+    {
+        BuildHalfWidths(inner.rx, inner.ry, _inner_widths);
+    }
+
+    const int width = buffer.Width();
+    const BlendMode mode = buffer.GetBlendMode();
+    const int y_begin = std::max(outer.top - outer.ry, buffer.ClipMinY());
+    const int y_end = std::min(outer.bottom + outer.ry, buffer.ClipMaxY() - 1);
+    uint32_t* pixels =
+        buffer.PixelsForRegion(outer.left - outer.rx, y_begin, outer.right + outer.rx + 1, y_end + 1);
+    for (int y = y_begin; y <= y_end; ++y)
+    {
+        uint32_t* row = pixels + static_cast<size_t>(y) * width;
+        const int half = _outer_widths[RowOffset(y, outer.top, outer.bottom)];
+        const int x0 = outer.left - half;
+        const int x1 = outer.right + half;
+        const int inner_dy = RowOffset(y, inner.top, inner.bottom);
+        if (!has_hole || inner_dy > inner.ry)
+        {
+            SolidSpan(buffer, row, y, x0, x1, premultiplied, mode);
+            continue;
+        }
+        const int inner_half = _inner_widths[inner_dy];
+        SolidSpan(buffer, row, y, x0, inner.left - inner_half - 1, premultiplied, mode);
+        SolidSpan(buffer, row, y, inner.right + inner_half + 1, x1, premultiplied, mode);
+    }
+}
+
+void ShapeRasterizer::FillAntialiased(PixelsBuffer& buffer, const RoundedShapeF& shape, uint32_t premultiplied)
+{
+    RasterizeAntialiased(buffer, shape, 0.0f, premultiplied);
+}
+
+void ShapeRasterizer::StrokeAntialiased(PixelsBuffer& buffer, const RoundedShapeF& shape, float thickness,
+                                        uint32_t premultiplied)
+{
+    if (thickness > 0.0f)
+    {
+        RasterizeAntialiased(buffer, shape, thickness, premultiplied);
+    }
+}
+
+void ShapeRasterizer::RasterizeAntialiased(PixelsBuffer& buffer, const RoundedShapeF& shape, float thickness,
+                                           uint32_t premultiplied)
+{
+    if (shape.hx < 0.0f || shape.hy < 0.0f || shape.rx < 0.0f || shape.ry < 0.0f)
+    {
+        return;
+    }
+    const int width = buffer.Width();
+    const BlendMode mode = buffer.GetBlendMode();
+    const bool stroke = thickness > 0.0f;
+
+    // 覆盖率近似为 0.5 - d（d 为像素中心的有向距离）；描边再减去内边界以内的部分
+    auto coverage_at = [&](int x, float py)
+    {
+        const float d = SignedDistance(shape, static_cast<float>(x), py);
+        float c = std::clamp(0.5f - d, 0.0f, 1.0f);
+        if (stroke)
+        {
+            c -= std::clamp(0.5f - d - thickness, 0.0f, 1.0f);
+        }
+        return static_cast<uint8_t>(c * 255.0f + 0.5f);
+    };
+
+    // 闭区间 [x0, x1] 内的边缘像素逐个求覆盖率后混合
+    auto edge_span = [&](uint32_t* row, int y, int x0, int x1, float py)
+    {
+        x0 = std::max(x0, buffer.ClipMinX());
+        x1 = std::min(x1, buffer.ClipMaxX() - 1);
+        if (x0 > x1)
+        {
+            return;
+        }
+        const int count = x1 - x0 + 1;
+        if (_coverage.size() < static_cast<size_t>(count))
+        {
+            _coverage.resize(count);
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            _coverage[i] = coverage_at(x0 + i, py);
+        }
+        buffer.ForEachWritableRun(y, x0, x1 + 1, [&](int begin, int end) {
+            Blender::BlendMaskSpan(row + begin, premultiplied, _coverage.data() + (begin - x0), end - begin, mode);
+        });
+    };
+
+    const float extent = shape.hy + shape.ry + 1.0f;
+    const int y_begin = ClampToInt(std::ceil(shape.cy - extent), buffer.ClipMinY(), buffer.ClipMaxY());
+    const int y_end = ClampToInt(std::floor(shape.cy + extent), buffer.ClipMinY() - 1, buffer.ClipMaxY() - 1);
+    const float cx = shape.cx;
+    const int center = ClampToInt(std::floor(cx), -1, width);
+    const float extent_x = shape.hx + shape.rx + 1.0f;
+    uint32_t* pixels = buffer.PixelsForRegion(ClampToInt(std::floor(cx - extent_x), 0, width), y_begin,
+                                              ClampToInt(std::ceil(cx + extent_x) + 1.0f, 0, width), y_end + 1);
+    for (int y = y_begin; y <= y_end; ++y)
+    {
+        const float py = static_cast<float>(y);
+        const float dy = std::abs(py - shape.cy);
+        // 半宽由外到内：outer 以外覆盖率为 0，(full, outer] 为外边缘，(inner, full] 完全覆盖，
+        // (hole, inner] 为描边的内边缘，hole 以内完全不覆盖
+        const float outer = HalfExtent(shape, dy, 1.0f);
+        if (outer < 0.0f)
+        {
+            continue;
+        }
+        const float full = HalfExtent(shape, dy, -1.0f);
+        const float inner = stroke ? std::min(HalfExtent(shape, dy, 1.0f - thickness), full) : -1.0f;
+        const float hole = stroke ? std::min(HalfExtent(shape, dy, -1.0f - thickness), inner) : -1.0f;
+
+        uint32_t* row = pixels + static_cast<size_t>(y) * width;
+        auto left = [&](float half) { return ClampToInt(std::ceil(cx - half), -1, width); };
+        auto right = [&](float half) { return ClampToInt(std::floor(cx + half), -1, width); };
+
+        // 左半行 x <= center
+        edge_span(row, y, left(outer), std::min(left(full) - 1, center), py);
+        SolidSpan(buffer, row, y, left(full), std::min(left(inner) - 1, center), premultiplied, mode);
+        edge_span(row, y, left(inner), std::min(left(hole) - 1, center), py);
+        // 右半行 x > center
+        edge_span(row, y, std::max(right(hole) + 1, center + 1), right(inner), py);
+        SolidSpan(buffer, row, y, std::max(right(inner) + 1, center + 1), right(full), premultiplied, mode);
+        edge_span(row, y, std::max(right(full) + 1, center + 1), right(outer), py);
+    }
+}
+
+} // namespace pri
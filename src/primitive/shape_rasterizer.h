@@ -0,0 +1,106 @@
+//
+// Created by admin on 2026/2/13.
+//
+
+#ifndef SHAPE_RASTERIZER_H
+#define SHAPE_RASTERIZER_H
+
+#include "../pixels_buffer.h"
+#include <cstdint>
+#include <vector>
+
+namespace pri
+{
+
+/**
+ * @brief 圆角形状（整数几何，无抗锯齿）
+ *
+ * 以 [left, right] x [top, bottom] 为圆角圆心所在的矩形，四个角是半轴为 rx、ry 的四分之一椭圆：
+ *   - 圆 / 椭圆：left == right，top == bottom
+ *   - 圆角矩形：圆心矩形为矩形向内收缩圆角半径
+ * 半径为 r 的方向上覆盖 2r + 1 个像素（圆心所在像素加两侧各 r 个）。
+ */
+struct RoundedShape
+{
+    int left;
+    int top;
+    int right;
+    int bottom;
+    int rx;
+    int ry;
+};
+
+/**
+ * @brief 圆角形状（浮点几何，抗锯齿）
+ *
+ * 中心为 (cx, cy)，圆角圆心所在矩形的半宽 / 半高为 hx、hy，圆角半轴为 rx、ry。
+ * 形状边界与其它图元一致：整数坐标位于像素中心。
+ */
+struct RoundedShapeF
+{
+    float cx;
+    float cy;
+    float hx;
+    float hy;
+    float rx;
+    float ry;
+};
+
+/**
+ * @brief 圆 / 椭圆 / 圆角矩形的扫描线光栅化器
+ *
+ * 不对包围盒逐像素做内部测试，而是逐行求出形状与扫描线相交的区间，再以 span 写入缓冲区：
+ *   - 无抗锯齿：按中点法的整数判别式增量求出四分之一椭圆每行的半宽（只有加减法），
+ *     实心形状每行一个 span，描边为外形状减去内形状，每行一到两个 span
+ *   - 抗锯齿：每行先求出外扩 / 内缩一个像素后的区间，只有两者之间的边缘像素按有向距离计算覆盖率，
+ *     内部一律按不透明 span 填充
+ *
+ * 同一个光栅化器可以反复使用，内部的半宽表和覆盖率缓冲会被复用。
+ */
+class ShapeRasterizer
+{
+  public:
+    // 无抗锯齿时支持的最大半径（整数判别式不溢出）
+    static constexpr int kMaxRadius = 1 << 14;
+
+    ShapeRasterizer() = default;
+
+    /**
+     * @brief 当前线程的光栅化器：图元在 const Draw 中借用它，同一个图元可以在多个线程中同时绘制
+     */
+    static ShapeRasterizer& ForCurrentThread();
+
+    /**
+     * @brief 填充形状
+     * @param premultiplied 颜色（预乘 alpha）
+     */
+    void Fill(PixelsBuffer& buffer, const RoundedShape& shape, uint32_t premultiplied);
+
+    /**
+     * @brief 描边（沿边界向内 thickness 个像素）
+     */
+    void Stroke(PixelsBuffer& buffer, const RoundedShape& shape, int thickness, uint32_t premultiplied);
+
+    /**
+     * @brief 抗锯齿填充
+     */
+    void FillAntialiased(PixelsBuffer& buffer, const RoundedShapeF& shape, uint32_t premultiplied);
+
+    /**
+     * @brief 抗锯齿描边（沿边界向内 thickness 宽）
+     */
+    void StrokeAntialiased(PixelsBuffer& buffer, const RoundedShapeF& shape, float thickness, uint32_t premultiplied);
+
+  private:
+    // 逐行绘制抗锯齿形状，thickness <= 0 表示实心
+    void RasterizeAntialiased(PixelsBuffer& buffer, const RoundedShapeF& shape, float thickness,
+                              uint32_t premultiplied);
+
+    std::vector<int> _outer_widths; // 外形状每行（相对圆角圆心）的半宽
+    std::vector<int> _inner_widths; // 描边时内形状的半宽
+    std::vector<uint8_t> _coverage; // 边缘像素的覆盖率
+};
+
+} // namespace pri
+
+#endif // SHAPE_RASTERIZER_H
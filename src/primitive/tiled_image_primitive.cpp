@@ -0,0 +1,116 @@
+//
+// Created by admin on 2026/2/23.
+//
+
+#include "tiled_image_primitive.h"
+#include "../frame_arena.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace pri
+{
+
+namespace
+{
+
+// 非负余数
+int Wrap(int value, int period)
+{
+    const int r = value % period;
+    return r < 0 ? r + period : r;
+}
+
+// 从源行的第 u 列开始循环复制 count 个像素到 dst，每段是到瓦片边界为止的一次 memcpy
+void CopyTiledRow(const uint32_t* src_row, int period, int u, uint32_t* dst, int count)
+{
+    while (count > 0)
+    {
+        const int run = std::min(period - u, count);
+        std::memcpy(dst, src_row + u, static_cast<size_t>(run) * sizeof(uint32_t));
+        dst += run;
+        count -= run;
+        u = 0;
+    }
+}
+
+} // namespace
+
+void TiledImagePrimitive::Draw(PixelsBuffer& buffer) const
+{
+    const texture::Texture* texture = _texture.get();
+    const uint32_t* pixels = texture ? texture->Pixels() : nullptr;
+    if (pixels == nullptr || !_rect.IsValid())
+    {
+        return;
+    }
+    const int stride = texture->Width();
+
+    math::BoundingBox2i source(0, 0, texture->Width(), texture->Height());
+    if (_source_rect.IsValid())
+    {
+        source = math::BoundingBox2i(std::max(_source_rect.MinX(), 0), std::max(_source_rect.MinY(), 0),
+                                     std::min(_source_rect.MaxX(), texture->Width()),
+                                     std::min(_source_rect.MaxY(), texture->Height()));
+    }
+    const int tile_width = source.Width();
+    const int tile_height = source.Height();
+    if (tile_width <= 0 || tile_height <= 0)
+    {
+        return;
+    }
+
+    // 目标矩形与裁剪矩形的交集
+    const int x0 = std::max(_rect.MinX(), buffer.ClipMinX());
+    const int y0 = std::max(_rect.MinY(), buffer.ClipMinY());
+    const int x1 = std::min(_rect.MaxX(), buffer.ClipMaxX());
+    const int y1 = std::min(_rect.MaxY(), buffer.ClipMaxY());
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+    const int count = x1 - x0;
+    const int u = Wrap(x0 - _rect.MinX() + _offset_x, tile_width);
+    const uint32_t* origin = pixels + static_cast<size_t>(source.MinY()) * stride + source.MinX();
+
+    if (buffer.GetBlendMode() == BlendMode::Replace && buffer.StencilTest() == nullptr)
+    {
+        // 覆盖写入：瓦片段直接复制到帧缓冲的行
+        uint32_t* dst = buffer.PixelsForRegion(x0, y0, x1, y1);
+        for (int y = y0; y < y1; ++y)
+        {
+            const int v = Wrap(y - _rect.MinY() + _offset_y, tile_height);
+            CopyTiledRow(origin + static_cast<size_t>(v) * stride, tile_width, u,
+                         dst + static_cast<size_t>(y) * buffer.Width() + x0, count);
+        }
+        return;
+    }
+
+    // 其余混合模式：先拼出一行，源矩形的同一行在目标中每 tile_height 行重复一次，只在行号变化时重新拼
+    FrameArena::Scope scope(buffer.GetFrameArena());
+    std::vector<uint32_t> fallback;
+    uint32_t* row = ScratchArray(buffer.GetFrameArena(), static_cast<size_t>(count), fallback);
+    int built = -1;
+    for (int y = y0; y < y1; ++y)
+    {
+        const int v = Wrap(y - _rect.MinY() + _offset_y, tile_height);
+        if (v != built)
+        {
+            CopyTiledRow(origin + static_cast<size_t>(v) * stride, tile_width, u, row, count);
+            built = v;
+        }
+        buffer.BlendSpan(x0, y, row, count);
+    }
+}
+
+std::unique_ptr<IPrimitive> TiledImagePrimitive::Clone() const
+{
+    return std::make_unique<TiledImagePrimitive>(*this);
+}
+
+math::BoundingBox2i TiledImagePrimitive::Bounds() const
+{
+    return _rect;
+}
+
+} // namespace pri
@@ -0,0 +1,85 @@
+//
+// Created by admin on 2026/2/23.
+//
+
+#ifndef TILED_IMAGE_PRIMITIVE_H
+#define TILED_IMAGE_PRIMITIVE_H
+
+#include "../math/bounding_box.h"
+#include "primitive.h"
+
+namespace pri
+{
+
+/**
+ * @brief 平铺图元：把纹理的源矩形按原尺寸重复铺满目标矩形
+ *
+ * 逐行绘制：目标行对应源矩形的一行，按瓦片边界切成若干段，每段直接 memcpy 纹理的一整段行，
+ * 不经过纹理的 UV 环绕换算。Replace 模式且没有模板测试时直接复制到帧缓冲，
+ * 其余情况先拼成一行再按混合模式整段混合。纹理像素须为预乘 alpha。
+ */
+class TiledImagePrimitive : public IPrimitive
+{
+  public:
+    TiledImagePrimitive() = default;
+
+    /**
+     * @param texture 纹理
+     * @param rect 目标矩形（半开区间）
+     */
+    TiledImagePrimitive(std::shared_ptr<texture::Texture> texture, const math::BoundingBox2i& rect) : _rect(rect)
+    {
+        _texture = std::move(texture);
+    }
+
+    void Draw(PixelsBuffer& buffer) const override;
+    std::unique_ptr<IPrimitive> Clone() const override;
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
+
+    // 获取/设置属性
+    const math::BoundingBox2i& GetRect() const
+    {
+        return _rect;
+    }
+    void SetRect(const math::BoundingBox2i& rect)
+    {
+        _rect = rect;
+    }
+    /**
+     * @brief 源矩形（纹理坐标，半开区间），无效矩形表示整张纹理
+     */
+    const math::BoundingBox2i& GetSourceRect() const
+    {
+        return _source_rect;
+    }
+    void SetSourceRect(const math::BoundingBox2i& rect)
+    {
+        _source_rect = rect;
+    }
+    /**
+     * @brief 平铺偏移（像素）：目标矩形左上角对应源矩形中的 (x, y)，修改它可以实现滚动
+     */
+    void SetOffset(int x, int y)
+    {
+        _offset_x = x;
+        _offset_y = y;
+    }
+    int GetOffsetX() const
+    {
+        return _offset_x;
+    }
+    int GetOffsetY() const
+    {
+        return _offset_y;
+    }
+
+  private:
+    math::BoundingBox2i _rect{};
+    math::BoundingBox2i _source_rect{};
+    int _offset_x = 0;
+    int _offset_y = 0;
+};
+
+} // namespace pri
+
+#endif // TILED_IMAGE_PRIMITIVE_H
@@ -4,7 +4,11 @@
 
 #include "triangle_primitive.h"
 #include "bounding_box.h"
+#include "frame_arena.h"
 #include "math/vector.h"
+#include "msaa_buffer.h"
+#include <algorithm>
+#include <limits>
 
 namespace pri
 {
@@ -17,12 +21,40 @@ void TrianglePrimitive::Draw(PixelsBuffer& buffer) const
     bbox.AddPoint(math::Point2i(_p1.X(), _p1.Y()));
     bbox.AddPoint(math::Point2i(_p2.X(), _p2.Y()));
 
+    // 裁剪到缓冲区的裁剪矩形
+    const int min_x = std::max(bbox.MinX(), buffer.ClipMinX());
+    const int max_x = std::min(bbox.MaxX(), buffer.ClipMaxX() - 1);
+    const int min_y = std::max(bbox.MinY(), buffer.ClipMinY());
+    const int max_y = std::min(bbox.MaxY(), buffer.ClipMaxY() - 1);
+    if (min_x > max_x || min_y > max_y)
+    {
+        return;
+    }
+
+    if (MsaaBuffer* msaa = buffer.Multisample())
+    {
+        DrawMultisampled(buffer, *msaa);
+        return;
+    }
+
+    // 优化：纯色三角形整行填充
+    const bool solid = !SampledTexture() && (_p0.GetColor() == _p1.GetColor()) && (_p0.GetColor() == _p2.GetColor());
+
+    // 按行扫描，三角形是凸的，每行被覆盖的像素是连续的一段（span）
+    FrameArena::Scope scope(buffer.GetFrameArena());
+    std::vector<uint32_t> fallback;
+    uint32_t* row = solid ? nullptr
+                          : ScratchArray(buffer.GetFrameArena(), static_cast<size_t>(max_x - min_x + 1), fallback);
+
     math::Vector2<int> pv0;
     math::Vector2<int> pv1;
     math::Vector2<int> pv2;
-    for (int i = bbox.MinX(); i <= bbox.MaxX(); ++i)
+    for (int j = min_y; j <= max_y; ++j)
     {
-        for (int j = bbox.MinY(); j <= bbox.MaxY(); ++j)
+        int span_start = -1;
+        int span_end = -1;
+        int row_count = 0;
+        for (int i = min_x; i <= max_x; ++i)
         {
             pv0 = math::Vector2(_p0.X() - i, _p0.Y() - j);
             pv1 = math::Vector2(_p1.X() - i, _p1.Y() - j);
@@ -33,36 +65,220 @@ void TrianglePrimitive::Draw(PixelsBuffer& buffer) const
             auto cross2 = pv2.Cross(pv0);
 
             bool inside = (cross0 >= 0 && cross1 >= 0 && cross2 >= 0) || (cross0 <= 0 && cross1 <= 0 && cross2 <= 0);
-            if (inside)
+            if (!inside)
             {
-                // 计算重心坐标
-                BarycentricCoord barycentric = ComputeBarycentricCoord(i, j);
-
-                Color color;
-                if (_texture)
+                if (span_start >= 0)
                 {
-                    // 使用纹理：插值 UV 坐标，然后采样纹理
-                    math::Point2f uv = InterpolateUV(barycentric);
-                    color = _texture->Sample(uv.X(), uv.Y());
+                    break;
                 }
-                else
+                continue;
+            }
+
+            if (span_start < 0)
+            {
+                span_start = i;
+            }
+            span_end = i;
+
+            if (solid)
+            {
+                continue;
+            }
+
+            // 计算重心坐标并着色
+            row[row_count++] = Shade(ComputeBarycentricCoord(i, j));
+        }
+
+        if (span_start < 0)
+        {
+            continue;
+        }
+        if (solid)
+        {
+            buffer.FillSpan(span_start, j, span_end - span_start + 1, _p0.GetColor());
+        }
+        else
+        {
+            buffer.BlendSpan(span_start, j, row, row_count);
+        }
+    }
+}
+
+void TrianglePrimitive::DrawMultisampled(PixelsBuffer& buffer, MsaaBuffer& msaa) const
+{
+    math::BoundingBox2i bbox;
+    bbox.AddPoint(math::Point2i(_p0.X(), _p0.Y()));
+    bbox.AddPoint(math::Point2i(_p1.X(), _p1.Y()));
+    bbox.AddPoint(math::Point2i(_p2.X(), _p2.Y()));
+
+    const int min_x = std::max(bbox.MinX(), buffer.ClipMinX());
+    const int max_x = std::min(bbox.MaxX(), buffer.ClipMaxX() - 1);
+    const int min_y = std::max(bbox.MinY(), buffer.ClipMinY());
+    const int max_y = std::min(bbox.MaxY(), buffer.ClipMaxY() - 1);
+    if (min_x > max_x || min_y > max_y)
+    {
+        return;
+    }
+
+    // 有向面积决定三角形朝向，退化三角形没有可覆盖的样本
+    const int64_t area = static_cast<int64_t>(_p1.X() - _p0.X()) * (_p2.Y() - _p0.Y()) -
+                         static_cast<int64_t>(_p1.Y() - _p0.Y()) * (_p2.X() - _p0.X());
+    if (area == 0)
+    {
+        return;
+    }
+    const float orient = area > 0 ? 1.0f : -1.0f;
+
+    // 三条边 (p0,p1) (p1,p2) (p2,p0)，边函数 E(p) = (a - p) x (b - p)，
+    // 样本偏移 (ox, oy) 处的边函数 E(p + o) = E(p) + (ay - by) * ox + (bx - ax) * oy
+    const PointPrimitive* vertices[3] = {&_p0, &_p1, &_p2};
+    const int samples = msaa.Samples();
+    float delta[3][MsaaBuffer::kMaxSamples];
+    float margin[3] = {0.0f, 0.0f, 0.0f};
+    for (int k = 0; k < 3; ++k)
+    {
+        const PointPrimitive& a = *vertices[k];
+        const PointPrimitive& b = *vertices[(k + 1) % 3];
+        for (int s = 0; s < samples; ++s)
+        {
+            delta[k][s] = orient * (static_cast<float>(a.Y() - b.Y()) * msaa.SampleOffsetX(s) +
+                                    static_cast<float>(b.X() - a.X()) * msaa.SampleOffsetY(s));
+            margin[k] = std::max(margin[k], std::abs(delta[k][s]));
+        }
+    }
+
+    // 边函数沿 x 方向的增量，以及样本覆盖测试 E > bias 的阈值。
+    // 上-左规则：样本恰好落在边上 (E == 0) 时只归左边和上边所在的三角形，共享边上的样本只被覆盖一次。
+    // 内部在右侧的边为左边，内部在下方的水平边为上边；bias 取 -denorm_min，使 E > bias 等价于 E >= 0
+    float step_x[3];
+    float bias[3];
+    for (int k = 0; k < 3; ++k)
+    {
+        const PointPrimitive& a = *vertices[k];
+        const PointPrimitive& b = *vertices[(k + 1) % 3];
+        step_x[k] = orient * static_cast<float>(a.Y() - b.Y());
+        const float step_y = orient * static_cast<float>(b.X() - a.X());
+        const bool top_left = step_x[k] > 0.0f || (step_x[k] == 0.0f && step_y > 0.0f);
+        bias[k] = top_left ? -std::numeric_limits<float>::denorm_min() : 0.0f;
+    }
+
+    const bool solid = !SampledTexture() && (_p0.GetColor() == _p1.GetColor()) && (_p0.GetColor() == _p2.GetColor());
+    const uint32_t solid_color = Blender::Premultiply(_p0.GetColor().ToUint32());
+    const uint32_t full_mask = msaa.FullMask();
+    FrameArena::Scope scope(buffer.GetFrameArena());
+    std::vector<uint32_t> fallback;
+    uint32_t* row = ScratchArray(buffer.GetFrameArena(), static_cast<size_t>(max_x - min_x + 1), fallback);
+
+    for (int j = min_y; j <= max_y; ++j)
+    {
+        // 完全覆盖且尚无样本的像素合并成 span 直接写入
+        int span_start = -1;
+        int row_count = 0;
+        auto flush = [&]()
+        {
+            if (span_start >= 0)
+            {
+                buffer.BlendSpan(span_start, j, row, row_count);
+                span_start = -1;
+                row_count = 0;
+            }
+        };
+
+        // 本行起点的边函数值，并据此求出不被任何一条边完全排除的像素区间 [first, last]
+        float e[3];
+        int first = min_x;
+        int last = max_x;
+        for (int k = 0; k < 3; ++k)
+        {
+            const PointPrimitive& a = *vertices[k];
+            const PointPrimitive& b = *vertices[(k + 1) % 3];
+            const int64_t cross = static_cast<int64_t>(a.X() - min_x) * (b.Y() - j) -
+                                  static_cast<int64_t>(a.Y() - j) * (b.X() - min_x);
+            e[k] = orient * static_cast<float>(cross);
+            if (step_x[k] > 0.0f)
+            {
+                first = std::max(first, min_x + static_cast<int>(std::ceil((-margin[k] - e[k]) / step_x[k])));
+            }
+            else if (step_x[k] < 0.0f)
+            {
+                last = std::min(last, min_x + static_cast<int>(std::floor((-margin[k] - e[k]) / step_x[k])));
+            }
+            else if (e[k] < -margin[k])
+            {
+                first = max_x + 1;
+            }
+        }
+        if (first > last)
+        {
+            continue;
+        }
+        for (int k = 0; k < 3; ++k)
+        {
+            e[k] += static_cast<float>(first - min_x - 1) * step_x[k];
+        }
+
+        for (int i = first; i <= last; ++i)
+        {
+            bool outside = false;
+            bool inside = true;
+            for (int k = 0; k < 3; ++k)
+            {
+                e[k] += step_x[k];
+                outside = outside || e[k] < -margin[k];
+                inside = inside && e[k] - margin[k] > bias[k];
+            }
+            if (outside)
+            {
+                flush();
+                continue;
+            }
+
+            // 计算覆盖掩码与被覆盖样本的质心（着色位置）
+            uint32_t mask = full_mask;
+            float cx = 0.0f;
+            float cy = 0.0f;
+            if (!inside)
+            {
+                mask = 0;
+                int covered = 0;
+                for (int s = 0; s < samples; ++s)
                 {
-                    // 不使用纹理：插值顶点颜色
-                    if ((_p0.GetColor() == _p1.GetColor()) && (_p0.GetColor() == _p2.GetColor()))
-                    {
-                        // 优化：纯色三角形
-                        color = _p0.GetColor();
-                    }
-                    else
+                    if (e[0] + delta[0][s] > bias[0] && e[1] + delta[1][s] > bias[1] && e[2] + delta[2][s] > bias[2])
                     {
-                        // 插值颜色
-                        color = InterpolateColor(barycentric);
+                        mask |= 1u << s;
+                        cx += msaa.SampleOffsetX(s);
+                        cy += msaa.SampleOffsetY(s);
+                        ++covered;
                     }
                 }
+                if (mask == 0)
+                {
+                    flush();
+                    continue;
+                }
+                cx /= static_cast<float>(covered);
+                cy /= static_cast<float>(covered);
+            }
 
-                buffer.SetPixel(i, j, color);
+            // 每个像素只着色一次
+            const uint32_t color =
+                solid ? solid_color
+                      : Shade(ComputeBarycentricCoord(static_cast<float>(i) + cx, static_cast<float>(j) + cy));
+            if (mask == full_mask && msaa.IsSimple(i, j))
+            {
+                if (span_start < 0)
+                {
+                    span_start = i;
+                }
+                row[row_count++] = color;
+            }
+            else
+            {
+                flush();
+                msaa.WritePixel(buffer, i, j, mask, color);
             }
         }
+        flush();
     }
 }
 
@@ -71,6 +287,17 @@ std::unique_ptr<IPrimitive> TrianglePrimitive::Clone() const
     return std::make_unique<TrianglePrimitive>(*this);
 }
 
+math::BoundingBox2i TrianglePrimitive::Bounds() const
+{
+    const int min_x = std::min({_p0.X(), _p1.X(), _p2.X()});
+    const int min_y = std::min({_p0.Y(), _p1.Y(), _p2.Y()});
+    const int max_x = std::max({_p0.X(), _p1.X(), _p2.X()});
+    const int max_y = std::max({_p0.Y(), _p1.Y(), _p2.Y()});
+    // 多重采样时边缘样本可能落在顶点包围盒外侧的相邻像素中
+    return PixelBounds(static_cast<float>(min_x), static_cast<float>(min_y), static_cast<float>(max_x),
+                       static_cast<float>(max_y), 1.0f);
+}
+
 BarycentricCoord TrianglePrimitive::ComputeBarycentricCoord(int x, int y) const
 {
     // 计算三角形的面积（使用两条边的叉积）
@@ -103,6 +330,46 @@ BarycentricCoord TrianglePrimitive::ComputeBarycentricCoord(int x, int y) const
     return result;
 }
 
+BarycentricCoord TrianglePrimitive::ComputeBarycentricCoord(float x, float y) const
+{
+    const float x0 = static_cast<float>(_p0.X()), y0 = static_cast<float>(_p0.Y());
+    const float x1 = static_cast<float>(_p1.X()), y1 = static_cast<float>(_p1.Y());
+    const float x2 = static_cast<float>(_p2.X()), y2 = static_cast<float>(_p2.Y());
+
+    const float area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+    if (area == 0.0f)
+    {
+        return BarycentricCoord(3);
+    }
+
+    // 有向子三角形面积，点在三角形外时截断负权重后重新归一化
+    float w0 = std::max(((x1 - x) * (y2 - y) - (y1 - y) * (x2 - x)) / area, 0.0f);
+    float w1 = std::max(((x2 - x) * (y0 - y) - (y2 - y) * (x0 - x)) / area, 0.0f);
+    float w2 = std::max(((x0 - x) * (y1 - y) - (y0 - y) * (x1 - x)) / area, 0.0f);
+    const float sum = w0 + w1 + w2;
+    if (sum <= 0.0f)
+    {
+        return BarycentricCoord(3);
+    }
+    return BarycentricCoord{w0 / sum, w1 / sum, w2 / sum};
+}
+
+uint32_t TrianglePrimitive::Shade(const BarycentricCoord& barycentric) const
+{
+    if (const texture::Texture* texture = SampledTexture())
+    {
+        // 使用纹理：插值 UV 坐标，然后采样纹理（纹理已是预乘 alpha）
+        math::Point2f uv = InterpolateUV(barycentric);
+        return texture->Sample(uv.X(), uv.Y()).ToUint32();
+    }
+    if ((_p0.GetColor() == _p1.GetColor()) && (_p0.GetColor() == _p2.GetColor()))
+    {
+        return Blender::Premultiply(_p0.GetColor().ToUint32());
+    }
+    // 不使用纹理：插值顶点颜色
+    return Blender::Premultiply(InterpolateColor(barycentric).ToUint32());
+}
+
 Color TrianglePrimitive::InterpolateColor(const BarycentricCoord& barycentric) const
 {
     if (barycentric.Size() != 3)
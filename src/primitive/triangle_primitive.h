@@ -6,6 +6,7 @@
 #define TRIANGLE_PRIMITIVE_H
 
 #include "color.h"
+#include "msaa_buffer.h"
 #include "point.h"
 #include "point_primitive.h"
 #include "primitive.h"
@@ -47,6 +48,18 @@ class TrianglePrimitive : public IPrimitive
         _texture = texture;
     }
 
+    /**
+     * @brief 带纹理的三角形构造函数（不持有纹理）
+     *
+     * 用于每帧临时构造的图元（如精灵），不增减 shared_ptr 的引用计数，调用方需保证绘制期间纹理有效
+     */
+    TrianglePrimitive(const PointPrimitive& p1, const PointPrimitive& p2, const PointPrimitive& p3,
+                      const texture::Texture* texture, const math::Point2f& uv0, const math::Point2f& uv1,
+                      const math::Point2f& uv2)
+        : _p0(p1), _p1(p2), _p2(p3), _uv0(uv0), _uv1(uv1), _uv2(uv2), _texture_view(texture)
+    {
+    }
+
     /**
      * @brief 绘制图元到指定的像素缓冲区
      * @param buffer 像素缓冲区
@@ -59,6 +72,11 @@ class TrianglePrimitive : public IPrimitive
      */
     virtual std::unique_ptr<IPrimitive> Clone() const override;
 
+    /**
+     * @brief 像素包围盒
+     */
+    [[nodiscard]] math::BoundingBox2i Bounds() const override;
+
     /**
      * @brief 设置纹理和 UV 坐标（重写基类方法，支持 UV）
      */
@@ -71,6 +89,14 @@ class TrianglePrimitive : public IPrimitive
         _uv2 = uv2;
     }
 
+    /**
+     * @brief 设置不持有的纹理（nullptr 表示取消），通过 SetTexture 设置的纹理优先
+     */
+    void SetTextureView(const texture::Texture* texture)
+    {
+        _texture_view = texture;
+    }
+
     /**
      * @brief 设置 UV 坐标
      */
@@ -82,6 +108,14 @@ class TrianglePrimitive : public IPrimitive
     }
 
   private:
+    /**
+     * @brief 实际采样的纹理：持有的纹理优先，其次是不持有的纹理
+     */
+    [[nodiscard]] const texture::Texture* SampledTexture() const
+    {
+        return _texture ? _texture.get() : _texture_view;
+    }
+
     /**
      * @brief 计算点 (x, y) 相对于三角形的重心坐标
      * @param x X 坐标
@@ -90,6 +124,23 @@ class TrianglePrimitive : public IPrimitive
      */
     [[nodiscard]] BarycentricCoord ComputeBarycentricCoord(int x, int y) const;
 
+    /**
+     * @brief 计算任意浮点位置相对于三角形的重心坐标（用于 MSAA 的质心着色）
+     * 位置在三角形外时负权重被截断为 0 后重新归一化
+     */
+    [[nodiscard]] BarycentricCoord ComputeBarycentricCoord(float x, float y) const;
+
+    /**
+     * @brief 按重心坐标着色（纹理采样或顶点颜色插值）
+     * @return 预乘 alpha 的像素值
+     */
+    [[nodiscard]] uint32_t Shade(const BarycentricCoord& barycentric) const;
+
+    /**
+     * @brief MSAA 模式下绘制：按样本计算覆盖掩码，每个像素只着色一次
+     */
+    void DrawMultisampled(PixelsBuffer& buffer, MsaaBuffer& msaa) const;
+
     /**
      * @brief 使用重心坐标插值颜色
      * @param barycentric 重心坐标
@@ -110,6 +161,8 @@ class TrianglePrimitive : public IPrimitive
     math::Point2f _uv0{0, 0}; // 顶点 0 的 UV 坐标
     math::Point2f _uv1{0, 0}; // 顶点 1 的 UV 坐标
     math::Point2f _uv2{0, 0}; // 顶点 2 的 UV 坐标
+
+    const texture::Texture* _texture_view = nullptr; // 不持有的纹理
 };
 
 } // namespace pri
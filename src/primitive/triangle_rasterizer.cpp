@@ -0,0 +1,94 @@
+//
+// Created by admin on 2026/2/10.
+//
+
+#include "triangle_rasterizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace pri
+{
+
+namespace
+{
+
+// 边在扫描线 y 处的 x 坐标（p 为上端点）
+// 共享同一条边的两个三角形按相同顺序计算，结果逐位一致，保证左上规则不留缝隙
+inline float EdgeX(const math::Point2f& p, const math::Point2f& q, float y)
+{
+    return p.X() + (y - p.Y()) * (q.X() - p.X()) / (q.Y() - p.Y());
+}
+
+} // namespace
+
+void TriangleRasterizer::FillTriangle(PixelsBuffer& buffer, const math::Point2f& a, const math::Point2f& b,
+                                      const math::Point2f& c, uint32_t premultiplied)
+{
+    // 按 y 排序：v0 在最上，v2 在最下
+    const math::Point2f* v0 = &a;
+    const math::Point2f* v1 = &b;
+    const math::Point2f* v2 = &c;
+    if (v1->Y() < v0->Y())
+    {
+        std::swap(v0, v1);
+    }
+    if (v2->Y() < v1->Y())
+    {
+        std::swap(v1, v2);
+    }
+    if (v1->Y() < v0->Y())
+    {
+        std::swap(v0, v1);
+    }
+
+    const float cross = (v2->X() - v0->X()) * (v1->Y() - v0->Y()) - (v2->Y() - v0->Y()) * (v1->X() - v0->X());
+    if (cross == 0.0f || !std::isfinite(cross))
+    {
+        return;
+    }
+    // cross > 0 时中间顶点在长边左侧，即两条短边构成左边界
+    const bool mid_left = cross > 0.0f;
+
+    // 先在浮点域裁剪到裁剪矩形再取整，避免屏幕外的巨大坐标溢出 int
+    const int width = buffer.Width();
+    const float min_x = static_cast<float>(buffer.ClipMinX());
+    const float min_y = static_cast<float>(buffer.ClipMinY());
+    const float max_x = static_cast<float>(buffer.ClipMaxX());
+    const float max_y = static_cast<float>(buffer.ClipMaxY());
+    const int y_begin = static_cast<int>(std::ceil(std::clamp(v0->Y(), min_y, max_y)));
+    const int y_end = static_cast<int>(std::ceil(std::clamp(v2->Y(), min_y, max_y)));
+    const float vertex_min_x = std::min({v0->X(), v1->X(), v2->X()});
+    const float vertex_max_x = std::max({v0->X(), v1->X(), v2->X()});
+    const int region_x0 = static_cast<int>(std::floor(std::clamp(vertex_min_x, min_x, max_x)));
+    const int region_x1 = static_cast<int>(std::ceil(std::clamp(vertex_max_x, min_x, max_x))) + 1;
+    const BlendMode mode = buffer.GetBlendMode();
+    uint32_t* pixels = buffer.PixelsForRegion(region_x0, y_begin, region_x1, y_end);
+
+    for (int y = y_begin; y < y_end; ++y)
+    {
+        const float fy = static_cast<float>(y);
+        const float x_long = EdgeX(*v0, *v2, fy);
+        const float x_short = fy < v1->Y() ? EdgeX(*v0, *v1, fy) : EdgeX(*v1, *v2, fy);
+        const float x_left = mid_left ? x_short : x_long;
+        const float x_right = mid_left ? x_long : x_short;
+
+        // 像素中心满足 x_left <= x < x_right 时被覆盖
+        const int x_begin = static_cast<int>(std::ceil(std::clamp(x_left, min_x, max_x)));
+        const int x_end = static_cast<int>(std::ceil(std::clamp(x_right, min_x, max_x)));
+        uint32_t* row = pixels + static_cast<size_t>(y) * width;
+        buffer.ForEachWritableRun(y, x_begin, x_end, [&](int begin, int end) {
+            Blender::BlendSolidSpan(row + begin, premultiplied, end - begin, mode);
+        });
+    }
+}
+
+void TriangleRasterizer::FillStrip(PixelsBuffer& buffer, const math::Point2f* vertices, size_t count,
+                                   uint32_t premultiplied)
+{
+    for (size_t i = 2; i < count; ++i)
+    {
+        FillTriangle(buffer, vertices[i - 2], vertices[i - 1], vertices[i], premultiplied);
+    }
+}
+
+} // namespace pri
@@ -0,0 +1,46 @@
+//
+// Created by admin on 2026/2/10.
+//
+
+#ifndef TRIANGLE_RASTERIZER_H
+#define TRIANGLE_RASTERIZER_H
+
+#include "../math/point.h"
+#include "../pixels_buffer.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace pri
+{
+
+/**
+ * @brief 纯色三角形批量光栅化器（浮点顶点，扫描线 span 填充）
+ *
+ * 采用左上填充规则：像素中心（整数坐标）恰好落在上边或左边时才属于三角形，
+ * 因此共享一条边的相邻三角形（如三角形带）既不会漏像素也不会重复混合。
+ * 不做抗锯齿，也不写入 MSAA 样本缓冲区。
+ */
+class TriangleRasterizer
+{
+  public:
+    TriangleRasterizer() = delete;
+
+    /**
+     * @brief 填充一个三角形（顶点顺序任意）
+     * @param premultiplied 颜色（预乘 alpha）
+     */
+    static void FillTriangle(PixelsBuffer& buffer, const math::Point2f& a, const math::Point2f& b,
+                             const math::Point2f& c, uint32_t premultiplied);
+
+    /**
+     * @brief 填充一个三角形带：第 i 个三角形由顶点 i, i + 1, i + 2 组成，面积为 0 的三角形被跳过
+     * @param vertices 顶点数组
+     * @param count 顶点个数
+     * @param premultiplied 颜色（预乘 alpha）
+     */
+    static void FillStrip(PixelsBuffer& buffer, const math::Point2f* vertices, size_t count, uint32_t premultiplied);
+};
+
+} // namespace pri
+
+#endif // TRIANGLE_RASTERIZER_H
@@ -0,0 +1,29 @@
+//
+// Created by admin on 2026/2/20.
+//
+
+#include "render_target.h"
+#include <algorithm>
+
+std::shared_ptr<RenderTarget> RenderTargetPool::Acquire(int width, int height)
+{
+    for (const auto& target : _targets)
+    {
+        if (IsFree(target) && target->Width() == width && target->Height() == height)
+        {
+            return target;
+        }
+    }
+    _targets.push_back(std::make_shared<RenderTarget>(width, height));
+    return _targets.back();
+}
+
+void RenderTargetPool::ReleaseUnused()
+{
+    _targets.erase(std::remove_if(_targets.begin(), _targets.end(), &RenderTargetPool::IsFree), _targets.end());
+}
+
+size_t RenderTargetPool::FreeCount() const
+{
+    return static_cast<size_t>(std::count_if(_targets.begin(), _targets.end(), &RenderTargetPool::IsFree));
+}
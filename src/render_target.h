@@ -0,0 +1,100 @@
+//
+// Created by admin on 2026/2/20.
+//
+
+#ifndef RENDER_TARGET_H
+#define RENDER_TARGET_H
+
+#include "pixels_buffer.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 离屏渲染目标
+ *
+ * 持有一个像素缓冲区（RGBA8888，预乘 alpha）。通过 GraphicsRenderer::PushRenderTarget 绑定后，
+ * 图元绘制到这里而不是屏幕；绘制结果可以：
+ *   - 直接作为 texture::Texture 的像素来源（纹理引用本目标，不复制像素）
+ *   - 由 GraphicsRenderer::DrawRenderTarget / Compositor 按不透明度和裁剪矩形合成到其它目标
+ */
+class RenderTarget
+{
+  public:
+    RenderTarget(int width, int height) : _buffer(width, height) {}
+
+    RenderTarget(const RenderTarget&) = delete;
+    RenderTarget& operator=(const RenderTarget&) = delete;
+
+    int Width() const
+    {
+        return _buffer.Width();
+    }
+    int Height() const
+    {
+        return _buffer.Height();
+    }
+
+    PixelsBuffer& Buffer()
+    {
+        return _buffer;
+    }
+    const PixelsBuffer& Buffer() const
+    {
+        return _buffer;
+    }
+
+  private:
+    PixelsBuffer _buffer;
+};
+
+/**
+ * @brief 渲染目标池
+ *
+ * 按尺寸复用离屏渲染目标，避免每帧分配和释放整块像素内存：
+ *   - Acquire 优先返回尺寸相同的空闲目标，没有时才新建
+ *   - 池外没有任何 shared_ptr 引用（包括引用它的纹理）的目标即为空闲，不需要显式归还
+ *
+ * 复用的目标保留上次使用时的像素，使用前需要自行清除。池只能在一个线程中使用。
+ */
+class RenderTargetPool
+{
+  public:
+    RenderTargetPool() = default;
+
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    /**
+     * @brief 取得一个 width x height 的渲染目标
+     */
+    std::shared_ptr<RenderTarget> Acquire(int width, int height);
+
+    /**
+     * @brief 释放当前空闲的全部目标
+     */
+    void ReleaseUnused();
+
+    /**
+     * @brief 池中目标总数（包括正在使用的）
+     */
+    [[nodiscard]] size_t Size() const
+    {
+        return _targets.size();
+    }
+
+    /**
+     * @brief 空闲目标数
+     */
+    [[nodiscard]] size_t FreeCount() const;
+
+  private:
+    static bool IsFree(const std::shared_ptr<RenderTarget>& target)
+    {
+        return target.use_count() == 1;
+    }
+
+    std::vector<std::shared_ptr<RenderTarget>> _targets;
+};
+
+#endif // RENDER_TARGET_H
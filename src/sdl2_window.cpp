@@ -4,6 +4,7 @@
 
 #include "sdl2_window.h"
 
+#include <array>
 #include <iostream>
 #include <chrono>
 
@@ -36,6 +37,10 @@ Sdl2Window::Sdl2Window(const std::string& title, const int32_t width, const int3
     // 初始化像素缓冲区和图形渲染器
     _pixels_buffer = std::make_unique<PixelsBuffer>(_width, _height);
     _graphics_renderer = std::make_unique<GraphicsRenderer>(*_pixels_buffer);
+    _post_process = std::make_unique<PostProcessor>();
+    _jobs = std::make_unique<parallel::JobSystem>();
+    // 命令列表按任务编号录制（见 GraphicsRenderer::CommandList），默认每个线程对应一份任务
+    _graphics_renderer->SetCommandListCount(static_cast<size_t>(_jobs->ThreadCount()));
     // 清除为黑色背景
     _graphics_renderer->Clear(Color(0, 0, 0, 255)); // 不透明黑色
 
@@ -75,35 +80,158 @@ void Sdl2Window::EventLoop()
             }
         }
 
-        if (_on_frame)
+        if (_on_frame || _on_frame_jobs)
         {
             Uint64 t_now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
             float dt = static_cast<float>(t_now - t_prev);
             t_prev = t_now;
-            _on_frame(*_graphics_renderer, dt);
+            if (_on_frame)
+            {
+                _on_frame(*_graphics_renderer, dt);
+            }
+            else
+            {
+                _on_frame_jobs(*_graphics_renderer, *_jobs, dt);
+            }
+        }
+
+        // 等待本帧的作业全部完成（主线程参与执行），并回收作业
+        _jobs->EndFrame();
+
+        // 帧回调中记录的命令排序合批后统一绘制
+        _graphics_renderer->SubmitCommands();
+
+        // MSAA 边缘样本在呈现前解析
+        _graphics_renderer->Resolve();
+        // 后处理写入管线自己的目标，像素缓冲区保留给下一帧的损坏区域重绘
+        Draw(_post_process->Apply(*_pixels_buffer));
+
+        // 回收本帧的临时分配，稳定状态下每帧不应再向堆申请内存
+        _graphics_renderer->EndFrame();
+        const FrameArena::Stats& stats = _graphics_renderer->LastFrameStats();
+        if (stats.block_allocations > 0 || stats.heap_allocations > 0)
+        {
+            std::cerr << "Frame arena: " << stats.bytes_used << " bytes used, " << stats.block_allocations
+                      << " block allocations, " << stats.heap_allocations << " heap allocations." << std::endl;
         }
+    }
+}
+
+bool Sdl2Window::SetPresentFormat(PixelFormat format)
+{
+    if (format != PixelFormat::RGBA8888 && format != PixelFormat::RGB565)
+    {
+        return false;
+    }
+    if (format == _present_format || _renderer == nullptr)
+    {
+        return format == _present_format;
+    }
 
-        Draw();
+    const Uint32 sdl_format = format == PixelFormat::RGB565 ? SDL_PIXELFORMAT_RGB565 : SDL_PIXELFORMAT_RGBA8888;
+    SDL_Texture* texture = SDL_CreateTexture(_renderer, sdl_format, SDL_TEXTUREACCESS_STREAMING, _width, _height);
+    if (texture == nullptr)
+    {
+        std::cerr << "Failed to create SDL2 texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    if (_texture != nullptr)
+    {
+        SDL_DestroyTexture(_texture);
     }
+    _texture = texture;
+    _present_format = format;
+    // 新纹理的内容未定义，下一帧需要整体上传
+    _graphics_renderer->AddDamage(math::BoundingBox2i(0, 0, _width, _height));
+    return true;
 }
 
-void Sdl2Window::Draw() const
+void Sdl2Window::Draw(const PixelsBuffer& frame) const
 {
     if (_texture == nullptr || _renderer == nullptr || _window == nullptr || _pixels_buffer == nullptr)
     {
         return;
     }
 
-    // 将像素缓冲区复制到纹理
+    // 将像素缓冲区复制到纹理：开启损坏区域跟踪时只复制损坏的矩形，
+    // 后处理的结果每个像素都可能变化，整体上传
+    std::array<SDL_Rect, DamageTracker::kMaxRects> rects{};
+    int rect_count = 0;
+    if (_graphics_renderer->IsDamageTracking() && &frame == _pixels_buffer.get())
+    {
+        for (const auto& box : _graphics_renderer->Damage().Rects())
+        {
+            rects[rect_count++] = SDL_Rect{box.MinX(), box.MinY(), box.Width(), box.Height()};
+        }
+        for (int i = 0; i < rect_count; ++i)
+        {
+            Upload(frame, &rects[i]);
+        }
+    }
+    else
+    {
+        Upload(frame, nullptr);
+    }
+
+    // 渲染纹理到屏幕
+    SDL_SetRenderDrawColor(_renderer, 0, 0, 0, 255);
+    SDL_RenderClear(_renderer);
+    SDL_RenderCopy(_renderer, _texture, nullptr, nullptr);
+    if (_damage_overlay && rect_count > 0)
+    {
+        SDL_SetRenderDrawColor(_renderer, 255, 0, 255, 255);
+        SDL_RenderDrawRects(_renderer, rects.data(), rect_count);
+    }
+    SDL_RenderPresent(_renderer);
+}
+
+void Sdl2Window::Upload(const PixelsBuffer& frame, const SDL_Rect* rect) const
+{
+    const int src_pitch = frame.Pitch();
+    if (_present_format != PixelFormat::RGBA8888)
+    {
+        // 锁定（子）矩形，逐行转换后直接写入纹理内存
+        void* texture_pixels{nullptr};
+        int texture_pitch;
+        if (SDL_LockTexture(_texture, rect, &texture_pixels, &texture_pitch) != 0)
+        {
+            return;
+        }
+        const int x = rect != nullptr ? rect->x : 0;
+        const int y = rect != nullptr ? rect->y : 0;
+        const int w = rect != nullptr ? rect->w : frame.Width();
+        const int h = rect != nullptr ? rect->h : frame.Height();
+        const uint32_t* src = frame.Pixels() + static_cast<size_t>(y) * frame.Width() + x;
+        uint8_t* dst = static_cast<uint8_t*>(texture_pixels);
+        for (int row = 0; row < h; ++row)
+        {
+            PixelConverter::FromRGBA8888(_present_format, src, dst, static_cast<size_t>(w));
+            src += frame.Width();
+            dst += texture_pitch;
+        }
+        SDL_UnlockTexture(_texture);
+        return;
+    }
+
+    if (rect != nullptr)
+    {
+        // 子矩形直接从像素缓冲区按行距更新，只传输矩形内的像素
+        const uint32_t* src = frame.Pixels() + static_cast<size_t>(rect->y) * frame.Width() + rect->x;
+        SDL_UpdateTexture(_texture, rect, src, src_pitch);
+        return;
+    }
+
     void* texture_pixels{nullptr};
     int texture_pitch;
-    SDL_LockTexture(_texture, nullptr, &texture_pixels, &texture_pitch);
+    if (SDL_LockTexture(_texture, nullptr, &texture_pixels, &texture_pitch) != 0)
+    {
+        return;
+    }
 
     // 逐行复制，处理可能的pitch对齐差异
-    const uint8_t* src_pixels = reinterpret_cast<const uint8_t*>(_pixels_buffer->Pixels());
+    const uint8_t* src_pixels = reinterpret_cast<const uint8_t*>(frame.Pixels());
     uint8_t* dst_pixels = reinterpret_cast<uint8_t*>(texture_pixels);
-    const int src_pitch = _pixels_buffer->Pitch();
-    const int height = _pixels_buffer->Height();
+    const int height = frame.Height();
 
     for (int y = 0; y < height; ++y)
     {
@@ -113,12 +241,6 @@ void Sdl2Window::Draw() const
     }
 
     SDL_UnlockTexture(_texture);
-
-    // 渲染纹理到屏幕
-    SDL_SetRenderDrawColor(_renderer, 0, 0, 0, 255);
-    SDL_RenderClear(_renderer);
-    SDL_RenderCopy(_renderer, _texture, nullptr, nullptr);
-    SDL_RenderPresent(_renderer);
 }
 
 SDL_HitTestResult Sdl2Window::HitTestCallback(SDL_Window* window, const SDL_Point* area, void* data)
@@ -5,7 +5,10 @@
 #ifndef SDL2WINDOW_H
 #define SDL2WINDOW_H
 #include "graphics_renderer.h"
+#include "job_system.h"
+#include "pixel_format.h"
 #include "pixels_buffer.h"
+#include "post_process.h"
 #include <SDL.h>
 #include <functional>
 #include <memory>
@@ -44,13 +47,69 @@ class Sdl2Window
     void SetFrameCallback(FrameCallback cb)
     {
         _on_frame = std::move(cb);
+        _on_frame_jobs = nullptr;
+    }
+
+    /**
+     * @brief 带作业系统的每帧回调：回调中可以把更新、剔除、光栅化等工作组织成作业依赖图，
+     * 回调返回后事件循环会等待本帧提交的所有作业完成，再提交绘制命令并呈现。
+     * 参数：(GraphicsRenderer& renderer, parallel::JobSystem& jobs, float dt_sec)
+     */
+    using JobFrameCallback = std::function<void(GraphicsRenderer&, parallel::JobSystem&, float dt_sec)>;
+
+    void SetFrameCallback(JobFrameCallback cb)
+    {
+        _on_frame_jobs = std::move(cb);
+        _on_frame = nullptr;
+    }
+
+    /**
+     * @brief 窗口拥有的作业系统（主线程参与执行作业）
+     */
+    parallel::JobSystem& Jobs()
+    {
+        return *_jobs;
+    }
+
+    /**
+     * @brief 显示损坏区域：呈现时在屏幕上描出本帧上传的矩形（不写入像素缓冲区）。
+     * 需要先通过 graphicsRenderer().SetDamageTracking(true) 开启跟踪
+     */
+    void SetDamageOverlay(bool enabled)
+    {
+        _damage_overlay = enabled;
+    }
+
+    /**
+     * @brief 设置呈现格式（默认 RGBA8888）。RGB565 时纹理为 16 位，上传时由转换内核直接把像素缓冲区
+     * 转换写入纹理，上传带宽减半，适合带宽受限的显示设备。只支持 RGBA8888 和 RGB565，其它格式返回 false
+     */
+    bool SetPresentFormat(PixelFormat format);
+
+    [[nodiscard]] PixelFormat PresentFormat() const
+    {
+        return _present_format;
+    }
+
+    /**
+     * @brief 后处理管线：提交绘制命令并解析 MSAA 之后、呈现之前执行。
+     * 呈现的是处理结果，像素缓冲区本身保持不变；有启用的 pass 时每帧整体上传
+     */
+    PostProcessor& PostProcess()
+    {
+        return *_post_process;
     }
 
   private:
     /**
-     * @brief
+     * @brief 上传 frame 并呈现：frame 是像素缓冲区本身且开启损坏区域跟踪时只上传损坏的矩形
      */
-    void Draw() const;
+    void Draw(const PixelsBuffer& frame) const;
+
+    /**
+     * @brief 把 frame 中的矩形区域更新到纹理，rect 为空时复制整个缓冲区
+     */
+    void Upload(const PixelsBuffer& frame, const SDL_Rect* rect) const;
 
     /**
      * @brief 窗口命中测试回调（用于窗口拖动）
@@ -73,8 +132,15 @@ class Sdl2Window
     // 像素缓冲区和图形渲染器
     std::unique_ptr<PixelsBuffer> _pixels_buffer;
     std::unique_ptr<GraphicsRenderer> _graphics_renderer;
+    std::unique_ptr<PostProcessor> _post_process;
 
     FrameCallback _on_frame;
+    JobFrameCallback _on_frame_jobs;
+    bool _damage_overlay = false;
+    PixelFormat _present_format = PixelFormat::RGBA8888;
+
+    // 作业系统（主线程为 0 号线程），事件循环每帧结束时回收作业
+    std::unique_ptr<parallel::JobSystem> _jobs;
 };
 
 #endif // SDL2WINDOW_H
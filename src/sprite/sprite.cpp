@@ -50,12 +50,13 @@ void Sprite::Draw() const
     float u1 = _uv_offset.X() + 1.0f;
     float v1 = _uv_offset.Y() + 1.0f;
 
+    // 临时三角形只借用精灵持有的纹理，不增减引用计数
     // 三角形 1: p0 -> p1 -> p2 (左上三角形)
-    pri::TrianglePrimitive triangle1({x0, y0}, {x1, y1}, {x2, y2}, _texture, math::Point2f(u0, v0),
+    pri::TrianglePrimitive triangle1({x0, y0}, {x1, y1}, {x2, y2}, _texture.get(), math::Point2f(u0, v0),
                                      math::Point2f(u1, v0), math::Point2f(u0, v1));
 
     // 三角形 2: p1 -> p3 -> p2 (右下三角形)
-    pri::TrianglePrimitive triangle2({x1, y1}, {x3, y3}, {x2, y2}, _texture, math::Point2f(u1, v0),
+    pri::TrianglePrimitive triangle2({x1, y1}, {x3, y3}, {x2, y2}, _texture.get(), math::Point2f(u1, v0),
                                      math::Point2f(u1, v1), math::Point2f(u0, v1));
 
     _renderer.Draw(triangle1);
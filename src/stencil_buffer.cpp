@@ -0,0 +1,129 @@
+//
+// Created by admin on 2026/2/21.
+//
+
+#include "stencil_buffer.h"
+#include "blender.h"
+#include "pixels_buffer.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STENCIL_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define STENCIL_USE_SSE2 0
+#endif
+
+namespace
+{
+
+uint8_t ApplyOp(uint8_t current, uint8_t value, StencilOp op)
+{
+    switch (op)
+    {
+    case StencilOp::Increment:
+        return current == 255 ? current : static_cast<uint8_t>(current + 1);
+    case StencilOp::Decrement:
+        return current == 0 ? current : static_cast<uint8_t>(current - 1);
+    case StencilOp::Replace:
+    default:
+        return value;
+    }
+}
+
+} // namespace
+
+StencilBuffer::StencilBuffer(int width, int height) : _width(width), _height(height)
+{
+    assert(width > 0 && height > 0);
+    _values.resize(static_cast<size_t>(width) * static_cast<size_t>(height), 0);
+}
+
+void StencilBuffer::Clear(uint8_t value)
+{
+    std::fill(_values.begin(), _values.end(), value);
+}
+
+void StencilBuffer::FillRect(int x0, int y0, int x1, int y1, uint8_t value, StencilOp op)
+{
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, _width);
+    y1 = std::min(y1, _height);
+    for (int y = y0; y < y1; ++y)
+    {
+        uint8_t* row = Row(y);
+        if (op == StencilOp::Replace)
+        {
+            std::fill(row + x0, row + x1, value);
+            continue;
+        }
+        for (int x = x0; x < x1; ++x)
+        {
+            row[x] = ApplyOp(row[x], value, op);
+        }
+    }
+}
+
+void StencilBuffer::WriteMask(const PixelsBuffer& mask, const math::BoundingBox2i& region, uint8_t value,
+                              StencilOp op)
+{
+    assert(mask.Width() == _width && mask.Height() == _height);
+    const int x0 = std::max(region.MinX(), 0);
+    const int y0 = std::max(region.MinY(), 0);
+    const int x1 = std::min(region.MaxX(), _width);
+    const int y1 = std::min(region.MaxY(), _height);
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+    const uint32_t* pixels = mask.Pixels();
+    for (int y = y0; y < y1; ++y)
+    {
+        const uint32_t* src = pixels + static_cast<size_t>(y) * _width;
+        uint8_t* row = Row(y);
+        for (int x = x0; x < x1; ++x)
+        {
+            if (Blender::AlphaOf(src[x]) >= 128)
+            {
+                row[x] = ApplyOp(row[x], value, op);
+            }
+        }
+    }
+}
+
+int StencilBuffer::Run(int x, int y, int count, bool passing) const
+{
+    if (_func == StencilFunc::Always)
+    {
+        return passing ? count : 0;
+    }
+    const uint8_t* values = Row(y) + x;
+    // Equal 时 "通过" 即 "等于参考值"，NotEqual 时相反
+    const bool want_equal = passing == (_func == StencilFunc::Equal);
+    int i = 0;
+#if STENCIL_USE_SSE2
+    const __m128i reference = _mm_set1_epi8(static_cast<char>(_reference));
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        uint32_t equal = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, reference)));
+        // 找到第一个不满足条件的字节
+        const uint32_t stop = (want_equal ? ~equal : equal) & 0xFFFFu;
+        if (stop != 0)
+        {
+            return i + std::countr_zero(stop);
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        if ((values[i] == _reference) != want_equal)
+        {
+            break;
+        }
+    }
+    return i;
+}
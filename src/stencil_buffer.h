@@ -0,0 +1,177 @@
+//
+// Created by admin on 2026/2/21.
+//
+
+#ifndef STENCIL_BUFFER_H
+#define STENCIL_BUFFER_H
+
+#include "math/bounding_box.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class PixelsBuffer;
+
+/**
+ * @brief 模板测试函数：像素的模板值与参考值比较，通过时才写入颜色
+ */
+enum class StencilFunc
+{
+    Always,  // 不测试
+    Equal,   // 模板值 == 参考值
+    NotEqual // 模板值 != 参考值
+};
+
+/**
+ * @brief 写入模板值的方式
+ */
+enum class StencilOp
+{
+    Replace,   // 写入参考值
+    Increment, // 加 1（饱和到 255），用于嵌套遮罩
+    Decrement  // 减 1（饱和到 0）
+};
+
+/**
+ * @brief 8 位模板平面
+ * 职责：
+ *   1. 保存每个像素的模板值，由 GraphicsRenderer::DrawToStencil 把任意图元的形状写进来
+ *   2. 作为 PixelsBuffer 的非拥有附件参与绘制：开启测试后，所有写像素的路径按行把扫描线拆分成
+ *      "连续通过" 的片段再混合，片段查找在支持 SSE2 时一次比较 16 个模板值
+ *
+ * 测试不通过的像素完全不写。绘制时只读取模板值，多线程光栅化可以共享同一个平面。
+ */
+class StencilBuffer
+{
+  public:
+    StencilBuffer(int width, int height);
+
+    int Width() const
+    {
+        return _width;
+    }
+    int Height() const
+    {
+        return _height;
+    }
+
+    uint8_t* Row(int y)
+    {
+        return _values.data() + static_cast<size_t>(y) * _width;
+    }
+    const uint8_t* Row(int y) const
+    {
+        return _values.data() + static_cast<size_t>(y) * _width;
+    }
+
+    uint8_t Value(int x, int y) const
+    {
+        return Row(y)[x];
+    }
+
+    /**
+     * @brief 把整个平面设为 value
+     */
+    void Clear(uint8_t value = 0);
+
+    /**
+     * @brief 按 op 修改矩形区域 [x0, x1) x [y0, y1) 的模板值（自动裁剪到平面）
+     */
+    void FillRect(int x0, int y0, int x1, int y1, uint8_t value, StencilOp op = StencilOp::Replace);
+
+    /**
+     * @brief 按 op 修改 region 内 mask 中 alpha >= 128 的像素的模板值
+     * @param mask 与平面同尺寸的像素缓冲区，只读取 region 内的像素
+     */
+    void WriteMask(const PixelsBuffer& mask, const math::BoundingBox2i& region, uint8_t value,
+                   StencilOp op = StencilOp::Replace);
+
+    /**
+     * @brief 设置测试函数和参考值（Always 表示关闭测试）
+     */
+    void SetTest(StencilFunc func, uint8_t reference)
+    {
+        _func = func;
+        _reference = reference;
+    }
+
+    StencilFunc Func() const
+    {
+        return _func;
+    }
+
+    uint8_t Reference() const
+    {
+        return _reference;
+    }
+
+    bool IsTestEnabled() const
+    {
+        return _func != StencilFunc::Always;
+    }
+
+    /**
+     * @brief 像素 (x, y) 是否通过测试（坐标必须在平面内）
+     */
+    bool Test(int x, int y) const
+    {
+        const uint8_t value = Value(x, y);
+        switch (_func)
+        {
+        case StencilFunc::Equal:
+            return value == _reference;
+        case StencilFunc::NotEqual:
+            return value != _reference;
+        case StencilFunc::Always:
+        default:
+            return true;
+        }
+    }
+
+    /**
+     * @brief 从 (x, y) 开始连续通过测试的像素数（最多 count 个）
+     */
+    int PassingRun(int x, int y, int count) const
+    {
+        return Run(x, y, count, true);
+    }
+
+    /**
+     * @brief 从 (x, y) 开始连续不通过测试的像素数（最多 count 个）
+     */
+    int FailingRun(int x, int y, int count) const
+    {
+        return Run(x, y, count, false);
+    }
+
+    /**
+     * @brief 把第 y 行的 [x, x + count) 拆分成通过测试的片段，对每个片段调用 fn(x_begin, length)
+     */
+    template <typename Fn> void ForEachPassingRun(int x, int y, int count, Fn&& fn) const
+    {
+        const int end = x + count;
+        while (x < end)
+        {
+            x += FailingRun(x, y, end - x);
+            if (x >= end)
+            {
+                break;
+            }
+            const int run = PassingRun(x, y, end - x);
+            fn(x, run);
+            x += run;
+        }
+    }
+
+  private:
+    // 从 (x, y) 开始测试结果连续等于 passing 的像素数
+    int Run(int x, int y, int count, bool passing) const;
+
+    int _width;
+    int _height;
+    std::vector<uint8_t> _values;
+    StencilFunc _func = StencilFunc::Always;
+    uint8_t _reference = 0;
+};
+
+#endif // STENCIL_BUFFER_H
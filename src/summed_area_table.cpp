@@ -0,0 +1,246 @@
+//
+// Created by admin on 2026/2/23.
+//
+
+#include "summed_area_table.h"
+#include "parallel.h"
+#include <algorithm>
+
+#if COLOR_LITTLE_ENDIAN && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SUMMED_AREA_TABLE_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define SUMMED_AREA_TABLE_USE_SSE2 0
+#endif
+
+namespace
+{
+
+// 像素数低于该值时不并行
+constexpr size_t kParallelThreshold = size_t{1} << 16;
+
+// out[4x + c] = 第 0..x 个像素通道 c 的和
+template <typename Sum> void PrefixRow(const uint32_t* pixels, Sum* out, int count)
+{
+#if SUMMED_AREA_TABLE_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    if constexpr (sizeof(Sum) == 4)
+    {
+        __m128i acc = zero;
+        for (int x = 0; x < count; ++x)
+        {
+            const __m128i v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(pixels[x])), zero);
+            acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * x), acc);
+        }
+    }
+    else
+    {
+        __m128i acc_lo = zero;
+        __m128i acc_hi = zero;
+        for (int x = 0; x < count; ++x)
+        {
+            __m128i v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(pixels[x])), zero);
+            v = _mm_unpacklo_epi16(v, zero);
+            acc_lo = _mm_add_epi64(acc_lo, _mm_unpacklo_epi32(v, zero));
+            acc_hi = _mm_add_epi64(acc_hi, _mm_unpackhi_epi32(v, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * x), acc_lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * x + 2), acc_hi);
+        }
+    }
+#else
+    Sum acc[4] = {0, 0, 0, 0};
+    for (int x = 0; x < count; ++x)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            acc[c] += static_cast<Sum>((pixels[x] >> (c * 8)) & 0xFFu);
+            out[4 * x + c] = acc[c];
+        }
+    }
+#endif
+}
+
+// dst[i] += src[i]
+template <typename Sum> void AddRow(Sum* dst, const Sum* src, size_t count)
+{
+    size_t i = 0;
+#if SUMMED_AREA_TABLE_USE_SSE2
+    constexpr size_t kLanes = 16 / sizeof(Sum);
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i sum = sizeof(Sum) == 4 ? _mm_add_epi32(a, b) : _mm_add_epi64(a, b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), sum);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] += src[i];
+    }
+}
+
+} // namespace
+
+template <typename Sum>
+void SummedAreaTable<Sum>::Build(const uint32_t* pixels, int width, int height, int thread_count)
+{
+    _width = std::max(width, 0);
+    _height = std::max(height, 0);
+    const size_t row_length = (static_cast<size_t>(_width) + 1) * 4;
+    _sums.resize(row_length * (static_cast<size_t>(_height) + 1));
+    std::fill(_sums.begin(), _sums.begin() + static_cast<std::ptrdiff_t>(row_length), Sum{0});
+    if (_width == 0 || _height == 0)
+    {
+        return;
+    }
+
+    const int threads = parallel::ResolveThreadCount(thread_count, static_cast<size_t>(_width) * _height,
+                                                     kParallelThreshold);
+
+    // 第一步：按行带求每行的前缀和（第 0 列为 0）
+    const int row_bands = std::min(threads, _height);
+    parallel::RunParallel(row_bands, [&](int band) {
+        for (int y = _height * band / row_bands; y < _height * (band + 1) / row_bands; ++y)
+        {
+            Sum* row = _sums.data() + (static_cast<size_t>(y) + 1) * row_length;
+            std::fill(row, row + 4, Sum{0});
+            PrefixRow(pixels + static_cast<size_t>(y) * _width, row + 4, _width);
+        }
+    });
+
+    // 第二步：按列带自上而下把上一行加到下一行，每个列带按整像素（4 个通道）划分
+    const int column_bands = std::min(threads, _width);
+    parallel::RunParallel(column_bands, [&](int band) {
+        const size_t begin = 4 + static_cast<size_t>(_width) * band / column_bands * 4;
+        const size_t end = 4 + static_cast<size_t>(_width) * (band + 1) / column_bands * 4;
+        for (int y = 2; y <= _height; ++y)
+        {
+            Sum* row = _sums.data() + static_cast<size_t>(y) * row_length;
+            AddRow(row + begin, row - row_length + begin, end - begin);
+        }
+    });
+}
+
+template <typename Sum>
+typename SummedAreaTable<Sum>::Sums SummedAreaTable<Sum>::RegionSum(int x0, int y0, int x1, int y1) const
+{
+    x0 = std::clamp(x0, 0, _width);
+    x1 = std::clamp(x1, 0, _width);
+    y0 = std::clamp(y0, 0, _height);
+    y1 = std::clamp(y1, 0, _height);
+    Sums sums{};
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return sums;
+    }
+    const Sum* a = At(x0, y0);
+    const Sum* b = At(x1, y0);
+    const Sum* c = At(x0, y1);
+    const Sum* d = At(x1, y1);
+    for (int i = 0; i < 4; ++i)
+    {
+        // 无符号回绕：中间结果溢出不影响差分
+        sums[i] = static_cast<Sum>(d[i] - b[i] - c[i] + a[i]);
+    }
+    return sums;
+}
+
+template <typename Sum> Color SummedAreaTable<Sum>::RegionAverage(const math::BoundingBox2i& region) const
+{
+    const int x0 = std::clamp(region.MinX(), 0, _width);
+    const int x1 = std::clamp(region.MaxX(), 0, _width);
+    const int y0 = std::clamp(region.MinY(), 0, _height);
+    const int y1 = std::clamp(region.MaxY(), 0, _height);
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return Color::Transparent();
+    }
+    const uint64_t area = static_cast<uint64_t>(x1 - x0) * static_cast<uint64_t>(y1 - y0);
+    const Sums sums = RegionSum(x0, y0, x1, y1);
+    uint32_t value = 0;
+    for (int c = 0; c < 4; ++c)
+    {
+        const uint64_t average = (static_cast<uint64_t>(sums[c]) + area / 2) / area;
+        value |= static_cast<uint32_t>(std::min<uint64_t>(average, 255)) << (c * 8);
+    }
+    return Color(value);
+}
+
+template <typename Sum>
+template <typename RadiusAt>
+void SummedAreaTable<Sum>::FilterRow(uint32_t* dst, int y, const RadiusAt& radius_at) const
+{
+#if SUMMED_AREA_TABLE_USE_SSE2
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128 two = _mm_set1_ps(2.0f);
+#endif
+    for (int x = 0; x < _width; ++x)
+    {
+        const int radius = radius_at(x);
+        const int x0 = std::max(x - radius, 0);
+        const int x1 = std::min(x + radius + 1, _width);
+        const int y0 = std::max(y - radius, 0);
+        const int y1 = std::min(y + radius + 1, _height);
+        const float inv_area = 1.0f / static_cast<float>(static_cast<int64_t>(x1 - x0) * (y1 - y0));
+        const Sum* a = At(x0, y0);
+        const Sum* b = At(x1, y0);
+        const Sum* c = At(x0, y1);
+        const Sum* d = At(x1, y1);
+#if SUMMED_AREA_TABLE_USE_SSE2
+        if constexpr (sizeof(Sum) == 4)
+        {
+            auto load = [](const Sum* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+            const __m128i sum = _mm_sub_epi32(_mm_add_epi32(load(d), load(a)), _mm_add_epi32(load(b), load(c)));
+            // 和按无符号数转换为浮点：高 31 位乘 2 再加最低位
+            const __m128 value = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(sum, 1)), two),
+                                            _mm_cvtepi32_ps(_mm_and_si128(sum, one)));
+            __m128i packed = _mm_cvtps_epi32(_mm_mul_ps(value, _mm_set1_ps(inv_area)));
+            packed = _mm_packs_epi32(packed, packed);
+            dst[x] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(packed, packed)));
+            continue;
+        }
+#endif
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            const Sum sum = static_cast<Sum>(d[i] - b[i] - c[i] + a[i]);
+            const float average = static_cast<float>(sum) * inv_area + 0.5f;
+            value |= std::min(static_cast<uint32_t>(average), 255u) << (i * 8);
+        }
+        dst[x] = value;
+    }
+}
+
+template <typename Sum> void SummedAreaTable<Sum>::BoxFilter(uint32_t* dst, int radius, int thread_count) const
+{
+    radius = std::max(radius, 0);
+    const int bands = std::min(
+        parallel::ResolveThreadCount(thread_count, static_cast<size_t>(_width) * _height, kParallelThreshold),
+        std::max(_height, 1));
+    parallel::RunParallel(bands, [&](int band) {
+        for (int y = _height * band / bands; y < _height * (band + 1) / bands; ++y)
+        {
+            FilterRow(dst + static_cast<size_t>(y) * _width, y, [radius](int) { return radius; });
+        }
+    });
+}
+
+template <typename Sum>
+void SummedAreaTable<Sum>::BoxFilter(uint32_t* dst, const uint8_t* radii, int thread_count) const
+{
+    const int bands = std::min(
+        parallel::ResolveThreadCount(thread_count, static_cast<size_t>(_width) * _height, kParallelThreshold),
+        std::max(_height, 1));
+    parallel::RunParallel(bands, [&](int band) {
+        for (int y = _height * band / bands; y < _height * (band + 1) / bands; ++y)
+        {
+            const uint8_t* row_radii = radii + static_cast<size_t>(y) * _width;
+            FilterRow(dst + static_cast<size_t>(y) * _width, y, [row_radii](int x) { return row_radii[x]; });
+        }
+    });
+}
+
+template class SummedAreaTable<uint32_t>;
+template class SummedAreaTable<uint64_t>;
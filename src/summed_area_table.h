@@ -0,0 +1,111 @@
+//
+// Created by admin on 2026/2/23.
+//
+
+#ifndef SUMMED_AREA_TABLE_H
+#define SUMMED_AREA_TABLE_H
+
+#include "color.h"
+#include "image/image.h"
+#include "math/bounding_box.h"
+#include "pixels_buffer.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 积分图（summed-area table）：每个格点保存左上方矩形内像素 4 个通道分量的和
+ * 职责：
+ *   1. 由 32 位像素（PixelsBuffer、image::Image 或裸像素数组）并行构建：先按行带求行内前缀和，
+ *      再按列带自上而下累加，两步都在 SSE2 的整数通道中进行
+ *   2. 任意矩形的分量和只需 4 次查表，提供区域平均色和与半径无关的 O(1) 盒式滤波（支持逐像素半径）
+ *
+ * 通道 c 对应像素的第 8c 到 8c + 7 位，即打包像素 0xRRGGBBAA 中依次为 A、B、G、R。
+ * Sum 为 uint32_t 时按 2^32 取模累加：只要查询的矩形不超过 2^32 / 255（约 1680 万）个像素，
+ * 差分得到的区域和仍然精确，因此整张大图也可以用 32 位表，内存和带宽是 64 位表的一半；
+ * 需要更大区域时使用 uint64_t。
+ */
+template <typename Sum> class SummedAreaTable
+{
+  public:
+    using Sums = std::array<Sum, 4>;
+
+    SummedAreaTable() = default;
+
+    /**
+     * @brief 由 width x height 的像素构建（容量只增不减，同尺寸重复构建不分配内存）
+     * @param thread_count 线程数，0 表示使用硬件并发数，1 表示只用调用线程
+     */
+    void Build(const uint32_t* pixels, int width, int height, int thread_count = 0);
+
+    void Build(const PixelsBuffer& buffer, int thread_count = 0)
+    {
+        Build(buffer.Pixels(), buffer.Width(), buffer.Height(), thread_count);
+    }
+
+    void Build(const image::Image& image, int thread_count = 0)
+    {
+        Build(image.Pixels().data(), image.Width(), image.Height(), thread_count);
+    }
+
+    [[nodiscard]] int Width() const
+    {
+        return _width;
+    }
+
+    [[nodiscard]] int Height() const
+    {
+        return _height;
+    }
+
+    /**
+     * @brief 矩形 [x0, x1) x [y0, y1) 内各通道的和（矩形自动裁剪到图像）
+     */
+    [[nodiscard]] Sums RegionSum(int x0, int y0, int x1, int y1) const;
+
+    /**
+     * @brief 区域内像素的平均色（四舍五入），区域与图像不相交时返回透明
+     */
+    [[nodiscard]] Color RegionAverage(const math::BoundingBox2i& region) const;
+
+    /**
+     * @brief 盒式滤波：dst 的每个像素为以它为中心、边长 2 * radius + 1 的窗口的平均（窗口裁剪到图像内）
+     * @param dst 与表同尺寸的 width x height 像素，不能与构建时的像素相同
+     */
+    void BoxFilter(uint32_t* dst, int radius, int thread_count = 0) const;
+
+    void BoxFilter(PixelsBuffer& dst, int radius, int thread_count = 0) const
+    {
+        BoxFilter(dst.Pixels(), radius, thread_count);
+    }
+
+    /**
+     * @brief 逐像素半径的盒式滤波（景深等效果）：radii 为 width x height 个半径，开销与半径大小无关
+     */
+    void BoxFilter(uint32_t* dst, const uint8_t* radii, int thread_count = 0) const;
+
+    void BoxFilter(PixelsBuffer& dst, const uint8_t* radii, int thread_count = 0) const
+    {
+        BoxFilter(dst.Pixels(), radii, thread_count);
+    }
+
+  private:
+    // 格点 (x, y) 的第一个通道，x ∈ [0, width]，y ∈ [0, height]，第 0 行和第 0 列恒为 0
+    [[nodiscard]] const Sum* At(int x, int y) const
+    {
+        return _sums.data() + (static_cast<size_t>(y) * (_width + 1) + x) * 4;
+    }
+
+    // 把第 y 行的滤波结果写入 dst，像素 x 的窗口半径为 radius_at(x)
+    template <typename RadiusAt> void FilterRow(uint32_t* dst, int y, const RadiusAt& radius_at) const;
+
+    int _width = 0;
+    int _height = 0;
+    std::vector<Sum> _sums; // (width + 1) x (height + 1) 个格点，每个格点 4 个通道
+};
+
+using SummedAreaTable32 = SummedAreaTable<uint32_t>;
+using SummedAreaTable64 = SummedAreaTable<uint64_t>;
+
+#endif // SUMMED_AREA_TABLE_H
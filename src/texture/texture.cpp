@@ -5,17 +5,28 @@
 #include "texture.h"
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 namespace texture
 {
 
-Texture::Texture(std::shared_ptr<image::Image> image) : _image(image) {}
+Texture::Texture(std::shared_ptr<image::Image> image) : _image(image)
+{
+    // 纹理在创建时一次性转换为预乘 alpha，采样结果可直接参与混合
+    if (_image)
+    {
+        _image->Premultiply();
+    }
+}
 
 Texture::Texture(const std::string& file_path, int desired_channels)
     : _image(std::make_shared<image::Image>(file_path, desired_channels))
 {
+    _image->Premultiply();
 }
 
+Texture::Texture(std::shared_ptr<RenderTarget> target) : _target(std::move(target)) {}
+
 float Texture::ApplyWrap(float coord) const
 {
     switch (_wrap_mode)
@@ -40,7 +51,7 @@ float Texture::ApplyWrap(float coord) const
 
 Color Texture::Sample(float u, float v) const
 {
-    if (!_image || !_image->IsValid())
+    if (!IsValid())
     {
         return Color::Transparent();
     }
@@ -54,22 +65,22 @@ Color Texture::Sample(float u, float v) const
     }
 
     // 最近邻采样
-    int x = static_cast<int>(u * (_image->Width() - 1) + 0.5f);
-    int y = static_cast<int>(v * (_image->Height() - 1) + 0.5f);
+    int x = static_cast<int>(u * (Width() - 1) + 0.5f);
+    int y = static_cast<int>(v * (Height() - 1) + 0.5f);
 
-    return _image->GetPixel(x, y);
+    return Texel(x, y);
 }
 
 Color Texture::SampleBilinear(float u, float v) const
 {
-    if (!_image || !_image->IsValid())
+    if (!IsValid())
     {
         return Color::Transparent();
     }
 
     // 转换为像素坐标（浮点数）
-    float px = u * (_image->Width() - 1);
-    float py = v * (_image->Height() - 1);
+    float px = u * (Width() - 1);
+    float py = v * (Height() - 1);
 
     // 获取四个相邻像素的坐标
     int x0 = static_cast<int>(std::floor(px));
@@ -78,18 +89,18 @@ Color Texture::SampleBilinear(float u, float v) const
     // x0与x1, y0与y1相同，导致插值权重为0(这种的解决方案是需要特殊处理).
     // 直接使用min(x0 + 1, _image->Width() - 1) 和min(y0 + 1, _image->Height() -
     // 1)，可以确保x1, y1不会与x0, y0相同。
-    int x1 = std::min(x0 + 1, _image->Width() - 1);
-    int y1 = std::min(y0 + 1, _image->Height() - 1);
+    int x1 = std::min(x0 + 1, Width() - 1);
+    int y1 = std::min(y0 + 1, Height() - 1);
 
     // 计算插值权重
     float fx = px - x0;
     float fy = py - y0;
 
     // 获取四个像素的颜色
-    Color c00 = _image->GetPixel(x0, y0);
-    Color c10 = _image->GetPixel(x1, y0);
-    Color c01 = _image->GetPixel(x0, y1);
-    Color c11 = _image->GetPixel(x1, y1);
+    Color c00 = Texel(x0, y0);
+    Color c10 = Texel(x1, y0);
+    Color c01 = Texel(x0, y1);
+    Color c11 = Texel(x1, y1);
 
     // 水平方向插值
     Color c0 = Color::Lerp(c00, c10, fx);
@@ -7,6 +7,7 @@
 
 #include "color.h"
 #include "image/image.h"
+#include "render_target.h"
 #include <memory>
 
 namespace texture
@@ -34,7 +35,7 @@ enum class WrapMode
 /**
  * @brief 纹理类 - 用于渲染的纹理对象
  * 职责：
- *   1. 持有图像数据（Image）
+ *   1. 持有图像数据（Image），或引用离屏渲染目标（RenderTarget，不复制像素）
  *   2. 提供纹理采样功能（UV坐标 -> 颜色）
  *   3. 管理采样模式和环绕模式
  *
@@ -48,7 +49,7 @@ class Texture
   public:
     /**
      * @brief 从 Image 创建纹理
-     * @param image 图像对象（共享指针，允许多个 Texture 共享）
+     * @param image 图像对象（共享指针，允许多个 Texture 共享），会被原地转换为预乘 alpha
      */
     explicit Texture(std::shared_ptr<image::Image> image);
 
@@ -59,11 +60,18 @@ class Texture
      */
     explicit Texture(const std::string& file_path, int desired_channels = 4);
 
+    /**
+     * @brief 以离屏渲染目标为像素来源创建纹理（渲染到纹理）
+     * @param target 渲染目标（共享指针），采样时直接读取它当前的像素（已是预乘 alpha），
+     * 纹理存在期间该目标不会被渲染目标池复用
+     */
+    explicit Texture(std::shared_ptr<RenderTarget> target);
+
     /**
      * @brief 根据 UV 坐标采样颜色
      * @param u U 坐标 (0.0 ~ 1.0)
      * @param v V 坐标 (0.0 ~ 1.0)
-     * @return 采样得到的颜色
+     * @return 采样得到的颜色（预乘 alpha）
      */
     [[nodiscard]] Color Sample(float u, float v) const;
 
@@ -109,12 +117,20 @@ class Texture
         return _image;
     }
 
+    /**
+     * @brief 获取引用的渲染目标（以图像创建的纹理返回空）
+     */
+    [[nodiscard]] std::shared_ptr<RenderTarget> GetRenderTarget() const
+    {
+        return _target;
+    }
+
     /**
      * @brief 获取纹理宽度
      */
     [[nodiscard]] int Width() const
     {
-        return _image ? _image->Width() : 0;
+        return _image ? _image->Width() : (_target ? _target->Width() : 0);
     }
 
     /**
@@ -122,7 +138,21 @@ class Texture
      */
     [[nodiscard]] int Height() const
     {
-        return _image ? _image->Height() : 0;
+        return _image ? _image->Height() : (_target ? _target->Height() : 0);
+    }
+
+    /**
+     * @brief 预乘 alpha 的像素首地址（行距为 Width() 个像素），纹理无效时返回空
+     *
+     * 供按行 blit 的图元直接读取整行纹素，不经过 Sample 的逐像素坐标换算。
+     */
+    [[nodiscard]] const uint32_t* Pixels() const
+    {
+        if (_image)
+        {
+            return _image->IsValid() ? _image->Pixels().data() : nullptr;
+        }
+        return _target ? _target->Buffer().Pixels() : nullptr;
     }
 
     /**
@@ -130,7 +160,7 @@ class Texture
      */
     [[nodiscard]] bool IsValid() const
     {
-        return _image && _image->IsValid();
+        return (_image && _image->IsValid()) || _target;
     }
 
     /**
@@ -154,7 +184,8 @@ class Texture
     }
 
   private:
-    std::shared_ptr<image::Image> _image; // 持有图像数据（可共享）
+    std::shared_ptr<image::Image> _image;  // 持有图像数据（可共享）
+    std::shared_ptr<RenderTarget> _target; // 或引用渲染目标（与 _image 二选一）
     SampleMode _sample_mode = SampleMode::Nearest;
     WrapMode _wrap_mode = WrapMode::Clamp;
 
@@ -168,6 +199,19 @@ class Texture
      */
     [[nodiscard]] float ApplyWrap(float coord) const;
 
+    /**
+     * @brief 读取纹素（坐标已在范围内）
+     */
+    [[nodiscard]] Color Texel(int x, int y) const
+    {
+        if (_image)
+        {
+            return _image->GetPixel(x, y);
+        }
+        const PixelsBuffer& buffer = _target->Buffer();
+        return Color(buffer.Pixels()[static_cast<size_t>(y) * buffer.Width() + x]);
+    }
+
     /**
      * @brief 双线性插值采样
      */